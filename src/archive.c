@@ -0,0 +1,713 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file archive.c
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "archive.h"
+#include "compat_checksum.h"
+#include "json.h"
+#include "json_query.h"
+#include "log.h"
+#include "query.h"
+#include "read.h"
+#include "utilities.h"
+#include "workers.h"
+
+typedef struct export_entry {
+    /** The data object path */
+    char *path;
+    /** The catalog checksum, borrowed from the listing */
+    const char *checksum;
+    /** The catalog size */
+    size_t size;
+    /** The catalog modification time */
+    time_t mtime;
+} export_entry_t;
+
+static void tar_octal(char *field, size_t len, unsigned long long value) {
+    // Zero-padded and NUL-terminated, as written by GNU tar
+    snprintf(field, len, "%0*llo", (int) len - 1, value);
+}
+
+static void make_ustar_header(char block[TAR_BLOCK_SIZE], const char *name,
+                              size_t size, time_t mtime, char typeflag) {
+    memset(block, 0, TAR_BLOCK_SIZE);
+
+    // The offsets of the ustar header fields
+    strncpy(block, name, 100);                         // name
+    tar_octal(block + 100, 8, 0644);                   // mode
+    tar_octal(block + 108, 8, 0);                      // uid
+    tar_octal(block + 116, 8, 0);                      // gid
+    tar_octal(block + 124, 12, size > TAR_MAX_USTAR_SIZE ? 0 : size);
+    tar_octal(block + 136, 12, mtime < 0 ? 0 : mtime); // mtime
+    block[156] = typeflag;
+    memcpy(block + 257, "ustar", 6);                   // magic
+    memcpy(block + 263, "00", 2);                      // version
+
+    // The header checksum is calculated with its own field as spaces
+    memset(block + 148, ' ', 8);
+    unsigned int sum = 0;
+    for (size_t i = 0; i < TAR_BLOCK_SIZE; i++) {
+        sum += (unsigned char) block[i];
+    }
+    snprintf(block + 148, 8, "%06o", sum);
+    block[155] = ' ';
+}
+
+static void add_pax_record(FILE *records, const char *key,
+                           const char *value) {
+    // Each record is "<length> <key>=<value>\n", where the length
+    // includes its own digits
+    size_t len   = strlen(key) + strlen(value) + 3;
+    size_t total = len + 1;
+    for (;;) {
+        size_t n = len + (size_t) snprintf(NULL, 0, "%zu", total);
+        if (n == total) break;
+        total = n;
+    }
+
+    fprintf(records, "%zu %s=%s\n", total, key, value);
+}
+
+static int write_blocks(FILE *out, const char *buffer, size_t len,
+                        baton_error_t *error) {
+    if (fwrite(buffer, 1, len, out) != len) {
+        set_baton_error(error, errno, "Failed to write to archive: "
+                        "error %d %s", errno, strerror(errno));
+    }
+
+    return error->code;
+}
+
+int write_tar_header(FILE *out, const char *name, size_t size, time_t mtime,
+                     const char *checksum, baton_error_t *error) {
+    char block[TAR_BLOCK_SIZE];
+    char *records  = NULL;
+    size_t rlen    = 0;
+    FILE *rstream  = NULL;
+
+    init_baton_error(error);
+
+    rstream = open_memstream(&records, &rlen);
+    if (!rstream) {
+        set_baton_error(error, errno, "Failed to open a memory stream: "
+                        "error %d %s", errno, strerror(errno));
+        goto finally;
+    }
+
+    if (strlen(name) > 100) {
+        add_pax_record(rstream, "path", name);
+    }
+    if (size > TAR_MAX_USTAR_SIZE) {
+        char size_str[32];
+        snprintf(size_str, sizeof size_str, "%zu", size);
+        add_pax_record(rstream, "size", size_str);
+    }
+    if (checksum && strnlen(checksum, MAX_STR_LEN) > 0) {
+        add_pax_record(rstream, TAR_PAX_CHECKSUM_KEY, checksum);
+    }
+
+    if (fclose(rstream) != 0) {
+        rstream = NULL;
+        set_baton_error(error, errno, "Failed to close a memory stream: "
+                        "error %d %s", errno, strerror(errno));
+        goto finally;
+    }
+    rstream = NULL;
+
+    if (rlen > 0) {
+        char pax_name[101];
+        snprintf(pax_name, sizeof pax_name, "PaxHeaders/%s", name);
+
+        make_ustar_header(block, pax_name, rlen, mtime, 'x');
+        write_blocks(out, block, TAR_BLOCK_SIZE, error);
+        if (error->code != 0) goto finally;
+
+        write_blocks(out, records, rlen, error);
+        if (error->code != 0) goto finally;
+
+        write_tar_padding(out, rlen, error);
+        if (error->code != 0) goto finally;
+    }
+
+    make_ustar_header(block, name, size, mtime, '0');
+    write_blocks(out, block, TAR_BLOCK_SIZE, error);
+
+finally:
+    if (rstream) fclose(rstream);
+    if (records) free(records);
+
+    return error->code;
+}
+
+int write_tar_padding(FILE *out, size_t size, baton_error_t *error) {
+    char block[TAR_BLOCK_SIZE];
+
+    init_baton_error(error);
+
+    size_t remainder = size % TAR_BLOCK_SIZE;
+    if (remainder > 0) {
+        memset(block, 0, TAR_BLOCK_SIZE);
+        write_blocks(out, block, TAR_BLOCK_SIZE - remainder, error);
+    }
+
+    return error->code;
+}
+
+int write_tar_end(FILE *out, baton_error_t *error) {
+    char block[TAR_BLOCK_SIZE];
+
+    init_baton_error(error);
+
+    // Two zero blocks
+    memset(block, 0, TAR_BLOCK_SIZE);
+    write_blocks(out, block, TAR_BLOCK_SIZE, error);
+    if (error->code != 0) goto finally;
+
+    write_blocks(out, block, TAR_BLOCK_SIZE, error);
+
+finally:
+    return error->code;
+}
+
+/**
+ *  @struct export_slot
+ *  @brief A data object opened, and its leading bytes read, ahead of
+ *  being written to the archive.
+ */
+typedef struct export_slot {
+    /** The connection on which the data object is opened and read */
+    rcComm_t *conn;
+    /** The open data object, or NULL if it could not be opened */
+    data_obj_file_t *data_obj;
+    /** The leading bytes of the data object, read ahead */
+    char *head;
+    size_t head_len;
+    /** The error opening or reading the data object, if any */
+    baton_error_t error;
+    /** True while the slot holds a data object ready to be written */
+    int ready;
+} export_slot_t;
+
+/**
+ *  @struct export_pipeline
+ *  @brief Slots filled in turn by prefetching threads, each with its
+ *  own connection, and emptied in order as the archive is written.
+ */
+typedef struct export_pipeline {
+    export_entry_t *entries;
+    size_t num_entries;
+    export_slot_t *slots;
+    size_t num_slots;
+    /** The number of leading bytes read ahead */
+    size_t head_size;
+    /** Guards the slots */
+    pthread_mutex_t lock;
+    /** Signalled when a slot is filled or emptied */
+    pthread_cond_t changed;
+    /** True once the archive is abandoned */
+    int cancelled;
+} export_pipeline_t;
+
+typedef struct export_lane {
+    export_pipeline_t *pipeline;
+    size_t index;
+} export_lane_t;
+
+static int compare_entries(const void *a, const void *b) {
+    return strcmp(((const export_entry_t *) a)->path,
+                  ((const export_entry_t *) b)->path);
+}
+
+static void prefetch_data_obj(export_entry_t *entry, export_slot_t *slot,
+                              size_t head_size) {
+    init_baton_error(&slot->error);
+    slot->head_len = 0;
+
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof rods_path);
+    snprintf(rods_path.outPath, MAX_NAME_LEN, "%s", entry->path);
+
+    slot->data_obj = open_data_obj(slot->conn, &rods_path, O_RDONLY, 0,
+                                   &slot->error);
+    if (slot->error.code != 0) return;
+
+    size_t len = entry->size < head_size ? entry->size : head_size;
+    while (slot->head_len < len) {
+        size_t nr = read_chunk(slot->conn, slot->data_obj,
+                               slot->head + slot->head_len,
+                               len - slot->head_len, &slot->error);
+        if (slot->error.code != 0 || nr == 0) break;
+        slot->head_len += nr;
+    }
+}
+
+// Each lane fills its slot with every num_slots'th data object, in
+// order, waiting for the slot to be emptied before filling it again
+static void *run_export_lane(void *arg) {
+    export_lane_t *lane         = arg;
+    export_pipeline_t *pipeline = lane->pipeline;
+    export_slot_t *slot         = &pipeline->slots[lane->index];
+
+    for (size_t i = lane->index; i < pipeline->num_entries;
+         i += pipeline->num_slots) {
+        pthread_mutex_lock(&pipeline->lock);
+        while (slot->ready && !pipeline->cancelled) {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+        int cancelled = pipeline->cancelled;
+        pthread_mutex_unlock(&pipeline->lock);
+
+        if (cancelled) break;
+
+        prefetch_data_obj(&pipeline->entries[i], slot, pipeline->head_size);
+
+        pthread_mutex_lock(&pipeline->lock);
+        slot->ready = 1;
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+
+    return NULL;
+}
+
+static void await_slot(export_pipeline_t *pipeline, export_slot_t *slot) {
+    pthread_mutex_lock(&pipeline->lock);
+    while (!slot->ready) {
+        pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+static void close_slot(export_slot_t *slot) {
+    if (slot->data_obj) {
+        close_data_obj(slot->conn, slot->data_obj);
+        free_data_obj(slot->data_obj);
+        slot->data_obj = NULL;
+    }
+}
+
+static void release_slot(export_pipeline_t *pipeline, export_slot_t *slot) {
+    close_slot(slot);
+
+    pthread_mutex_lock(&pipeline->lock);
+    slot->ready = 0;
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+static size_t copy_data_obj(export_slot_t *slot, FILE *out, size_t size,
+                            char *buffer, size_t buffer_size, char md5[33],
+                            baton_error_t *error) {
+    size_t num_written = 0;
+    unsigned char digest[16];
+
+    init_baton_error(error);
+
+    EVP_MD_CTX *context = compat_MD5Init(error);
+    if (error->code != 0) goto finally;
+
+    // The leading bytes were read ahead
+    if (slot->head_len > 0) {
+        write_blocks(out, slot->head, slot->head_len, error);
+        if (error->code != 0) goto finally;
+        num_written = slot->head_len;
+
+        compat_MD5Update(context, (unsigned char *) slot->head,
+                         slot->head_len, error);
+        if (error->code != 0) {
+            context = NULL; // Freed on error
+            goto finally;
+        }
+    }
+
+    if (slot->error.code != 0) {
+        set_baton_error(error, slot->error.code, "%s", slot->error.message);
+        goto finally;
+    }
+
+    while (num_written < size) {
+        size_t remaining = size - num_written;
+        size_t len = remaining < buffer_size ? remaining : buffer_size;
+
+        size_t nr = read_chunk(slot->conn, slot->data_obj, buffer, len,
+                               error);
+        if (error->code != 0 || nr == 0) break;
+
+        write_blocks(out, buffer, nr, error);
+        if (error->code != 0) break;
+        num_written += nr;
+
+        compat_MD5Update(context, (unsigned char *) buffer, nr, error);
+        if (error->code != 0) {
+            context = NULL; // Freed on error
+            goto finally;
+        }
+    }
+
+    if (error->code != 0) goto finally;
+
+    compat_MD5Final(digest, context, error);
+    if (error->code != 0) {
+        context = NULL; // Freed on error
+        goto finally;
+    }
+
+    for (int i = 0; i < 16; i++) {
+        snprintf(md5 + i * 2, 3, "%02x", digest[i]);
+    }
+
+finally:
+    if (context) MD5_FREE(context);
+
+    return num_written;
+}
+
+static int export_data_obj(export_slot_t *slot, export_entry_t *entry,
+                           const char *name, FILE *out, char *buffer,
+                           size_t buffer_size, baton_error_t *error) {
+    char md5[33] = { 0 };
+
+    init_baton_error(error);
+
+    // A data object which cannot be opened is left out of the archive
+    if (!slot->data_obj) {
+        set_baton_error(error, slot->error.code, "%s", slot->error.message);
+        goto finally;
+    }
+
+    write_tar_header(out, name, entry->size, entry->mtime, entry->checksum,
+                     error);
+    if (error->code != 0) goto finally;
+
+    baton_error_t copy_error;
+    size_t nw = copy_data_obj(slot, out, entry->size, buffer, buffer_size,
+                              md5, &copy_error);
+
+    // Once its header is written, a member must be completed to keep
+    // the archive readable
+    if (nw < entry->size) {
+        memset(buffer, 0, buffer_size);
+        size_t remaining = entry->size - nw;
+        while (remaining > 0 && error->code == 0) {
+            size_t len = remaining < buffer_size ? remaining : buffer_size;
+            write_blocks(out, buffer, len, error);
+            remaining -= len;
+        }
+        if (error->code != 0) goto finally;
+
+        if (copy_error.code == 0) {
+            set_baton_error(error, -1, "Read %zu of %zu bytes from '%s'; "
+                            "its archive member was padded", nw, entry->size,
+                            entry->path);
+        }
+    }
+
+    baton_error_t pad_error;
+    write_tar_padding(out, entry->size, &pad_error);
+    if (pad_error.code != 0) {
+        set_baton_error(error, pad_error.code, "%s", pad_error.message);
+        goto finally;
+    }
+
+    if (copy_error.code != 0) {
+        set_baton_error(error, copy_error.code, "%s", copy_error.message);
+        goto finally;
+    }
+    if (error->code != 0) goto finally;
+
+    // SHA256 checksums are not verified here; they would require a
+    // second digest on every read
+    const char *checksum = entry->checksum;
+    if (checksum && strnlen(checksum, MAX_STR_LEN) > 0 &&
+        !str_starts_with(checksum, "sha2:", 5) &&
+        !str_equals_ignore_case(checksum, md5, 33)) {
+        set_baton_error(error, -1, "Checksum mismatch for '%s' having "
+                        "MD5 %s on reading, expected %s", entry->path, md5,
+                        checksum);
+    }
+
+finally:
+    return error->code;
+}
+
+json_t *export_collection(rcComm_t *conn, rodsPath_t *rods_path, FILE *out,
+                          option_flags flags, size_t buffer_size,
+                          size_t num_workers, baton_error_t *error) {
+    json_t *listing          = NULL;
+    json_t *result           = NULL;
+    export_entry_t *entries  = NULL;
+    char *buffer             = NULL;
+    size_t num_entries       = 0;
+    size_t num_exported      = 0;
+    size_t num_failed        = 0;
+    size_t num_bytes         = 0;
+
+    export_pipeline_t pipeline;
+    memset(&pipeline, 0, sizeof pipeline);
+    worker_conns_t workers;
+    memset(&workers, 0, sizeof workers);
+    export_lane_t *lanes = NULL;
+    pthread_t *threads   = NULL;
+    size_t num_started   = 0;
+    int synchronised     = 0;
+
+    init_baton_error(error);
+
+    if (rods_path->objType != COLL_OBJ_T) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot export '%s' because it is not a collection",
+                        rods_path->outPath);
+        goto finally;
+    }
+
+    if (buffer_size == 0) {
+        set_baton_error(error, -1, "Invalid buffer_size argument %zu",
+                        buffer_size);
+        goto finally;
+    }
+
+    const char *coll_path = rods_path->outPath;
+    listing = list_collection_data_objs(conn, coll_path, flags & RECURSIVE,
+                                        error);
+    if (error->code != 0) goto finally;
+
+    size_t num_rows = json_array_size(listing);
+    entries = calloc(num_rows > 0 ? num_rows : 1, sizeof (export_entry_t));
+    buffer  = calloc(buffer_size, sizeof (char));
+    if (!entries || !buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    // Member names are relative to the parent collection
+    size_t prefix_len = strlen(coll_path);
+    while (prefix_len > 0 && coll_path[prefix_len - 1] == '/') prefix_len--;
+    while (prefix_len > 0 && coll_path[prefix_len - 1] != '/') prefix_len--;
+
+    for (size_t i = 0; i < num_rows; i++) {
+        json_t *row = json_array_get(listing, i);
+
+        export_entry_t *entry = &entries[num_entries];
+        entry->path = json_to_path(row, error);
+        if (error->code != 0) goto finally;
+        num_entries++;
+
+        const char *size = json_string_value(json_object_get(row,
+                                                             JSON_SIZE_KEY));
+        const char *mtime =
+            json_string_value(json_object_get(row, JSON_MODIFIED_KEY));
+
+        entry->checksum =
+            json_string_value(json_object_get(row, JSON_CHECKSUM_KEY));
+        entry->size  = size  ? strtoull(size, NULL, 10) : 0;
+        entry->mtime = mtime ? strtoll(mtime, NULL, 10) : 0;
+    }
+
+    // Sorted to give a stable archive; good replicas of the same data
+    // object become adjacent and are exported once
+    qsort(entries, num_entries, sizeof (export_entry_t), compare_entries);
+
+    size_t num_unique = 0;
+    for (size_t i = 0; i < num_entries; i++) {
+        if (num_unique > 0 && str_equals(entries[i].path,
+                                         entries[num_unique - 1].path,
+                                         MAX_STR_LEN)) {
+            free(entries[i].path);
+            continue;
+        }
+        entries[num_unique++] = entries[i];
+    }
+    num_entries = num_unique;
+
+    pipeline.entries     = entries;
+    pipeline.num_entries = num_entries;
+    pipeline.head_size   = buffer_size;
+
+    // With more than one worker, the data objects are opened and their
+    // leading bytes read ahead on the workers' own connections, while
+    // the archive is written in order
+    if (num_workers > num_entries) num_workers = num_entries;
+    if (num_workers > 1) {
+        baton_error_t conn_error;
+        open_worker_conns(&workers, num_workers, &conn_error);
+        if (conn_error.code != 0) {
+            logmsg(WARN, "Failed to connect workers to read ahead: %s; "
+                   "exporting on one connection", conn_error.message);
+        }
+    }
+    pipeline.num_slots = workers.num_conns > 0 ? workers.num_conns : 1;
+
+    int status = pthread_mutex_init(&pipeline.lock, NULL);
+    if (status == 0) {
+        status = pthread_cond_init(&pipeline.changed, NULL);
+        if (status != 0) pthread_mutex_destroy(&pipeline.lock);
+    }
+    if (status != 0) {
+        set_baton_error(error, status, "Failed to initialise a lock: "
+                        "error %d %s", status, strerror(status));
+        goto finally;
+    }
+    synchronised = 1;
+
+    pipeline.slots = calloc(pipeline.num_slots, sizeof (export_slot_t));
+    if (!pipeline.slots) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    for (size_t i = 0; i < pipeline.num_slots; i++) {
+        export_slot_t *slot = &pipeline.slots[i];
+        slot->conn = workers.num_conns > 0 ? workers.conns[i] : conn;
+        slot->head = calloc(pipeline.head_size, sizeof (char));
+        if (!slot->head) {
+            set_baton_error(error, errno, "Failed to allocate memory: "
+                            "error %d %s", errno, strerror(errno));
+            goto finally;
+        }
+    }
+
+    if (workers.num_conns > 0) {
+        lanes   = calloc(pipeline.num_slots, sizeof (export_lane_t));
+        threads = calloc(pipeline.num_slots, sizeof (pthread_t));
+        if (!lanes || !threads) {
+            set_baton_error(error, errno, "Failed to allocate memory: "
+                            "error %d %s", errno, strerror(errno));
+            goto finally;
+        }
+
+        for (size_t i = 0; i < pipeline.num_slots; i++) {
+            lanes[i].pipeline = &pipeline;
+            lanes[i].index    = i;
+
+            status = pthread_create(&threads[i], NULL, run_export_lane,
+                                    &lanes[i]);
+            if (status != 0) {
+                set_baton_error(error, status, "Failed to start a worker "
+                                "reading ahead: error %d %s", status,
+                                strerror(status));
+                goto finally;
+            }
+            num_started++;
+        }
+
+        logmsg(DEBUG, "Reading ahead %zu data objects from '%s' using %zu "
+               "workers", num_entries, coll_path, num_started);
+    }
+
+    for (size_t i = 0; i < num_entries; i++) {
+        export_entry_t *entry = &entries[i];
+        export_slot_t *slot   = &pipeline.slots[i % pipeline.num_slots];
+
+        if (num_started > 0) {
+            await_slot(&pipeline, slot);
+        }
+        else {
+            prefetch_data_obj(entry, slot, pipeline.head_size);
+        }
+
+        baton_error_t export_error;
+        export_data_obj(slot, entry, entry->path + prefix_len, out, buffer,
+                        buffer_size, &export_error);
+        release_slot(&pipeline, slot);
+
+        if (export_error.code != 0) {
+            logmsg(ERROR, "Failed to export '%s': %s", entry->path,
+                   export_error.message);
+            num_failed++;
+
+            // The archive can't continue after a failed write
+            if (ferror(out)) {
+                set_baton_error(error, export_error.code, "%s",
+                                export_error.message);
+                goto finally;
+            }
+            continue;
+        }
+
+        num_exported++;
+        num_bytes += entry->size;
+        logmsg(DEBUG, "Exported '%s' (%zu bytes)", entry->path, entry->size);
+    }
+
+    write_tar_end(out, error);
+    if (error->code != 0) goto finally;
+
+    if (num_failed > 0) {
+        set_baton_error(error, -1, "Failed to export %zu of %zu data objects "
+                        "in '%s'", num_failed, num_failed + num_exported,
+                        coll_path);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Exported %zu data objects (%zu bytes) from '%s'",
+           num_exported, num_bytes, coll_path);
+
+    result = json_pack("{s:I, s:I}",
+                       JSON_COUNT_KEY, (json_int_t) num_exported,
+                       JSON_SIZE_KEY,  (json_int_t) num_bytes);
+    if (!result) {
+        set_baton_error(error, -1, "Failed to pack the export summary "
+                        "of '%s'", coll_path);
+    }
+
+finally:
+    // Any workers still reading ahead are stopped before their
+    // connections are closed
+    if (num_started > 0) {
+        pthread_mutex_lock(&pipeline.lock);
+        pipeline.cancelled = 1;
+        pthread_cond_broadcast(&pipeline.changed);
+        pthread_mutex_unlock(&pipeline.lock);
+
+        for (size_t i = 0; i < num_started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    if (pipeline.slots) {
+        for (size_t i = 0; i < pipeline.num_slots; i++) {
+            close_slot(&pipeline.slots[i]);
+            if (pipeline.slots[i].head) free(pipeline.slots[i].head);
+        }
+        free(pipeline.slots);
+    }
+    if (synchronised) {
+        pthread_cond_destroy(&pipeline.changed);
+        pthread_mutex_destroy(&pipeline.lock);
+    }
+    close_worker_conns(&workers);
+    if (lanes)   free(lanes);
+    if (threads) free(threads);
+    if (entries) {
+        for (size_t i = 0; i < num_entries; i++) free(entries[i].path);
+        free(entries);
+    }
+    if (buffer)  free(buffer);
+    if (listing) json_decref(listing);
+
+    return result;
+}
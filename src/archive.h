@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file archive.h
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#ifndef _BATON_ARCHIVE_H
+#define _BATON_ARCHIVE_H
+
+#include <stdio.h>
+#include <time.h>
+
+#include <jansson.h>
+#include <rodsClient.h>
+
+#include "config.h"
+#include "error.h"
+#include "operations.h"
+
+#define TAR_BLOCK_SIZE 512
+
+// The largest size which fits the ustar size field; larger sizes are
+// given in a PAX header
+#define TAR_MAX_USTAR_SIZE 077777777777ULL
+
+// The PAX header keyword for data object checksums. Archivers which
+// support extended attributes restore it as a user attribute; others
+// ignore it.
+#define TAR_PAX_CHECKSUM_KEY "SCHILY.xattr.user.irods.checksum"
+
+/**
+ * Write the header of a tar archive member for a regular file, in
+ * POSIX.1-2001 (pax) format. A pax extended header is written first
+ * if the name is longer than the ustar name field, the size is too
+ * large for the ustar size field, or there is a checksum.
+ *
+ * @param[in]  out       A file to write to.
+ * @param[in]  name      The member name.
+ * @param[in]  size      The member size in bytes.
+ * @param[in]  mtime     The member modification time.
+ * @param[in]  checksum  A checksum to record in the pax extended header.
+ *                       Optional, may be NULL.
+ * @param[out] error     An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int write_tar_header(FILE *out, const char *name, size_t size, time_t mtime,
+                     const char *checksum, baton_error_t *error);
+
+/**
+ * Pad a tar archive member of the given size to a whole number of
+ * blocks.
+ *
+ * @param[in]  out    A file to write to.
+ * @param[in]  size   The member size in bytes.
+ * @param[out] error  An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int write_tar_padding(FILE *out, size_t size, baton_error_t *error);
+
+/**
+ * Write the end-of-archive marker of a tar archive.
+ *
+ * @param[in]  out    A file to write to.
+ * @param[out] error  An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int write_tar_end(FILE *out, baton_error_t *error);
+
+/**
+ * Write the data objects in a collection to a stream as a tar
+ * archive. Member names are relative to the parent of the collection,
+ * so that the archive extracts to a directory named after it. The
+ * data objects, their sizes and checksums are found with a single
+ * catalog query, rather than one per data object, and each is
+ * verified against its catalog MD5 checksum (if any) as it is read.
+ *
+ * With more than one worker, each worker opens data objects on a
+ * connection of its own and reads up to buffer_size of their leading
+ * bytes ahead, while the archive is written, so that the round trips
+ * of opening and starting to read the next data objects overlap with
+ * writing the current one. The members are written in the same sorted
+ * order however many workers there are.
+ *
+ * If a data object cannot be read completely, its member is padded
+ * with NUL bytes so that the archive remains readable, the remaining
+ * data objects are exported and an error is reported at the end.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  rods_path    An iRODS collection path.
+ * @param[in]  out          A file to write to.
+ * @param[in]  flags        RECURSIVE to include the contents of
+ *                          sub-collections.
+ * @param[in]  buffer_size  The number of bytes to copy at one time.
+ * @param[in]  num_workers  The number of workers reading ahead. With
+ *                          fewer than two, the data objects are read
+ *                          on the caller's connection alone.
+ * @param[out] error        An error report struct.
+ *
+ * @return A new JSON object with the number of data objects and the
+ * total number of bytes exported, which must be freed by the caller.
+ */
+json_t *export_collection(rcComm_t *conn, rodsPath_t *rods_path, FILE *out,
+                          option_flags flags, size_t buffer_size,
+                          size_t num_workers, baton_error_t *error);
+
+#endif // _BATON_ARCHIVE_H
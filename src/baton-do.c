@@ -33,6 +33,7 @@ static int no_error_flag       = 0;
 static int server_version_flag = 0;
 static int silent_flag         = 0;
 static int single_server_flag  = 0;
+static int trust_input_flag    = 0;
 static int unbuffered_flag     = 0;
 static int unsafe_flag         = 0;
 static int verbose_flag        = 0;
@@ -46,8 +47,11 @@ int main(int argc, char *argv[]) {
     int exit_status    = 0;
     char *zone_name = NULL;
     char *json_file = NULL;
+    char *checksum_cache = NULL;
+    char *journal_dir    = NULL;
     FILE *input     = NULL;
     unsigned long max_connect_time = DEFAULT_MAX_CONNECT_TIME;
+    size_t lookahead = 0;
 
     while (1) {
         static struct option long_options[] = {
@@ -58,26 +62,34 @@ int main(int argc, char *argv[]) {
             {"server-version", no_argument, &server_version_flag, 1},
             {"silent",         no_argument, &silent_flag,         1},
             {"single-server",  no_argument, &single_server_flag,  1},
+            {"trust-input",    no_argument, &trust_input_flag,    1},
             {"unbuffered",     no_argument, &unbuffered_flag,     1},
             {"unsafe",         no_argument, &unsafe_flag,         1},
             {"verbose",        no_argument, &verbose_flag,        1},
             {"version",        no_argument, &version_flag,        1},
             {"wlock",          no_argument, &wlock_flag,          1},
             // Indexed options
+            {"checksum-cache", required_argument, NULL, 'C'},
             {"connect-time",  required_argument, NULL, 'c'},
             {"file",          required_argument, NULL, 'f'},
+            {"journal-dir",   required_argument, NULL, 'J'},
+            {"lookahead",     required_argument, NULL, 'l'},
             {"zone",          required_argument, NULL, 'z'},
             {0, 0, 0, 0}
         };
 
         int option_index = 0;
-        int c = getopt_long_only(argc, argv, "c:f:z:",
+        int c = getopt_long_only(argc, argv, "C:c:f:J:l:z:",
                                  long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1) break;
 
         switch (c) {
+            case 'C':
+                checksum_cache = optarg;
+                break;
+
             case 'c':
                 errno = 0;
                 char *endptr;
@@ -97,6 +109,25 @@ int main(int argc, char *argv[]) {
                 json_file = optarg;
                 break;
 
+            case 'J':
+                journal_dir = optarg;
+                break;
+
+            case 'l':
+                errno = 0;
+                char *lend;
+                unsigned long lval = strtoul(optarg, &lend, 10);
+
+                if ((errno == ERANGE && lval == ULONG_MAX) ||
+                    (errno != 0 && lval == 0)              ||
+                    lend == optarg || lval > LOOKAHEAD_MAX_ITEMS) {
+                    fprintf(stderr, "Invalid --lookahead '%s'\n", optarg);
+                    exit(1);
+                }
+
+                lookahead = lval;
+                break;
+
             case 'z':
                 zone_name = optarg;
                 break;
@@ -117,14 +148,20 @@ int main(int argc, char *argv[]) {
         "\n"
         "Synopsis\n"
         "\n"
-        "    baton-do [--file <JSON file>] [--connect-time <n>] [--silent]\n"
-        "             [--unbuffered] [--verbose] [--version] [--wlock]\n"
+        "    baton-do [--file <JSON file>] [--checksum-cache <dir>]\n"
+        "             [--connect-time <n>] [--journal-dir <dir>]\n"
+        "             [--lookahead <n>] [--silent]\n"
+        "             [--trust-input] [--unbuffered] [--verbose]\n"
+        "             [--version] [--wlock]\n"
         "             [--zone]\n"
         "\n"
         "Description\n"
         "    Performs remote operations as described in the JSON\n"
         "    input file.\n"
         "\n"
+        "    --checksum-cache A directory in which to cache the checksums of\n"
+        "                     local files, keyed by device, inode, size and\n"
+        "                     modification time. Optional.\n"
         "    --connect-time   The duration in seconds after which a connection\n"
         "                     to iRODS will be refreshed (closed and reopened\n"
         "                     between JSON documents) to allow iRODS server\n"
@@ -132,12 +169,25 @@ int main(int argc, char *argv[]) {
         "                     10 minutes.\n"
         "    --file           The JSON file describing the operations.\n"
         "                     Optional, defaults to STDIN.\n"
+        "    --journal-dir    A directory in which to keep the journals of\n"
+        "                     resumable puts. Optional, defaults to\n"
+        "                     $XDG_STATE_HOME/baton or\n"
+        "                     ~/.local/state/baton.\n"
+        "    --lookahead      The number of consecutive data object\n"
+        "                     listings to read ahead and answer together.\n"
+        "                     Not for interactive use. Optional, defaults\n"
+        "                     to 0 (no lookahead).\n"
         "    --no-error       Do not return a non-zero exit code on iRODS\n"
         "                     errors. Errors will still be reported in-band\n"
         "                     as JSON responses.\n"
         "    --server-version Print the version of the server and exit.\n"
         "    --silent         Silence error messages.\n"
         "    --single-server  Only connect to a single iRODS server\n"
+        "    --trust-input    Trust targets to exist and to be data objects\n"
+        "                     or collections as their JSON describes,\n"
+        "                     rather than checking with the server first,\n"
+        "                     for the chmod, checksum, metamod and remove\n"
+        "                     operations. Optional, defaults to false.\n"
         "    --unbuffered     Flush print operations for each JSON object.\n"
  
         "    --verbose        Print verbose messages to STDERR.\n"
@@ -179,6 +229,14 @@ int main(int argc, char *argv[]) {
     if (verbose_flag) set_log_threshold(NOTICE);
     if (silent_flag)  set_log_threshold(FATAL);
 
+    if (checksum_cache && !set_checksum_cache_dir(checksum_cache)) {
+        exit(1);
+    }
+
+    if (journal_dir && !set_journal_dir(journal_dir)) {
+        exit(1);
+    }
+
     declare_client_name(argv[0]);
     input = maybe_stdin(json_file);
     if (!input) {
@@ -188,7 +246,9 @@ int main(int argc, char *argv[]) {
     operation_args_t args = { .flags            = flags,
                               .buffer_size      = default_buffer_size,
                               .zone_name        = zone_name,
-                              .max_connect_time = max_connect_time};
+                              .max_connect_time = max_connect_time,
+                              .lookahead        = lookahead,
+                              .trust_input      = trust_input_flag};
 
     int status = do_operation(input, baton_json_dispatch_op, &args);
     if (input != stdin) fclose(input);
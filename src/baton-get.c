@@ -31,10 +31,12 @@ static int acl_flag        = 0;
 static int avu_flag        = 0;
 static int debug_flag      = 0;
 static int help_flag       = 0;
+static int framed_flag     = 0;
 static int raw_flag        = 0;
 static int save_flag       = 0;
 static int silent_flag     = 0;
 static int size_flag       = 0;
+static int stream_flag     = 0;
 static int timestamp_flag  = 0;
 static int unbuffered_flag = 0;
 static int unsafe_flag     = 0;
@@ -59,10 +61,12 @@ int main(int argc, char *argv[]) {
             {"avu",         no_argument, &avu_flag,        1},
             {"debug",       no_argument, &debug_flag,      1},
             {"help",        no_argument, &help_flag,       1},
+            {"framed",      no_argument, &framed_flag,     1},
             {"raw",         no_argument, &raw_flag,        1},
             {"save",        no_argument, &save_flag,       1},
             {"silent",      no_argument, &silent_flag,     1},
             {"size",        no_argument, &size_flag,       1},
+            {"stream",      no_argument, &stream_flag,     1},
             {"timestamp",   no_argument, &timestamp_flag,  1},
             {"unbuffered",  no_argument, &unbuffered_flag, 1},
             {"unsafe",      no_argument, &unsafe_flag,     1},
@@ -119,9 +123,11 @@ int main(int argc, char *argv[]) {
 
     if (acl_flag)        flags = flags | PRINT_ACL;
     if (avu_flag)        flags = flags | PRINT_AVU;
+    if (framed_flag)     flags = flags | PRINT_RAW | PRINT_FRAMED;
     if (raw_flag)        flags = flags | PRINT_RAW;
     if (save_flag)       flags = flags | SAVE_FILES;
     if (size_flag)       flags = flags | PRINT_SIZE;
+    if (stream_flag)     flags = flags | STREAM_CONTENTS;
     if (timestamp_flag)  flags = flags | PRINT_TIMESTAMP;
     if (unbuffered_flag) flags = flags | FLUSH;
     if (unsafe_flag)     flags = flags | UNSAFE_RESOLVE;
@@ -133,9 +139,9 @@ int main(int argc, char *argv[]) {
         "Synopsis\n"
         "\n"
         "    baton-get [--acl] [--avu] [--file <JSON file>]\n"
-        "              [--connect-time <n>] [--raw] [--save]\n"
-        "              [--silent] [--size] [--timestamp] [--unbuffered]\n"
-        "              [--unsafe] [--verbose] [--version]\n"
+        "              [--connect-time <n>] [--framed] [--raw] [--save]\n"
+        "              [--silent] [--size] [--stream] [--timestamp]\n"
+        "              [--unbuffered] [--unsafe] [--verbose] [--version]\n"
         "\n"
         "Description\n"
         "    Gets the contents of data objects described in a JSON\n"
@@ -151,12 +157,16 @@ int main(int argc, char *argv[]) {
         "                 10 minutes.\n"
         "  --file         The JSON file describing the data objects.\n"
         "                 Optional, defaults to STDIN.\n"
+        "  --framed       Print data object content preceded by a one line\n"
+        "                 JSON header giving its length i.e. implies --raw.\n"
         "  --raw          Print data object content without any JSON\n"
         "                 wrapping.\n"
         "  --save         Save data object content to individual files,\n"
         "                 without any JSON wrapping i.e. implies --raw.\n"
         "  --silent       Silence error messages.\n"
         "  --size         Print data object sizes in output.\n"
+        "  --stream       Stream data object content into the JSON output,\n"
+        "                 rather than holding it in memory.\n"
         "  --timestamp    Print timestamps in output.\n"
         "  --unbuffered   Flush print operations for each JSON object.\n"
         "  --unsafe       Permit unsafe relative iRODS paths.\n"
@@ -176,7 +186,7 @@ int main(int argc, char *argv[]) {
     if (debug_flag)   set_log_threshold(DEBUG);
     if (verbose_flag) set_log_threshold(NOTICE);
     if (silent_flag)  set_log_threshold(FATAL);
-    if (raw_flag || save_flag) {
+    if (raw_flag || framed_flag || save_flag) {
         const char *msg = "Ignoring the %s flag because raw output requested";
 
         if (acl_flag)       logmsg(WARN, msg, "--acl");
@@ -181,38 +181,14 @@ int do_supersede_metadata(FILE *input, option_flags oflags) {
                     error_count++;
                 }
                 else {
-                    baton_error_t list_error;
-                    json_t *current_avus = list_metadata(conn, &rods_path, NULL,
-                                                         &list_error);
-                    if (add_error_report(target, &list_error)) {
+                    // Stops on first error, without changing any AVU
+                    // where the server supports atomic operations
+                    baton_error_t super_error;
+                    supersede_json_metadata(conn, &rods_path, avus,
+                                            &super_error);
+                    if (add_error_report(target, &super_error)) {
                         error_count++;
                     }
-                    else {
-                        baton_error_t rem_error;
-                        // Remove any current AVUs that are not equal
-                        // to target AVUs. Stops on first error.
-                        maybe_modify_json_metadata(conn, &rods_path,
-                                                   META_REM,
-                                                   current_avus, avus,
-                                                   &rem_error);
-                        if (add_error_report(target, &rem_error)) {
-                            error_count++;
-                        }
-                        else {
-                            // Add any target AVUs that are not equal to
-                            // current AVUs. Stops on first error.
-                            baton_error_t add_error;
-                            maybe_modify_json_metadata(conn, &rods_path,
-                                                       META_ADD,
-                                                       avus, current_avus,
-                                                       &add_error);
-                            if (add_error_report(target, &add_error)) {
-                                error_count++;
-                            }
-                        }
-                    }
-
-                    json_decref(current_avus);
 
                     if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
                 }
@@ -47,8 +47,10 @@ int main(int argc, char *argv[]) {
     int exit_status    = 0;
     char *zone_name = NULL;
     char *json_file = NULL;
+    char *checksum_cache = NULL;
     FILE *input     = NULL;
     size_t buffer_size = default_buffer_size;
+    size_t num_streams = 1;
     unsigned long max_connect_time = DEFAULT_MAX_CONNECT_TIME;
 
     while (1) {
@@ -66,20 +68,26 @@ int main(int argc, char *argv[]) {
             {"version",       no_argument, &version_flag,       1},
             {"wlock",         no_argument, &wlock_flag,         1},
             // Indexed options
+            {"checksum-cache", required_argument, NULL, 'C'},
             {"connect-time",  required_argument, NULL, 'c'},
             {"buffer-size",   required_argument, NULL, 'b'},
             {"file",          required_argument, NULL, 'f'},
+            {"threads",       required_argument, NULL, 't'},
             {0, 0, 0, 0}
         };
 
         int option_index = 0;
-        int c = getopt_long_only(argc, argv, "c:b:f:",
+        int c = getopt_long_only(argc, argv, "C:c:b:f:t:",
                                  long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1) break;
 
         switch (c) {
+            case 'C':
+                checksum_cache = optarg;
+                break;
+
             case 'c':
                 errno = 0;
                 char *endptr;
@@ -104,6 +112,14 @@ int main(int argc, char *argv[]) {
                 json_file = optarg;
                 break;
 
+            case 't':
+                num_streams = parse_size(optarg);
+                if (errno != 0 || num_streams == 0) {
+                    fprintf(stderr, "Invalid --threads '%s'\n", optarg);
+                    exit(1);
+                }
+                break;
+
             case '?':
                 // getopt_long already printed an error message
                 break;
@@ -126,9 +142,11 @@ int main(int argc, char *argv[]) {
         "\n"
         "Synopsis\n"
         "\n"
-        "    baton-put [--checksum|--verify] [--connect-time <n>]\n"
+        "    baton-put [--checksum|--verify] [--checksum-cache <dir>]\n"
+        "              [--connect-time <n>]\n"
         "              [--file <JSON file>]\n"
-        "              [--silent] [--unbuffered] [--unsafe]\n"
+        "              [--silent] [--single-server [--threads <n>]]\n"
+        "              [--unbuffered] [--unsafe]\n"
         "              [--verbose] [--version] [--wlock]\n"
         "\n"
         "Description\n"
@@ -147,6 +165,9 @@ int main(int argc, char *argv[]) {
         "                  Optional, defaults to STDIN.\n"
         "  --silent        Silence error messages.\n"
         "  --single-server Only connect to a single iRODS server\n"
+        "  --threads       The number of connections with which to write\n"
+        "                  each large file in single-server mode.\n"
+        "                  Optional, defaults to 1.\n"
         "  --unbuffered    Flush print operations for each JSON object.\n"
         "  --unsafe        Permit unsafe relative iRODS paths.\n"
         "  --verbose       Print verbose messages to STDERR.\n"
@@ -173,6 +194,10 @@ int main(int argc, char *argv[]) {
     if (verbose_flag) set_log_threshold(NOTICE);
     if (silent_flag)  set_log_threshold(FATAL);
 
+    if (checksum_cache && !set_checksum_cache_dir(checksum_cache)) {
+        exit(1);
+    }
+
     declare_client_name(argv[0]);
     input = maybe_stdin(json_file);
     if (!input) {
@@ -182,7 +207,8 @@ int main(int argc, char *argv[]) {
     operation_args_t args = { .flags            = flags,
                               .buffer_size      = default_buffer_size,
                               .zone_name        = zone_name,
-                              .max_connect_time = max_connect_time };
+                              .max_connect_time = max_connect_time,
+                              .num_streams      = num_streams };
 
     int status;
     if (flags & SINGLE_SERVER) {
@@ -29,11 +29,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include "config.h"
 #include "baton.h"
 #include "signal_handler.h"
 
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+#include <atomic_apply_acl_operations.h>
+#include <atomic_apply_metadata_operations.h>
+#endif
+
+static const char *access_level_names[] = { ACCESS_LEVEL_NULL,
+                                            ACCESS_LEVEL_OWN,
+                                            ACCESS_LEVEL_READ,
+                                            ACCESS_LEVEL_WRITE };
+
 static const char *metadata_op_name(metadata_op op) {
     const char *name;
 
@@ -53,6 +64,21 @@ static const char *metadata_op_name(metadata_op op) {
     return name;
 }
 
+// Return the canonical name of an access level, or NULL if it is not
+// a valid level
+static const char *find_access_level(const char *level) {
+    size_t num_levels = sizeof access_level_names / sizeof (char *);
+
+    for (size_t i = 0; i < num_levels; i++) {
+        if (str_equals_ignore_case(level, access_level_names[i],
+                                   MAX_STR_LEN)) {
+            return access_level_names[i];
+        }
+    }
+
+    return NULL;
+}
+
 static void map_mod_args(modAVUMetadataInp_t *out, mod_metadata_in_t *in) {
     out->arg0 = (char *) metadata_op_name(in->op);
     out->arg1 = in->type_arg;
@@ -348,6 +374,59 @@ error:
     return error->code;
 }
 
+int set_missing_path_error(rodsPath_t *rods_path, baton_error_t *error) {
+    switch (error->code) {
+        case CAT_UNKNOWN_FILE:
+        case CAT_UNKNOWN_COLLECTION:
+        case CAT_NO_ROWS_FOUND:
+        case OBJ_PATH_DOES_NOT_EXIST:
+            set_baton_error(error, USER_FILE_DOES_NOT_EXIST,
+                            "Path '%s' does not exist "
+                            "(or lacks access permission)",
+                            rods_path->outPath);
+            break;
+
+        default:
+            break;
+    }
+
+    return error->code;
+}
+
+int set_trusted_rods_path(json_t *target, rodsPath_t *rods_path,
+                          baton_error_t *error) {
+    init_baton_error(error);
+
+    char *path = json_to_path(target, error);
+    if (error->code != 0) goto finally;
+
+    if (path[0] != '/') {
+        set_baton_error(error, USER_INPUT_PATH_ERR, "Failed to use '%s' "
+                        "without resolving it as it is not an absolute path",
+                        path);
+        goto finally;
+    }
+
+    if (strnlen(path, MAX_NAME_LEN) >= MAX_NAME_LEN) {
+        set_baton_error(error, USER_PATH_EXCEEDS_MAX,
+                        "Path '%s' exceeds the maximum length of %d "
+                        "characters", path, MAX_NAME_LEN - 1);
+        goto finally;
+    }
+
+    memset(rods_path, 0, sizeof (rodsPath_t));
+    snprintf(rods_path->inPath,  MAX_NAME_LEN, "%s", path);
+    snprintf(rods_path->outPath, MAX_NAME_LEN, "%s", path);
+    rods_path->objState = EXIST_ST;
+    rods_path->objType  = represents_data_object(target) ? DATA_OBJ_T :
+        COLL_OBJ_T;
+
+finally:
+    if (path) free(path);
+
+    return error->code;
+}
+
 int move_rods_path(rcComm_t *conn, rodsPath_t *rods_path, char *new_path,
                    baton_error_t *error) {
     dataObjCopyInp_t obj_rename_in;
@@ -414,6 +493,323 @@ finally:
     return error->code;
 }
 
+static int copy_data_obj(rcComm_t *conn, const char *src_path,
+                         const char *dest_path, const char *resource,
+                         int flags, baton_error_t *error) {
+    dataObjCopyInp_t obj_copy_in;
+    int status;
+
+    init_baton_error(error);
+
+    memset(&obj_copy_in, 0, sizeof (dataObjCopyInp_t));
+
+    if (strnlen(src_path, MAX_NAME_LEN) == MAX_NAME_LEN ||
+        strnlen(dest_path, MAX_NAME_LEN) == MAX_NAME_LEN) {
+        set_baton_error(error, USER_PATH_EXCEEDS_MAX,
+                        "iRODS path '%s' or '%s' is too long (exceeds %d)",
+                        src_path, dest_path, MAX_NAME_LEN);
+        goto finally;
+    }
+
+    dataObjInp_t *src  = &obj_copy_in.srcDataObjInp;
+    dataObjInp_t *dest = &obj_copy_in.destDataObjInp;
+    snprintf(src->objPath, MAX_NAME_LEN, "%s", src_path);
+    snprintf(dest->objPath, MAX_NAME_LEN, "%s", dest_path);
+    src->oprType     = COPY_SRC;
+    dest->oprType    = COPY_DEST;
+    dest->createMode = 0750;
+
+    if (resource) {
+        logmsg(DEBUG, "Copying '%s' to resource '%s'", src_path, resource);
+        addKeyVal(&dest->condInput, DEST_RESC_NAME_KW, resource);
+    }
+    if (flags & VERIFY_CHECKSUM) {
+        logmsg(DEBUG, "Server will verify '%s' after copy", dest_path);
+        addKeyVal(&dest->condInput, VERIFY_CHKSUM_KW, "");
+    }
+    else if (flags & CALCULATE_CHECKSUM) {
+        logmsg(DEBUG, "Server will calculate checksum for '%s'", dest_path);
+        addKeyVal(&dest->condInput, REG_CHKSUM_KW, "");
+    }
+    if (flags & FORCE) {
+        addKeyVal(&dest->condInput, FORCE_FLAG_KW, "");
+    }
+
+    status = rcDataObjCopy(conn, &obj_copy_in);
+    clearKeyVal(&dest->condInput);
+
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to copy '%s' to '%s': %d %s",
+                        src_path, dest_path, status, err_name);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Copied '%s' to '%s'", src_path, dest_path);
+
+finally:
+    return error->code;
+}
+
+// Return a new path, the given path moved from below one collection to
+// below another
+static char *rebase_path(const char *path, const char *from, const char *to,
+                         baton_error_t *error) {
+    size_t from_len = strlen(from);
+    while (from_len > 0 && from[from_len - 1] == '/') from_len--;
+
+    size_t len = strlen(to) + strlen(path + from_len) + 1;
+    char *new_path = calloc(len, sizeof (char));
+    if (!new_path) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        return NULL;
+    }
+    snprintf(new_path, len, "%s%s", to, path + from_len);
+
+    return new_path;
+}
+
+/**
+ *  @struct coll_copy
+ *  @brief The state of a recursive collection copy.
+ */
+typedef struct coll_copy {
+    rcComm_t *conn;
+    const char *src_path;
+    const char *dest_path;
+    const char *resource;
+    int flags;
+    size_t num_copied;
+    size_t num_failed;
+} coll_copy_t;
+
+static int copy_listed_colls(json_t *page, void *state, baton_error_t *error) {
+    coll_copy_t *copy = state;
+
+    for (size_t i = 0; i < json_array_size(page); i++) {
+        const char *coll = get_collection_value(json_array_get(page, i),
+                                                error);
+        if (error->code != 0) break;
+
+        char *path = rebase_path(coll, copy->src_path, copy->dest_path,
+                                 error);
+        if (error->code != 0) break;
+
+        rodsPath_t coll_path;
+        memset(&coll_path, 0, sizeof (rodsPath_t));
+        snprintf(coll_path.outPath, MAX_NAME_LEN, "%s", path);
+        free(path);
+
+        create_collection(copy->conn, &coll_path, RECURSIVE, error);
+        if (error->code != 0) break;
+    }
+
+    return error->code;
+}
+
+static int copy_listed_objs(json_t *page, void *state, baton_error_t *error) {
+    coll_copy_t *copy = state;
+
+    for (size_t i = 0; i < json_array_size(page); i++) {
+        char *obj_path = json_to_path(json_array_get(page, i), error);
+        if (error->code != 0) break;
+
+        char *path = rebase_path(obj_path, copy->src_path, copy->dest_path,
+                                 error);
+        if (error->code != 0) {
+            free(obj_path);
+            break;
+        }
+
+        // A data object which cannot be copied, such as one having no
+        // good replica, is reported and the rest are still copied
+        baton_error_t obj_error;
+        copy_data_obj(copy->conn, obj_path, path, copy->resource,
+                      copy->flags, &obj_error);
+        if (obj_error.code != 0) {
+            logmsg(ERROR, "%s", obj_error.message);
+            copy->num_failed++;
+        }
+        else {
+            copy->num_copied++;
+        }
+
+        free(obj_path);
+        free(path);
+    }
+
+    return error->code;
+}
+
+static int copy_collection(rcComm_t *conn, const char *src_path,
+                           const char *dest_path, const char *resource,
+                           int flags, baton_error_t *error) {
+    coll_copy_t copy = { .conn      = conn,
+                         .src_path  = src_path,
+                         .dest_path = dest_path,
+                         .resource  = resource,
+                         .flags     = flags };
+
+    init_baton_error(error);
+
+    size_t src_len = strlen(src_path);
+    while (src_len > 0 && src_path[src_len - 1] == '/') src_len--;
+    if (strncmp(dest_path, src_path, src_len) == 0 &&
+        (dest_path[src_len] == '/' || dest_path[src_len] == '\0')) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Failed to copy '%s' to '%s' which is within it",
+                        src_path, dest_path);
+        goto finally;
+    }
+
+    rodsPath_t coll_path;
+    memset(&coll_path, 0, sizeof (rodsPath_t));
+    snprintf(coll_path.outPath, MAX_NAME_LEN, "%s", dest_path);
+    create_collection(conn, &coll_path, RECURSIVE, error);
+    if (error->code != 0) goto finally;
+
+    // The tree is listed a page at a time as it is copied. Every data
+    // object is listed, whatever the state of its replicas, so that
+    // the server reports any that it cannot copy.
+    walk_sub_collections(conn, src_path, copy_listed_colls, &copy, error);
+    if (error->code != 0) goto finally;
+
+    walk_collection_data_objs(conn, src_path, 1, copy_listed_objs, &copy,
+                              error);
+    if (error->code != 0) goto finally;
+
+    if (copy.num_failed > 0) {
+        set_baton_error(error, -1, "Failed to copy %zu of %zu data objects "
+                        "from '%s' to '%s'", copy.num_failed,
+                        copy.num_failed + copy.num_copied, src_path,
+                        dest_path);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Copied %zu data objects from '%s' to '%s'",
+           copy.num_copied, src_path, dest_path);
+
+finally:
+    return error->code;
+}
+
+int copy_rods_path(rcComm_t *conn, rodsPath_t *rods_path, char *new_path,
+                   char *resource, int flags, baton_error_t *error) {
+    init_baton_error(error);
+
+    check_str_arg("path", new_path, MAX_NAME_LEN, error);
+    if (error->code != 0) goto finally;
+
+    switch (rods_path->objType) {
+        case DATA_OBJ_T:
+            logmsg(TRACE, "Identified '%s' as a data object",
+                   rods_path->outPath);
+            copy_data_obj(conn, rods_path->outPath, new_path, resource,
+                          flags, error);
+            break;
+
+        case COLL_OBJ_T:
+            logmsg(TRACE, "Identified '%s' as a collection",
+                   rods_path->outPath);
+            if (!(flags & RECURSIVE)) {
+                set_baton_error(error, USER_INPUT_OPTION_ERR,
+                                "Cannot copy collection '%s' without "
+                                "recursion", rods_path->outPath);
+                goto finally;
+            }
+
+            copy_collection(conn, rods_path->outPath, new_path, resource,
+                            flags, error);
+            break;
+
+        default:
+            set_baton_error(error, USER_INPUT_PATH_ERR,
+                            "Failed to copy '%s' as it is "
+                            "neither data object nor collection",
+                            rods_path->outPath);
+    }
+
+finally:
+    return error->code;
+}
+
+int local_file_in_sync(rcComm_t *conn, rodsPath_t *rods_path,
+                       const char *local_path, baton_error_t *error) {
+    json_t *remote = NULL;
+    int in_sync    = 0;
+    struct stat st;
+
+    init_baton_error(error);
+
+    if (rods_path->objState == NOT_EXIST_ST) {
+        logmsg(DEBUG, "'%s' is not in sync with '%s': data object absent",
+               local_path, rods_path->outPath);
+        goto finally;
+    }
+
+    if (stat(local_path, &st) != 0) {
+        logmsg(DEBUG, "'%s' is not in sync with '%s': local file absent",
+               local_path, rods_path->outPath);
+        goto finally;
+    }
+
+    remote = list_size_checksum(conn, rods_path, error);
+    if (error->code != 0) goto finally;
+
+    json_int_t size = json_integer_value(json_object_get(remote,
+                                                         JSON_SIZE_KEY));
+    if (size != (json_int_t) st.st_size) {
+        logmsg(DEBUG, "'%s' is not in sync with '%s': size %lld != %lld",
+               local_path, rods_path->outPath, (long long) st.st_size,
+               (long long) size);
+        goto finally;
+    }
+
+    const char *checksum =
+        json_string_value(json_object_get(remote, JSON_CHECKSUM_KEY));
+    if (!checksum) {
+        logmsg(DEBUG, "'%s' is not in sync with '%s': no checksum in "
+               "the catalog", local_path, rods_path->outPath);
+        goto finally;
+    }
+
+    in_sync = local_checksum_matches(local_path, checksum, error);
+    logmsg(DEBUG, "'%s' %s in sync with '%s'", local_path,
+           in_sync ? "is" : "is not", rods_path->outPath);
+
+finally:
+    if (remote) json_decref(remote);
+
+    return in_sync;
+}
+
+int local_checksum_matches(const char *local_path, const char *checksum,
+                           baton_error_t *error) {
+    int matches = 0;
+
+    init_baton_error(error);
+
+    // Checksum with the same hash scheme as the catalog
+    const char *scheme = CHECKSUM_ALGORITHM_MD5;
+    if (str_starts_with(checksum, CHECKSUM_SHA256_PREFIX, NAME_LEN)) {
+        scheme = CHECKSUM_ALGORITHM_SHA256;
+    }
+
+    char local_checksum[NAME_LEN];
+    checksum_local_file(local_path, scheme, local_checksum, error);
+    if (error->code != 0) goto finally;
+
+    matches = str_equals_ignore_case(local_checksum, checksum, NAME_LEN);
+    logmsg(DEBUG, "'%s' checksum %s %s %s", local_path, local_checksum,
+           matches ? "==" : "!=", checksum);
+
+finally:
+    return matches;
+}
+
 int resolve_collection(json_t *object, rcComm_t *conn, rodsEnv *env,
                        option_flags flags, baton_error_t *error) {
     char *collection = NULL;
@@ -634,14 +1030,7 @@ int modify_permissions(rcComm_t *conn, rodsPath_t *rods_path,
     mod_perms_in.zone          = zone_name;
     mod_perms_in.path          = rods_path->outPath;
 
-    if (!(str_equals_ignore_case(access_level,
-                                 ACCESS_LEVEL_NULL, MAX_STR_LEN) ||
-          str_equals_ignore_case(access_level,
-                                 ACCESS_LEVEL_OWN,  MAX_STR_LEN) ||
-          str_equals_ignore_case(access_level,
-                                 ACCESS_LEVEL_READ, MAX_STR_LEN) ||
-          str_equals_ignore_case(access_level,
-                                 ACCESS_LEVEL_WRITE, MAX_STR_LEN))) {
+    if (!find_access_level(access_level)) {
         set_baton_error(error, CAT_INVALID_ARGUMENT,
                         "Invalid permission level: expected one of "
                         "[%s, %s, %s, %s]",
@@ -796,29 +1185,27 @@ int maybe_modify_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
                                metadata_op operation,
                                json_t *candidate_avus, json_t *reference_avus,
                                baton_error_t *error) {
-    const char *op_name = metadata_op_name(operation);
+    json_t *avus = NULL;
 
     init_baton_error(error);
 
-    for (size_t i = 0; i < json_array_size(candidate_avus); i++) {
-        json_t *candidate_avu = json_array_get(candidate_avus, i);
-        char *str = json_dumps(candidate_avu, JSON_DECODE_ANY);
-
-        if (contains_avu(reference_avus, candidate_avu)) {
-            logmsg(TRACE, "Skipping '%s' operation on AVU %s", op_name, str);
-        }
-        else {
-            logmsg(TRACE, "Performing '%s' operation on AVU %s", op_name, str);
-            modify_json_metadata(conn, rods_path, operation, candidate_avu,
-                                 error);
-        }
+    avus = avu_set_difference(candidate_avus, reference_avus, error);
+    if (error->code != 0) goto finally;
 
-        free(str);
+    logmsg(TRACE, "Performing '%s' operation on %zu of %zu AVUs",
+           metadata_op_name(operation), json_array_size(avus),
+           json_array_size(candidate_avus));
 
-        if (error->code != 0) goto finally;
+    if (operation == META_ADD) {
+        apply_json_metadata(conn, rods_path, NULL, avus, error);
+    }
+    else {
+        apply_json_metadata(conn, rods_path, avus, NULL, error);
     }
 
 finally:
+    if (avus) json_decref(avus);
+
     return error->code;
 }
 
@@ -872,3 +1259,413 @@ finally:
 
     return error->code;
 }
+
+int check_json_avus(json_t *avus, baton_error_t *error) {
+    init_baton_error(error);
+
+    if (avus && !json_is_array(avus)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Invalid AVUs: not a JSON array");
+        goto finally;
+    }
+
+    for (size_t i = 0; i < json_array_size(avus); i++) {
+        json_t *avu = json_array_get(avus, i);
+
+        const char *attr = get_avu_attribute(avu, error);
+        if (error->code != 0) goto finally;
+
+        const char *value = get_avu_value(avu, error);
+        if (error->code != 0) goto finally;
+
+        const char *units = get_avu_units(avu, error);
+        if (error->code != 0) goto finally;
+
+        check_str_arg("attr_name", attr, MAX_STR_LEN, error);
+        if (error->code != 0) goto finally;
+
+        check_str_arg("attr_value", value, MAX_STR_LEN, error);
+        if (error->code != 0) goto finally;
+
+        // Units are optional
+        if (units) {
+            check_str_arg_permit_empty("attr_units", units, MAX_STR_LEN,
+                                       error);
+            if (error->code != 0) goto finally;
+        }
+    }
+
+finally:
+    return error->code;
+}
+
+// The atomic metadata operations API was introduced in iRODS 4.2.9
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+
+static int add_atomic_metadata_ops(json_t *operations, metadata_op operation,
+                                   json_t *avus, baton_error_t *error) {
+    // The atomic API names the remove operation in full
+    const char *op_name = operation == META_REM ? "remove" :
+        metadata_op_name(operation);
+
+    for (size_t i = 0; i < json_array_size(avus); i++) {
+        json_t *avu = json_array_get(avus, i);
+        const char *units = get_avu_units(avu, error);
+        if (error->code != 0) goto finally;
+
+        json_t *op = json_pack("{s:s, s:s, s:s, s:s}",
+                               "operation", op_name,
+                               "attribute", get_avu_attribute(avu, error),
+                               "value",     get_avu_value(avu, error),
+                               "units",     units ? units : "");
+        if (!op || json_array_append_new(operations, op) != 0) {
+            set_baton_error(error, -1, "Failed to pack a metadata operation");
+            goto finally;
+        }
+    }
+
+finally:
+    return error->code;
+}
+
+static int apply_atomic_metadata(rcComm_t *conn, rodsPath_t *rods_path,
+                                 const char *entity_type,
+                                 json_t *remove_avus, json_t *add_avus,
+                                 baton_error_t *error) {
+    char *input  = NULL;
+    char *output = NULL;
+
+    json_t *request = json_pack("{s:s, s:s, s:[]}",
+                                "entity_name", rods_path->outPath,
+                                "entity_type", entity_type,
+                                "operations");
+    if (!request) {
+        set_baton_error(error, -1, "Failed to pack a metadata request");
+        goto finally;
+    }
+
+    // Removals are applied before additions, so that an AVU may be
+    // removed and re-added in one request
+    json_t *operations = json_object_get(request, "operations");
+    add_atomic_metadata_ops(operations, META_REM, remove_avus, error);
+    if (error->code != 0) goto finally;
+
+    add_atomic_metadata_ops(operations, META_ADD, add_avus, error);
+    if (error->code != 0) goto finally;
+
+    input = json_dumps(request, JSON_COMPACT);
+    if (!input) {
+        set_baton_error(error, -1, "Failed to encode a metadata request");
+        goto finally;
+    }
+
+    logmsg(DEBUG, "Applying %zu metadata operations to '%s' atomically",
+           json_array_size(operations), rods_path->outPath);
+
+    int status = rc_atomic_apply_metadata_operations(conn, input, &output);
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to apply %zu metadata operations to '%s': "
+                        "error %d %s %s", json_array_size(operations),
+                        rods_path->outPath, status, err_name,
+                        output ? output : "");
+
+        // An older server lacks the API; the caller falls back
+        if (status != SYS_UNMATCHED_API_NUM) {
+            logmsg(ERROR, "%s", error->message);
+            if (conn->rError) log_rods_errstack(ERROR, conn->rError);
+        }
+    }
+
+finally:
+    if (request) json_decref(request);
+    if (input)   free(input);
+    if (output)  free(output);
+
+    return error->code;
+}
+
+#endif
+
+int apply_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
+                        json_t *remove_avus, json_t *add_avus,
+                        baton_error_t *error) {
+    init_baton_error(error);
+
+    // All the AVUs are checked before any is applied, so that an
+    // invalid AVU does not leave the others partly applied
+    check_json_avus(remove_avus, error);
+    if (error->code != 0) goto finally;
+
+    check_json_avus(add_avus, error);
+    if (error->code != 0) goto finally;
+
+    apply_checked_json_metadata(conn, rods_path, remove_avus, add_avus,
+                                error);
+
+finally:
+    return error->code;
+}
+
+int apply_checked_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
+                                json_t *remove_avus, json_t *add_avus,
+                                baton_error_t *error) {
+    const char *entity_type;
+
+    init_baton_error(error);
+
+    if (rods_path->objState == NOT_EXIST_ST) {
+        set_baton_error(error, USER_FILE_DOES_NOT_EXIST,
+                        "Path '%s' does not exist "
+                        "(or lacks access permission)", rods_path->outPath);
+        goto finally;
+    }
+
+    switch (rods_path->objType) {
+        case DATA_OBJ_T:
+            entity_type = "data_object";
+            break;
+
+        case COLL_OBJ_T:
+            entity_type = "collection";
+            break;
+
+        default:
+            set_baton_error(error, USER_INPUT_PATH_ERR,
+                            "Failed to set metadata on '%s' as it is "
+                            "neither data object nor collection",
+                            rods_path->outPath);
+            goto finally;
+    }
+
+    size_t num_ops = json_array_size(remove_avus) + json_array_size(add_avus);
+    if (num_ops == 0) goto finally;
+
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+    apply_atomic_metadata(conn, rods_path, entity_type, remove_avus, add_avus,
+                          error);
+    if (error->code != SYS_UNMATCHED_API_NUM) goto finally;
+
+    logmsg(NOTICE, "The server does not support atomic metadata operations; "
+           "applying %zu to '%s' one at a time", num_ops,
+           rods_path->outPath);
+    init_baton_error(error);
+#else
+    logmsg(DEBUG, "Applying %zu metadata operations to '%s' one at a time "
+           "(entity type %s)", num_ops, rods_path->outPath, entity_type);
+#endif
+
+    for (size_t i = 0; i < json_array_size(remove_avus); i++) {
+        json_t *avu = json_array_get(remove_avus, i);
+        modify_json_metadata(conn, rods_path, META_REM, avu, error);
+        if (error->code != 0) goto finally;
+    }
+
+    for (size_t i = 0; i < json_array_size(add_avus); i++) {
+        json_t *avu = json_array_get(add_avus, i);
+        modify_json_metadata(conn, rods_path, META_ADD, avu, error);
+        if (error->code != 0) goto finally;
+    }
+
+finally:
+    return error->code;
+}
+
+int supersede_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
+                            json_t *avus, baton_error_t *error) {
+    json_t *current_avus = NULL;
+    json_t *remove_avus  = NULL;
+    json_t *add_avus     = NULL;
+
+    init_baton_error(error);
+
+    if (!json_is_array(avus)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "AVU data for %s is not in a JSON array",
+                        rods_path->outPath);
+        goto finally;
+    }
+
+    current_avus = list_metadata(conn, rods_path, NULL, error);
+    if (error->code != 0) goto finally;
+
+    remove_avus = avu_set_difference(current_avus, avus, error);
+    if (error->code != 0) goto finally;
+
+    add_avus = avu_set_difference(avus, current_avus, error);
+    if (error->code != 0) goto finally;
+
+    logmsg(DEBUG, "Superseding metadata on '%s': removing %zu and adding "
+           "%zu of %zu AVUs", rods_path->outPath,
+           json_array_size(remove_avus), json_array_size(add_avus),
+           json_array_size(avus));
+
+    apply_json_metadata(conn, rods_path, remove_avus, add_avus, error);
+
+finally:
+    if (current_avus) json_decref(current_avus);
+    if (remove_avus)  json_decref(remove_avus);
+    if (add_avus)     json_decref(add_avus);
+
+    return error->code;
+}
+
+static int check_json_permissions(json_t *acl, baton_error_t *error) {
+    if (!json_is_array(acl)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Invalid permissions: not a JSON array");
+        goto finally;
+    }
+
+    for (size_t i = 0; i < json_array_size(acl); i++) {
+        json_t *access = json_array_get(acl, i);
+
+        const char *owner = get_access_owner(access, error);
+        if (error->code != 0) goto finally;
+
+        check_str_arg("owner specifier", owner, MAX_STR_LEN, error);
+        if (error->code != 0) goto finally;
+
+        get_access_zone(access, error);
+        if (error->code != 0) goto finally;
+
+        const char *level = get_access_level(access, error);
+        if (error->code != 0) goto finally;
+
+        if (!find_access_level(level)) {
+            set_baton_error(error, CAT_INVALID_ARGUMENT,
+                            "Invalid permission level: expected one of "
+                            "[%s, %s, %s, %s]",
+                            ACCESS_LEVEL_NULL, ACCESS_LEVEL_OWN,
+                            ACCESS_LEVEL_READ, ACCESS_LEVEL_WRITE);
+            goto finally;
+        }
+    }
+
+finally:
+    return error->code;
+}
+
+// The atomic ACL operations API was introduced in iRODS 4.2.9
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+
+// Return true if no access names a zone other than that of the path,
+// as the atomic API looks up users and groups by name alone
+static int acl_in_path_zone(json_t *acl, const char *path) {
+    const char *zone = path[0] == '/' ? path + 1 : path;
+    size_t zone_len  = strcspn(zone, "/");
+
+    for (size_t i = 0; i < json_array_size(acl); i++) {
+        baton_error_t error;
+        const char *owner_zone = get_access_zone(json_array_get(acl, i),
+                                                 &error);
+        if (!owner_zone) continue;
+
+        if (strlen(owner_zone) != zone_len ||
+            strncmp(owner_zone, zone, zone_len) != 0) return 0;
+    }
+
+    return 1;
+}
+
+static int apply_atomic_permissions(rcComm_t *conn, rodsPath_t *rods_path,
+                                    json_t *acl, baton_error_t *error) {
+    char *input  = NULL;
+    char *output = NULL;
+
+    json_t *request = json_pack("{s:s, s:[]}",
+                                "logical_path", rods_path->outPath,
+                                "operations");
+    if (!request) {
+        set_baton_error(error, -1, "Failed to pack a permissions request");
+        goto finally;
+    }
+
+    json_t *operations = json_object_get(request, "operations");
+    for (size_t i = 0; i < json_array_size(acl); i++) {
+        json_t *access = json_array_get(acl, i);
+        const char *owner = get_access_owner(access, error);
+        const char *level = get_access_level(access, error);
+
+        json_t *op = json_pack("{s:s, s:s}",
+                               "entity_name", owner,
+                               "acl",         find_access_level(level));
+        if (!op || json_array_append_new(operations, op) != 0) {
+            set_baton_error(error, -1, "Failed to pack a permissions "
+                            "operation");
+            goto finally;
+        }
+    }
+
+    input = json_dumps(request, JSON_COMPACT);
+    if (!input) {
+        set_baton_error(error, -1, "Failed to encode a permissions request");
+        goto finally;
+    }
+
+    logmsg(DEBUG, "Applying %zu permissions operations to '%s' atomically",
+           json_array_size(operations), rods_path->outPath);
+
+    int status = rc_atomic_apply_acl_operations(conn, input, &output);
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to apply %zu permissions operations to "
+                        "'%s': error %d %s %s", json_array_size(operations),
+                        rods_path->outPath, status, err_name,
+                        output ? output : "");
+
+        // An older server lacks the API; the caller falls back
+        if (status != SYS_UNMATCHED_API_NUM) {
+            logmsg(ERROR, "%s", error->message);
+            if (conn->rError) log_rods_errstack(ERROR, conn->rError);
+        }
+    }
+
+finally:
+    if (request) json_decref(request);
+    if (input)   free(input);
+    if (output)  free(output);
+
+    return error->code;
+}
+
+#endif
+
+int apply_json_permissions(rcComm_t *conn, rodsPath_t *rods_path,
+                           recursive_op recurse, json_t *acl,
+                           baton_error_t *error) {
+    init_baton_error(error);
+
+    // All the permissions are checked before any is applied, so that
+    // an invalid one does not leave the others partly applied
+    check_json_permissions(acl, error);
+    if (error->code != 0) goto finally;
+
+    if (json_array_size(acl) == 0) goto finally;
+
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+    // The atomic API neither recurses nor accepts users of other zones
+    if (recurse == NO_RECURSE && acl_in_path_zone(acl, rods_path->outPath)) {
+        apply_atomic_permissions(conn, rods_path, acl, error);
+        if (error->code != SYS_UNMATCHED_API_NUM) goto finally;
+
+        logmsg(NOTICE, "The server does not support atomic permissions "
+               "operations; applying %zu to '%s' one at a time",
+               json_array_size(acl), rods_path->outPath);
+        init_baton_error(error);
+    }
+#endif
+
+    for (size_t i = 0; i < json_array_size(acl); i++) {
+        json_t *access = json_array_get(acl, i);
+        modify_json_permissions(conn, rods_path, recurse, access, error);
+        if (error->code != 0) goto finally;
+    }
+
+finally:
+    return error->code;
+}
@@ -26,10 +26,15 @@
 #include <rodsClient.h>
 
 #include "config.h"
+#include "archive.h"
+#include "bulk.h"
+#include "checksum_cache.h"
+#include "journal.h"
 #include "json_query.h"
 #include "list.h"
 #include "log.h"
 #include "read.h"
+#include "workers.h"
 #include "write.h"
 
 #define MAX_VERSION_STR_LEN 512
@@ -154,9 +159,92 @@ int resolve_rods_path(rcComm_t *conn, rodsEnv *env,
 int set_rods_path(rcComm_t *conn, rodsPath_t *rods_path, char *path,
                   baton_error_t *error);
 
+/**
+ * Initialise and set an iRODS path from a baton JSON target, trusting
+ * the target to name an existing data object (if it has a data object
+ * property) or collection, rather than asking the server. A missing
+ * path is then reported only by the server request acting on it.
+ *
+ * @param[in]  target    A baton JSON target having an absolute path.
+ * @param[out] rodspath  An iRODS path.
+ * @param[out] error     An error report struct.
+ *
+ * @return 0 on success, error code on failure.
+ */
+int set_trusted_rods_path(json_t *target, rodsPath_t *rods_path,
+                          baton_error_t *error);
+
+/**
+ * Replace an error with which the server reports a missing trusted
+ * path with USER_FILE_DOES_NOT_EXIST, the error reported for a path
+ * found missing by resolving it. Other errors are unchanged.
+ *
+ * @param[in]     rodspath  An iRODS path set by set_trusted_rods_path.
+ * @param[in,out] error     An error report struct.
+ *
+ * @return The error code.
+ */
+int set_missing_path_error(rodsPath_t *rods_path, baton_error_t *error);
+
 int move_rods_path(rcComm_t *conn, rodsPath_t *rods_path, char *new_path,
                    baton_error_t *error);
 
+/**
+ * Copy a resolved iRODS path to a new path on the server side, without
+ * transferring data through the client. A collection is copied
+ * recursively into a collection which is created if absent, its tree
+ * being listed a page at a time as it is copied. Every data object in
+ * the tree is copied, whatever the state of its replicas. One that
+ * the server cannot copy is logged and the rest are still copied,
+ * after which the copy fails, giving the number not copied.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  rods_path  An iRODS data object or collection path.
+ * @param[in]  new_path   The path of the copy.
+ * @param[in]  resource   The resource of the copy. Optional, may be NULL.
+ * @param[in]  flags      RECURSIVE to copy a collection (required for
+ *                        collections), VERIFY_CHECKSUM or
+ *                        CALCULATE_CHECKSUM to have the server verify or
+ *                        calculate the checksum of each copy, FORCE to
+ *                        overwrite existing data objects.
+ * @param[out] error      An error report struct.
+ *
+ * @return 0 on success, iRODS error code on failure.
+ */
+int copy_rods_path(rcComm_t *conn, rodsPath_t *rods_path, char *new_path,
+                   char *resource, int flags, baton_error_t *error);
+
+/**
+ * Test whether a local file has the same size and checksum as a
+ * resolved iRODS data object, as recorded in the catalog. The local
+ * checksum is calculated with the hash scheme of the catalog checksum,
+ * using the local checksum cache, if enabled.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  rods_path   An iRODS data object path.
+ * @param[in]  local_path  A local file path.
+ * @param[out] error       An error report struct.
+ *
+ * @return 1 if the local file and data object both exist and match,
+ * or 0 otherwise (including when the catalog has no checksum).
+ */
+int local_file_in_sync(rcComm_t *conn, rodsPath_t *rods_path,
+                       const char *local_path, baton_error_t *error);
+
+/**
+ * Test whether a local file has a catalog checksum. The local checksum
+ * is calculated with the hash scheme of the catalog checksum, using
+ * the local checksum cache, if enabled.
+ *
+ * @param[in]  local_path  A local file path.
+ * @param[in]  checksum    A catalog checksum.
+ * @param[out] error       An error report struct.
+ *
+ * @return 1 if the checksums match, or 0 otherwise.
+ */
+int local_checksum_matches(const char *local_path, const char *checksum,
+                           baton_error_t *error);
+
 int resolve_collection(json_t *object, rcComm_t *conn, rodsEnv *env,
                        option_flags flags, baton_error_t *error);
 
@@ -229,6 +317,28 @@ int modify_json_permissions(rcComm_t *conn, rodsPath_t *rods_path,
                             recursive_op recurse, json_t *perms,
                             baton_error_t *error);
 
+/**
+ * Modify the access control list of a resolved iRODS path with an
+ * array of JSON access control objects. All of them are checked
+ * before any is applied. Where the server supports it (iRODS 4.2.9 or
+ * later), they are applied atomically in a single request, unless
+ * recursing or an access names a user of a zone other than that of
+ * the path. Otherwise, they are applied one at a time, in order.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  rods_path  A resolved iRODS path.
+ * @param[in]  recurse    Recurse into collections, one of RECURSE,
+ *                        NO_RECURSE.
+ * @param[in]  acl        A JSON array of JSON access control objects.
+ * @param[out] error      An error report struct.
+ *
+ * @return 0 on success, iRODS error code on failure.
+ * @ref modify_json_permissions
+ */
+int apply_json_permissions(rcComm_t *conn, rodsPath_t *rods_path,
+                           recursive_op recurse, json_t *acl,
+                           baton_error_t *error);
+
 /**
  * Apply a metadata operation to an AVU on a resolved iRODS path.
  *
@@ -267,7 +377,7 @@ int modify_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
 /**
  * Apply a metadata operation to a AVUs on a resolved iRODS path. The
  * operation is applied to each candidate AVU that does not occur in
- * reference AVUs.
+ * reference AVUs, as one atomic request where the server supports it.
  *
  * @param[in]  conn            An open iRODS connection.
  * @param[in]  rods_path       A resolved iRODS path.
@@ -285,4 +395,78 @@ int maybe_modify_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
                                json_t *candidate_avus, json_t *reference_avus,
                                baton_error_t *error);
 
+/**
+ * Remove and add AVUs on a resolved iRODS path. All the AVUs are
+ * checked before any is applied. Where the server supports it (iRODS
+ * 4.2.9 or later), the removals and then the additions are applied
+ * atomically in a single request, so that either all succeed or none
+ * does. Otherwise, they are applied one at a time in the same order
+ * and a failure may leave them partly applied.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  rods_path    A resolved iRODS path.
+ * @param[in]  remove_avus  A JSON array of JSON AVUs to remove. Optional,
+ *                          may be NULL.
+ * @param[in]  add_avus     A JSON array of JSON AVUs to add. Optional,
+ *                          may be NULL.
+ * @param[out] error        An error report struct.
+ *
+ * @return 0 on success, iRODS error code on failure.
+ * @ref modify_json_metadata
+ */
+int apply_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
+                        json_t *remove_avus, json_t *add_avus,
+                        baton_error_t *error);
+
+/**
+ * Check that AVUs are valid to apply, being a JSON array (or NULL) of
+ * AVUs having an attribute and value, and optionally units, within
+ * the iRODS length limits.
+ *
+ * @param[in]  avus   A JSON array of JSON AVUs. Optional, may be NULL.
+ * @param[out] error  An error report struct.
+ *
+ * @return 0 on success, error code on failure.
+ */
+int check_json_avus(json_t *avus, baton_error_t *error);
+
+/**
+ * Remove and add AVUs on a resolved iRODS path, as apply_json_metadata
+ * does, but without checking the AVUs, which the caller has already
+ * checked with check_json_avus. This allows AVUs applied to many paths
+ * to be checked once.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  rods_path    A resolved iRODS path.
+ * @param[in]  remove_avus  A JSON array of checked JSON AVUs to remove.
+ *                          Optional, may be NULL.
+ * @param[in]  add_avus     A JSON array of checked JSON AVUs to add.
+ *                          Optional, may be NULL.
+ * @param[out] error        An error report struct.
+ *
+ * @return 0 on success, iRODS error code on failure.
+ * @ref apply_json_metadata
+ */
+int apply_checked_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
+                                json_t *remove_avus, json_t *add_avus,
+                                baton_error_t *error);
+
+/**
+ * Replace the metadata on a resolved iRODS path with the given AVUs.
+ * The current AVUs are listed and compared with the given AVUs in
+ * linear time. Current AVUs not among those given are removed and
+ * given AVUs not among the current ones are added, using
+ * apply_json_metadata, so that AVUs present in both are untouched.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  rods_path  A resolved iRODS path.
+ * @param[in]  avus       A JSON array of JSON AVUs.
+ * @param[out] error      An error report struct.
+ *
+ * @return 0 on success, iRODS error code on failure.
+ * @ref apply_json_metadata
+ */
+int supersede_json_metadata(rcComm_t *conn, rodsPath_t *rods_path,
+                            json_t *avus, baton_error_t *error);
+
 #endif // _BATON_H
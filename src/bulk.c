@@ -0,0 +1,1678 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file bulk.c
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "config.h"
+#include "baton.h"
+#include "bulk.h"
+#include "checksum_cache.h"
+#include "json.h"
+#include "list.h"
+#include "log.h"
+#include "utilities.h"
+#include "workers.h"
+#include "write.h"
+
+/**
+ *  @struct bulk_entry
+ *  @brief A local file to be put.
+ */
+typedef struct bulk_entry {
+    /** The file path, relative to the local directory */
+    char *name;
+    /** The file size */
+    size_t size;
+    /** The file mode */
+    mode_t mode;
+    /** The errno of a failure to stat the file, or 0 */
+    int errnum;
+} bulk_entry_t;
+
+/**
+ *  @struct bulk_list
+ *  @brief A list of local files.
+ */
+typedef struct bulk_list {
+    const char *local_dir;
+    bulk_entry_t *entries;
+    size_t num_entries;
+    size_t capacity;
+} bulk_list_t;
+
+/**
+ *  @struct bulk_put
+ *  @brief The state of a bulk put.
+ */
+typedef struct bulk_put {
+    rcComm_t *conn;
+    const char *coll_path;
+    FILE *out;
+    option_flags flags;
+    /** The files to put, sorted by name */
+    bulk_list_t files;
+    /** The files in the current batch, by index */
+    size_t batch[BULK_PUT_MAX_FILES];
+    /** The checksums of the files in the current batch, if verifying */
+    char checksums[BULK_PUT_MAX_FILES][NAME_LEN];
+    size_t batch_size;
+    /** The contents of the files in the current batch */
+    char *buffer;
+    size_t buffer_len;
+    size_t num_put;
+    size_t num_failed;
+    size_t num_bytes;
+} bulk_put_t;
+
+/**
+ *  @struct sync_task
+ *  @brief A local file which may need to be put.
+ */
+typedef struct sync_task {
+    /** The file, by index */
+    size_t index;
+    /** The catalog checksum of a data object of the same size, if
+        any, to compare before putting */
+    const char *checksum;
+} sync_task_t;
+
+/**
+ *  @struct bulk_sync
+ *  @brief The state of a sync, shared by its workers.
+ */
+typedef struct bulk_sync {
+    const char *coll_path;
+    FILE *out;
+    option_flags flags;
+    size_t buffer_size;
+    /** The local files, sorted by name */
+    bulk_list_t files;
+    sync_task_t *tasks;
+    size_t num_tasks;
+    /** The data objects in the collection, by relative path */
+    json_t *remote;
+    /** The collections known to exist, by relative path */
+    json_t *colls;
+    /** Guards the output and the counters */
+    pthread_mutex_t lock;
+    size_t num_put;
+    size_t num_skipped;
+    size_t num_removed;
+    size_t num_failed;
+} bulk_sync_t;
+
+/**
+ *  @struct bulk_replicate
+ *  @brief The state of a replication, shared by its workers.
+ */
+typedef struct bulk_replicate {
+    const char *resource;
+    FILE *out;
+    option_flags flags;
+    /** The data objects to replicate */
+    char **paths;
+    size_t num_paths;
+    /** Guards the output and the counters */
+    pthread_mutex_t lock;
+    size_t num_replicated;
+    size_t num_failed;
+} bulk_replicate_t;
+
+typedef struct bulk_modify {
+    rodsEnv *env;
+    option_flags flags;
+    /** Trust targets having absolute paths to exist */
+    int trust_input;
+    /** The collections and data objects to modify */
+    json_t *targets;
+    /** The metadata to remove and add, or NULL */
+    json_t *remove_avus;
+    json_t *add_avus;
+    /** The permissions to apply, or NULL */
+    json_t *acl;
+    recursive_op recurse;
+    FILE *out;
+    /** Guards the output and the counters */
+    pthread_mutex_t lock;
+    size_t num_modified;
+    size_t num_failed;
+} bulk_modify_t;
+
+typedef struct bulk_chmod {
+    /** The worker connections, opened once for the whole walk and
+        never the connection on which the listing query is open */
+    worker_conns_t workers;
+    json_t *acl;
+    FILE *out;
+    /** A window of paths to modify, all of the same type */
+    char **paths;
+    size_t num_paths;
+    objType_t obj_type;
+    /** The number of paths listed before the window */
+    size_t window_start;
+    /** The number of paths listed, including those skipped */
+    size_t num_walked;
+    /** The number of paths skipped when resuming */
+    size_t offset;
+    /** Guards the output, the counters and the batch states */
+    pthread_mutex_t lock;
+    /** 1 for each batch of the window done, -1 for each that failed */
+    int *batch_done;
+    /** The number of leading batches of the window done */
+    size_t num_done;
+    /** True once a window has failed, so that progress stops */
+    int stalled;
+    size_t num_modified;
+    size_t num_failed;
+} bulk_chmod_t;
+
+static char *join_path(const char *dir, const char *name,
+                       baton_error_t *error) {
+    size_t len = strlen(dir) + strlen(name) + 2;
+    char *path = calloc(len, sizeof (char));
+    if (!path) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        return NULL;
+    }
+
+    int sep = dir[0] != '\0' && !str_ends_with(dir, "/", MAX_STR_LEN);
+    snprintf(path, len, "%s%s%s", dir, sep ? "/" : "", name);
+
+    return path;
+}
+
+// Split a path at its last '/' into new strings
+static int split_path(const char *path, char **dir, char **base,
+                      baton_error_t *error) {
+    const char *slash = strrchr(path, '/');
+    size_t dir_len = !slash ? 0 : (slash == path) ? 1 :
+        (size_t) (slash - path);
+
+    *dir  = strndup(slash ? path : ".", slash ? dir_len : 1);
+    *base = strdup(slash ? slash + 1 : path);
+    if (!*dir || !*base) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+    }
+
+    return error->code;
+}
+
+static int add_entry(bulk_list_t *list, char *name, struct stat *st,
+                     int errnum, baton_error_t *error) {
+    if (list->num_entries == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 256;
+        bulk_entry_t *tmp = realloc(list->entries,
+                                    capacity * sizeof (bulk_entry_t));
+        if (!tmp) {
+            set_baton_error(error, errno,
+                            "Failed to allocate memory: error %d %s",
+                            errno, strerror(errno));
+            free(name);
+            return error->code;
+        }
+
+        list->entries  = tmp;
+        list->capacity = capacity;
+    }
+
+    bulk_entry_t *entry = &list->entries[list->num_entries];
+    entry->name   = name;
+    entry->size   = st ? (size_t) st->st_size : 0;
+    entry->mode   = st ? st->st_mode : 0;
+    entry->errnum = errnum;
+    list->num_entries++;
+
+    return 0;
+}
+
+static int list_directory(bulk_list_t *list, const char *rel_dir,
+                          int recurse, baton_error_t *error) {
+    char *dir_path = NULL;
+    DIR *dir       = NULL;
+
+    dir_path = join_path(list->local_dir, rel_dir, error);
+    if (error->code != 0) goto finally;
+
+    dir = opendir(dir_path);
+    if (!dir) {
+        set_baton_error(error, errno,
+                        "Failed to open directory '%s': error %d %s",
+                        dir_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    struct dirent *ent;
+    while ((ent = readdir(dir))) {
+        if (str_equals(ent->d_name, ".", 2) ||
+            str_equals(ent->d_name, "..", 3)) continue;
+
+        char *name = join_path(rel_dir, ent->d_name, error);
+        if (error->code != 0) goto finally;
+
+        char *path = join_path(list->local_dir, name, error);
+        if (error->code != 0) {
+            free(name);
+            goto finally;
+        }
+
+        // Symbolic links are followed to files, but not to directories
+        struct stat st;
+        if (lstat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+            if (recurse) list_directory(list, name, recurse, error);
+            free(name);
+        }
+        else if (stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+            add_entry(list, name, &st, 0, error);
+        }
+        else {
+            logmsg(WARN, "Skipping '%s' which is not a regular file", path);
+            free(name);
+        }
+
+        free(path);
+        if (error->code != 0) goto finally;
+    }
+
+finally:
+    if (dir)      closedir(dir);
+    if (dir_path) free(dir_path);
+
+    return error->code;
+}
+
+static int list_files(bulk_list_t *list, json_t *files,
+                      baton_error_t *error) {
+    if (!json_is_array(files)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Invalid '%s' attribute: not a JSON array",
+                        JSON_FILES_KEY);
+        goto finally;
+    }
+
+    for (size_t i = 0; i < json_array_size(files); i++) {
+        const char *file = json_string_value(json_array_get(files, i));
+        if (!file || file[0] == '/' || file[0] == '\0') {
+            set_baton_error(error, CAT_INVALID_ARGUMENT,
+                            "Invalid '%s' attribute: element %zu is not "
+                            "a relative file path", JSON_FILES_KEY, i);
+            goto finally;
+        }
+
+        char *name = copy_str(file, MAX_STR_LEN);
+        char *path = join_path(list->local_dir, file, error);
+        if (error->code != 0) {
+            free(name);
+            goto finally;
+        }
+
+        // A file which cannot be put is reported with the others
+        struct stat st;
+        int status = stat(path, &st);
+        add_entry(list, name, status == 0 ? &st : NULL,
+                  status == 0 ? 0 : errno, error);
+        free(path);
+        if (error->code != 0) goto finally;
+    }
+
+finally:
+    return error->code;
+}
+
+static int compare_entries(const void *a, const void *b) {
+    return strcmp(((const bulk_entry_t *) a)->name,
+                  ((const bulk_entry_t *) b)->name);
+}
+
+// Sorted so that the files of each directory are adjacent
+static void sort_list(bulk_list_t *list) {
+    qsort(list->entries, list->num_entries, sizeof (bulk_entry_t),
+          compare_entries);
+}
+
+static void free_list(bulk_list_t *list) {
+    if (list->entries) {
+        for (size_t i = 0; i < list->num_entries; i++) {
+            free(list->entries[i].name);
+        }
+        free(list->entries);
+    }
+}
+
+static void report_file(bulk_put_t *state, bulk_entry_t *entry,
+                        baton_error_t *file_error) {
+    char *obj_path   = NULL;
+    char *local_path = NULL;
+    char *coll       = NULL;
+    char *obj        = NULL;
+    char *dir        = NULL;
+    char *file       = NULL;
+    json_t *record   = NULL;
+    baton_error_t error;
+
+    init_baton_error(&error);
+
+    if (file_error->code != 0) {
+        logmsg(ERROR, "Failed to put '%s': %s", entry->name,
+               file_error->message);
+        state->num_failed++;
+    }
+    else {
+        state->num_put++;
+        state->num_bytes += entry->size;
+    }
+
+    obj_path = join_path(state->coll_path, entry->name, &error);
+    if (error.code != 0) goto finally;
+    local_path = join_path(state->files.local_dir, entry->name, &error);
+    if (error.code != 0) goto finally;
+
+    split_path(obj_path, &coll, &obj, &error);
+    if (error.code != 0) goto finally;
+    split_path(local_path, &dir, &file, &error);
+    if (error.code != 0) goto finally;
+
+    record = json_pack("{s:s, s:s, s:s, s:s, s:I}",
+                       JSON_COLLECTION_KEY,  coll,
+                       JSON_DATA_OBJECT_KEY, obj,
+                       JSON_DIRECTORY_KEY,   dir,
+                       JSON_FILE_KEY,        file,
+                       JSON_SIZE_KEY,        (json_int_t) entry->size);
+    if (!record) {
+        set_baton_error(&error, -1, "Failed to pack the result for '%s'",
+                        obj_path);
+        goto finally;
+    }
+
+    if (file_error->code != 0) add_error_value(record, file_error);
+    print_json_stream(record, state->out);
+
+finally:
+    if (error.code != 0) {
+        logmsg(ERROR, "Failed to report the result for '%s': %s",
+               entry->name, error.message);
+    }
+    if (record)     json_decref(record);
+    if (obj_path)   free(obj_path);
+    if (local_path) free(local_path);
+    if (coll)       free(coll);
+    if (obj)        free(obj);
+    if (dir)        free(dir);
+    if (file)       free(file);
+}
+
+static int put_file(bulk_put_t *state, bulk_entry_t *entry,
+                    baton_error_t *error) {
+    char *obj_path   = NULL;
+    char *local_path = NULL;
+
+    init_baton_error(error);
+
+    obj_path = join_path(state->coll_path, entry->name, error);
+    if (error->code != 0) goto finally;
+    local_path = join_path(state->files.local_dir, entry->name, error);
+    if (error->code != 0) goto finally;
+
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof rods_path);
+    snprintf(rods_path.outPath, MAX_NAME_LEN, "%s", obj_path);
+
+    put_data_obj(state->conn, local_path, &rods_path, NULL, NULL,
+                 state->flags, error);
+
+finally:
+    if (obj_path)   free(obj_path);
+    if (local_path) free(local_path);
+
+    return error->code;
+}
+
+static int send_batch(bulk_put_t *state, baton_error_t *error) {
+    bulkOprInp_t bulk_in;
+    char *obj_path = NULL;
+    int status;
+
+    init_baton_error(error);
+
+    memset(&bulk_in, 0, sizeof bulk_in);
+    snprintf(bulk_in.objPath, MAX_NAME_LEN, "%s", state->coll_path);
+
+    // Always force put over any existing data in order to make puts
+    // idempotent.
+    addKeyVal(&bulk_in.condInput, FORCE_FLAG_KW, "");
+    if (state->flags & VERIFY_CHECKSUM) {
+        addKeyVal(&bulk_in.condInput, VERIFY_CHKSUM_KW, "");
+    }
+    else if (state->flags & CALCULATE_CHECKSUM) {
+        addKeyVal(&bulk_in.condInput, REG_CHKSUM_KW, "");
+    }
+
+    // The attribute columns depend on the checksum keywords, so are
+    // set up after them
+    status = initAttriArrayOfBulkOprInp(&bulk_in);
+    if (status < 0) goto finally;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < state->batch_size; i++) {
+        bulk_entry_t *entry = &state->files.entries[state->batch[i]];
+        offset += entry->size;
+
+        obj_path = join_path(state->coll_path, entry->name, error);
+        if (error->code != 0) goto finally;
+
+        // Each file is located in the buffer by the offset of its end
+        char *checksum = (state->flags & VERIFY_CHECKSUM) ?
+            state->checksums[i] : NULL;
+        status = fillAttriArrayOfBulkOprInp(obj_path, entry->mode, checksum,
+                                            (int) offset, &bulk_in);
+        free(obj_path);
+        obj_path = NULL;
+
+        if (status < 0) goto finally;
+    }
+
+    bytesBuf_t bulk_buf;
+    memset(&bulk_buf, 0, sizeof bulk_buf);
+    bulk_buf.buf = state->buffer;
+    bulk_buf.len = (int) state->buffer_len;
+
+    logmsg(DEBUG, "Sending %zu files (%zu bytes) to '%s'", state->batch_size,
+           state->buffer_len, state->coll_path);
+    status = rcBulkDataObjPut(state->conn, &bulk_in, &bulk_buf);
+
+finally:
+    clearBulkOprInp(&bulk_in);
+
+    if (error->code != 0) return error->code;
+
+    if (status < 0) {
+        // A refused batch, e.g. by a resource which does not support
+        // bulk upload, is put one file at a time
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        logmsg(WARN, "Failed to send %zu files to '%s' in bulk: error %d %s; "
+               "putting them individually", state->batch_size,
+               state->coll_path, status, err_name);
+    }
+
+    for (size_t i = 0; i < state->batch_size; i++) {
+        bulk_entry_t *entry = &state->files.entries[state->batch[i]];
+
+        baton_error_t file_error;
+        init_baton_error(&file_error);
+        if (status < 0) put_file(state, entry, &file_error);
+
+        report_file(state, entry, &file_error);
+    }
+    fflush(state->out);
+
+    state->batch_size = 0;
+    state->buffer_len = 0;
+
+    return error->code;
+}
+
+static int add_to_batch(bulk_put_t *state, size_t index,
+                        baton_error_t *error) {
+    bulk_entry_t *entry = &state->files.entries[index];
+    char *local_path    = NULL;
+    FILE *in            = NULL;
+
+    init_baton_error(error);
+
+    local_path = join_path(state->files.local_dir, entry->name, error);
+    if (error->code != 0) goto finally;
+
+    in = fopen(local_path, "r");
+    if (!in) {
+        set_baton_error(error, errno,
+                        "Failed to open '%s' for reading: error %d %s",
+                        local_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    char *dest = state->buffer + state->buffer_len;
+    size_t nr = fread(dest, 1, entry->size, in);
+    if (nr != entry->size || fgetc(in) != EOF) {
+        set_baton_error(error, -1, "Failed to read '%s': its size changed "
+                        "from %zu bytes", local_path, entry->size);
+        goto finally;
+    }
+
+    if (state->flags & VERIFY_CHECKSUM) {
+        // The hash scheme of the client environment is used, as for
+        // put_data_obj
+        checksum_local_file(local_path, "",
+                            state->checksums[state->batch_size], error);
+        if (error->code != 0) goto finally;
+    }
+
+    state->batch[state->batch_size] = index;
+    state->batch_size++;
+    state->buffer_len += entry->size;
+
+finally:
+    if (in)         fclose(in);
+    if (local_path) free(local_path);
+
+    return error->code;
+}
+
+static int create_parent_collection(rcComm_t *conn, const char *coll_path,
+                                    const char *name, baton_error_t *error) {
+    char *obj_path = NULL;
+    char *coll     = NULL;
+    char *obj      = NULL;
+
+    init_baton_error(error);
+
+    obj_path = join_path(coll_path, name, error);
+    if (error->code != 0) goto finally;
+
+    split_path(obj_path, &coll, &obj, error);
+    if (error->code != 0) goto finally;
+
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof rods_path);
+    snprintf(rods_path.outPath, MAX_NAME_LEN, "%s", coll);
+
+    create_collection(conn, &rods_path, RECURSIVE, error);
+
+finally:
+    if (obj_path) free(obj_path);
+    if (coll)     free(coll);
+    if (obj)      free(obj);
+
+    return error->code;
+}
+
+json_t *bulk_put_files(rcComm_t *conn, rodsPath_t *rods_path,
+                       const char *local_dir, json_t *files, FILE *out,
+                       option_flags flags, baton_error_t *error) {
+    json_t *result = NULL;
+
+    bulk_put_t state;
+    memset(&state, 0, sizeof state);
+    state.conn      = conn;
+    state.coll_path = rods_path->outPath;
+    state.files.local_dir = local_dir;
+    state.out       = out;
+    state.flags     = flags;
+
+    init_baton_error(error);
+
+    if ((flags & VERIFY_CHECKSUM) && (flags & CALCULATE_CHECKSUM)) {
+        set_baton_error(error, USER_INPUT_OPTION_ERR,
+                        "Cannot both verify and update the checksum "
+                        "when putting files into '%s'", state.coll_path);
+        goto finally;
+    }
+
+    if (files) {
+        list_files(&state.files, files, error);
+    }
+    else {
+        list_directory(&state.files, "", flags & RECURSIVE, error);
+    }
+    if (error->code != 0) goto finally;
+
+    sort_list(&state.files);
+
+    state.buffer = calloc(BULK_PUT_BUF_SIZE, sizeof (char));
+    if (!state.buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    create_collection(conn, rods_path, RECURSIVE, error);
+    if (error->code != 0) goto finally;
+
+    // The name of the last file whose collection was created
+    const char *created = NULL;
+    size_t created_len  = 0;
+
+    for (size_t i = 0; i < state.files.num_entries; i++) {
+        bulk_entry_t *entry = &state.files.entries[i];
+
+        baton_error_t file_error;
+        init_baton_error(&file_error);
+
+        const char *slash = strrchr(entry->name, '/');
+        size_t dir_len = slash ? (size_t) (slash - entry->name) : 0;
+
+        if (entry->errnum != 0) {
+            set_baton_error(&file_error, entry->errnum,
+                            "Failed to stat '%s': error %d %s", entry->name,
+                            entry->errnum, strerror(entry->errnum));
+        }
+        else if (!S_ISREG(entry->mode)) {
+            set_baton_error(&file_error, CAT_INVALID_ARGUMENT,
+                            "Cannot put '%s' which is not a regular file",
+                            entry->name);
+        }
+        else if (dir_len > 0 && !(created && created_len == dir_len &&
+                                  strncmp(created, entry->name,
+                                          dir_len) == 0)) {
+            // Each sub-collection is created once, before its first file
+            create_parent_collection(conn, state.coll_path, entry->name,
+                                     &file_error);
+            if (file_error.code == 0) {
+                created     = entry->name;
+                created_len = dir_len;
+            }
+        }
+
+        if (file_error.code == 0 && entry->size > BULK_PUT_MAX_FILE_SIZE) {
+            put_file(&state, entry, &file_error);
+        }
+        else if (file_error.code == 0) {
+            if (state.batch_size == BULK_PUT_MAX_FILES ||
+                state.buffer_len + entry->size > BULK_PUT_BUF_SIZE) {
+                send_batch(&state, error);
+                if (error->code != 0) goto finally;
+            }
+
+            add_to_batch(&state, i, &file_error);
+            if (file_error.code == 0) continue; // Reported when sent
+        }
+
+        report_file(&state, entry, &file_error);
+    }
+
+    if (state.batch_size > 0) {
+        send_batch(&state, error);
+        if (error->code != 0) goto finally;
+    }
+
+    if (state.num_failed > 0) {
+        set_baton_error(error, -1, "Failed to put %zu of %zu files into '%s'",
+                        state.num_failed, state.num_failed + state.num_put,
+                        state.coll_path);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Put %zu files (%zu bytes) into '%s'", state.num_put,
+           state.num_bytes, state.coll_path);
+
+    result = json_pack("{s:I, s:I}",
+                       JSON_COUNT_KEY, (json_int_t) state.num_put,
+                       JSON_SIZE_KEY,  (json_int_t) state.num_bytes);
+    if (!result) {
+        set_baton_error(error, -1, "Failed to pack the bulk put summary "
+                        "of '%s'", state.coll_path);
+    }
+
+finally:
+    free_list(&state.files);
+    if (state.buffer) free(state.buffer);
+
+    return result;
+}
+
+// Report a sync action, while holding the lock
+static void report_sync(bulk_sync_t *sync, const char *name, size_t size,
+                        int local, const char *action,
+                        baton_error_t *file_error) {
+    char *obj_path   = NULL;
+    char *local_path = NULL;
+    char *coll       = NULL;
+    char *obj        = NULL;
+    char *dir        = NULL;
+    char *file       = NULL;
+    json_t *record   = NULL;
+    baton_error_t error;
+
+    init_baton_error(&error);
+
+    if (file_error->code != 0) {
+        logmsg(ERROR, "Failed to %s '%s': %s", action, name,
+               file_error->message);
+        sync->num_failed++;
+    }
+    else if (str_equals(action, JSON_SYNC_PUT, MAX_STR_LEN)) {
+        sync->num_put++;
+    }
+    else if (str_equals(action, JSON_SYNC_SKIP, MAX_STR_LEN)) {
+        sync->num_skipped++;
+    }
+    else {
+        sync->num_removed++;
+    }
+
+    obj_path = join_path(sync->coll_path, name, &error);
+    if (error.code != 0) goto finally;
+    split_path(obj_path, &coll, &obj, &error);
+    if (error.code != 0) goto finally;
+
+    record = json_pack("{s:s, s:s, s:I, s:s}",
+                       JSON_COLLECTION_KEY,  coll,
+                       JSON_DATA_OBJECT_KEY, obj,
+                       JSON_SIZE_KEY,        (json_int_t) size,
+                       JSON_ACTION_KEY,      action);
+    if (!record) {
+        set_baton_error(&error, -1, "Failed to pack the result for '%s'",
+                        obj_path);
+        goto finally;
+    }
+
+    // Data objects which are removed have no local file
+    if (local) {
+        local_path = join_path(sync->files.local_dir, name, &error);
+        if (error.code != 0) goto finally;
+        split_path(local_path, &dir, &file, &error);
+        if (error.code != 0) goto finally;
+
+        json_object_set_new(record, JSON_DIRECTORY_KEY, json_string(dir));
+        json_object_set_new(record, JSON_FILE_KEY, json_string(file));
+    }
+
+    if (file_error->code != 0) add_error_value(record, file_error);
+    print_json_stream(record, sync->out);
+
+finally:
+    if (error.code != 0) {
+        logmsg(ERROR, "Failed to report the result for '%s': %s",
+               name, error.message);
+    }
+    if (record)     json_decref(record);
+    if (obj_path)   free(obj_path);
+    if (local_path) free(local_path);
+    if (coll)       free(coll);
+    if (obj)        free(obj);
+    if (dir)        free(dir);
+    if (file)       free(file);
+}
+
+static const char *sync_file(bulk_sync_t *sync, rcComm_t *conn,
+                             sync_task_t *task, baton_error_t *error) {
+    bulk_entry_t *entry = &sync->files.entries[task->index];
+    const char *action  = JSON_SYNC_PUT;
+    char *obj_path      = NULL;
+    char *local_path    = NULL;
+    FILE *in            = NULL;
+
+    init_baton_error(error);
+
+    obj_path = join_path(sync->coll_path, entry->name, error);
+    if (error->code != 0) goto finally;
+    local_path = join_path(sync->files.local_dir, entry->name, error);
+    if (error->code != 0) goto finally;
+
+    if (task->checksum) {
+        int in_sync = local_checksum_matches(local_path, task->checksum,
+                                             error);
+        if (error->code != 0) goto finally;
+
+        if (in_sync) {
+            logmsg(DEBUG, "Skipping '%s' which is already in sync",
+                   local_path);
+            action = JSON_SYNC_SKIP;
+            goto finally;
+        }
+    }
+
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof rods_path);
+    snprintf(rods_path.outPath, MAX_NAME_LEN, "%s", obj_path);
+
+    if (sync->flags & SINGLE_SERVER) {
+        in = fopen(local_path, "r");
+        if (!in) {
+            set_baton_error(error, errno,
+                            "Failed to open '%s' for reading: error %d %s",
+                            local_path, errno, strerror(errno));
+            goto finally;
+        }
+
+        write_data_obj(conn, in, &rods_path, sync->buffer_size, sync->flags,
+                       error);
+    }
+    else {
+        put_data_obj(conn, local_path, &rods_path, NULL, NULL, sync->flags,
+                     error);
+    }
+
+finally:
+    if (in)         fclose(in);
+    if (obj_path)   free(obj_path);
+    if (local_path) free(local_path);
+
+    return action;
+}
+
+static void sync_task(rcComm_t *conn, size_t index, void *state) {
+    bulk_sync_t *sync   = state;
+    sync_task_t *task   = &sync->tasks[index];
+    bulk_entry_t *entry = &sync->files.entries[task->index];
+
+    baton_error_t file_error;
+    const char *action = sync_file(sync, conn, task, &file_error);
+
+    pthread_mutex_lock(&sync->lock);
+    report_sync(sync, entry->name, entry->size, 1, action, &file_error);
+    pthread_mutex_unlock(&sync->lock);
+}
+
+static size_t row_size(json_t *row) {
+    const char *size = json_string_value(json_object_get(row, JSON_SIZE_KEY));
+
+    return size ? strtoull(size, NULL, 10) : 0;
+}
+
+// Add a listing of data objects to the index, keyed by their paths
+// relative to the collection. Replicas of the same data object, and
+// data objects already in the index, are indexed once.
+static int index_data_objs(bulk_sync_t *sync, json_t *listing,
+                           baton_error_t *error) {
+    const char *coll_path = sync->coll_path;
+
+    size_t prefix_len = strlen(coll_path);
+    while (prefix_len > 0 && coll_path[prefix_len - 1] == '/') prefix_len--;
+
+    for (size_t i = 0; i < json_array_size(listing); i++) {
+        json_t *row = json_array_get(listing, i);
+        const char *coll = get_collection_value(row, error);
+        if (error->code != 0) goto finally;
+        const char *obj =
+            json_string_value(json_object_get(row, JSON_DATA_OBJECT_KEY));
+        if (!obj) continue;
+
+        const char *rel_coll = coll + prefix_len;
+        if (rel_coll[0] == '/') rel_coll++;
+
+        char *name = join_path(rel_coll, obj, error);
+        if (error->code != 0) goto finally;
+
+        if (!json_object_get(sync->remote, name)) {
+            json_object_set(sync->remote, name, row);
+        }
+        json_object_set_new(sync->colls, rel_coll, json_true());
+        free(name);
+    }
+
+finally:
+    return error->code;
+}
+
+static int index_listing_page(json_t *page, void *state,
+                              baton_error_t *error) {
+    return index_data_objs(state, page, error);
+}
+
+json_t *sync_directory(rcComm_t *conn, rodsPath_t *rods_path,
+                       const char *local_dir, FILE *out, option_flags flags,
+                       size_t num_workers, size_t buffer_size,
+                       baton_error_t *error) {
+    json_t *listing = NULL;
+    json_t *result  = NULL;
+    int locked      = 0;
+
+    bulk_sync_t sync;
+    memset(&sync, 0, sizeof sync);
+    sync.coll_path       = rods_path->outPath;
+    sync.out             = out;
+    sync.flags           = flags;
+    sync.buffer_size     = buffer_size;
+    sync.files.local_dir = local_dir;
+
+    init_baton_error(error);
+
+    if ((flags & VERIFY_CHECKSUM) && (flags & CALCULATE_CHECKSUM)) {
+        set_baton_error(error, USER_INPUT_OPTION_ERR,
+                        "Cannot both verify and update the checksum "
+                        "when syncing '%s'", sync.coll_path);
+        goto finally;
+    }
+
+    int status = pthread_mutex_init(&sync.lock, NULL);
+    if (status != 0) {
+        set_baton_error(error, status, "Failed to initialise a lock: "
+                        "error %d %s", status, strerror(status));
+        goto finally;
+    }
+    locked = 1;
+
+    list_directory(&sync.files, "", flags & RECURSIVE, error);
+    if (error->code != 0) goto finally;
+    sort_list(&sync.files);
+
+    create_collection(conn, rods_path, RECURSIVE, error);
+    if (error->code != 0) goto finally;
+
+    listing = list_collection_data_objs(conn, sync.coll_path,
+                                        flags & RECURSIVE, error);
+    if (error->code != 0) goto finally;
+
+    sync.remote = json_object();
+    sync.colls  = json_object();
+    if (!sync.remote || !sync.colls) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON object");
+        goto finally;
+    }
+    json_object_set_new(sync.colls, "", json_true());
+
+    index_data_objs(&sync, listing, error);
+    if (error->code != 0) goto finally;
+
+    // The listing has only data objects with a good replica, whose
+    // checksums may be compared. Any others are still to be removed if
+    // extraneous, so are indexed from a listing of every data object.
+    if (flags & SYNC_DELETE) {
+        walk_collection_data_objs(conn, sync.coll_path, flags & RECURSIVE,
+                                  index_listing_page, &sync, error);
+        if (error->code != 0) goto finally;
+    }
+
+    sync.tasks = calloc(sync.files.num_entries + 1, sizeof (sync_task_t));
+    if (!sync.tasks) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    for (size_t i = 0; i < sync.files.num_entries; i++) {
+        bulk_entry_t *entry  = &sync.files.entries[i];
+        const char *checksum = NULL;
+
+        // Files are compared with data objects of the same size which
+        // have a checksum; any other file is put
+        json_t *row = json_object_get(sync.remote, entry->name);
+        if (row) {
+            if (row_size(row) == entry->size) {
+                checksum = json_string_value(json_object_get(row,
+                                                     JSON_CHECKSUM_KEY));
+                if (checksum && checksum[0] == '\0') checksum = NULL;
+            }
+
+            // Whatever remains is extraneous
+            json_object_del(sync.remote, entry->name);
+        }
+
+        // Sub-collections are created before any file is put, once each
+        char *dir  = NULL;
+        char *file = NULL;
+        split_path(entry->name, &dir, &file, error);
+        if (error->code != 0) goto finally;
+
+        const char *rel_dir = str_equals(dir, ".", 2) ? "" : dir;
+        baton_error_t file_error;
+        init_baton_error(&file_error);
+
+        if (!json_object_get(sync.colls, rel_dir)) {
+            create_parent_collection(conn, sync.coll_path, entry->name,
+                                     &file_error);
+
+            // Collections are created recursively, so its parents now
+            // exist too
+            for (char *slash = strchr(dir, '/'); slash;
+                 slash = strchr(slash + 1, '/')) {
+                *slash = '\0';
+                json_object_set_new(sync.colls, dir, json_true());
+                *slash = '/';
+            }
+            json_object_set_new(sync.colls, rel_dir, json_true());
+        }
+        free(dir);
+        free(file);
+
+        if (file_error.code != 0) {
+            report_sync(&sync, entry->name, entry->size, 1, JSON_SYNC_PUT,
+                        &file_error);
+            continue;
+        }
+
+        sync.tasks[sync.num_tasks].index    = i;
+        sync.tasks[sync.num_tasks].checksum = checksum;
+        sync.num_tasks++;
+    }
+
+    size_t num_used = run_worker_pool(conn, num_workers, sync.num_tasks,
+                                      sync_task, &sync, error);
+    if (error->code != 0) goto finally;
+
+    logmsg(DEBUG, "Synced %zu files to '%s' using %zu workers",
+           sync.num_tasks, sync.coll_path, num_used);
+
+    if (flags & SYNC_DELETE) {
+        const char *name;
+        json_t *row;
+
+        json_object_foreach(sync.remote, name, row) {
+            baton_error_t file_error;
+            init_baton_error(&file_error);
+
+            char *obj_path = join_path(sync.coll_path, name, error);
+            if (error->code != 0) goto finally;
+
+            rodsPath_t obj_rods_path;
+            memset(&obj_rods_path, 0, sizeof obj_rods_path);
+            snprintf(obj_rods_path.outPath, MAX_NAME_LEN, "%s", obj_path);
+            free(obj_path);
+
+            remove_data_object(conn, &obj_rods_path, flags, &file_error);
+            report_sync(&sync, name, row_size(row), 0, JSON_SYNC_REMOVE,
+                        &file_error);
+        }
+    }
+
+    if (sync.num_failed > 0) {
+        set_baton_error(error, -1, "Failed to sync %zu of %zu files with "
+                        "'%s'", sync.num_failed,
+                        sync.num_failed + sync.num_put + sync.num_skipped +
+                        sync.num_removed, sync.coll_path);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Synced '%s' with '%s': %zu put, %zu skipped, "
+           "%zu removed", local_dir, sync.coll_path, sync.num_put,
+           sync.num_skipped, sync.num_removed);
+
+    result = json_pack("{s:I, s:I, s:I}",
+                       JSON_SYNC_PUT,    (json_int_t) sync.num_put,
+                       JSON_SYNC_SKIP,   (json_int_t) sync.num_skipped,
+                       JSON_SYNC_REMOVE, (json_int_t) sync.num_removed);
+    if (!result) {
+        set_baton_error(error, -1, "Failed to pack the sync summary "
+                        "of '%s'", sync.coll_path);
+    }
+
+finally:
+    if (locked)      pthread_mutex_destroy(&sync.lock);
+    if (sync.tasks)  free(sync.tasks);
+    if (listing)     json_decref(listing);
+    if (sync.remote) json_decref(sync.remote);
+    if (sync.colls)  json_decref(sync.colls);
+    free_list(&sync.files);
+
+    return result;
+}
+
+static void replicate_task(rcComm_t *conn, size_t index, void *state) {
+    bulk_replicate_t *repl = state;
+    const char *obj_path   = repl->paths[index];
+    char *coll             = NULL;
+    char *obj              = NULL;
+    json_t *record         = NULL;
+
+    baton_error_t obj_error;
+    replicate_data_obj(conn, obj_path, repl->resource, repl->flags,
+                       &obj_error);
+
+    pthread_mutex_lock(&repl->lock);
+
+    if (obj_error.code != 0) {
+        logmsg(ERROR, "%s", obj_error.message);
+        repl->num_failed++;
+    }
+    else {
+        repl->num_replicated++;
+    }
+
+    baton_error_t error;
+    init_baton_error(&error);
+
+    split_path(obj_path, &coll, &obj, &error);
+    if (error.code != 0) goto finally;
+
+    record = data_object_parts_to_json(coll, obj, &error);
+    if (error.code != 0) goto finally;
+
+    if (obj_error.code != 0) add_error_value(record, &obj_error);
+    print_json_stream(record, repl->out);
+
+finally:
+    if (error.code != 0) {
+        logmsg(ERROR, "Failed to report the result for '%s': %s",
+               obj_path, error.message);
+    }
+    pthread_mutex_unlock(&repl->lock);
+
+    if (record) json_decref(record);
+    if (coll)   free(coll);
+    if (obj)    free(obj);
+}
+
+json_t *replicate_collection(rcComm_t *conn, rodsPath_t *rods_path,
+                             const char *resource, FILE *out,
+                             option_flags flags, size_t num_workers,
+                             baton_error_t *error) {
+    json_t *listing = NULL;
+    json_t *seen    = NULL;
+    json_t *result  = NULL;
+    int locked      = 0;
+
+    bulk_replicate_t repl;
+    memset(&repl, 0, sizeof repl);
+    repl.resource = resource;
+    repl.out      = out;
+    repl.flags    = flags;
+
+    const char *coll_path = rods_path->outPath;
+
+    init_baton_error(error);
+
+    int status = pthread_mutex_init(&repl.lock, NULL);
+    if (status != 0) {
+        set_baton_error(error, status, "Failed to initialise a lock: "
+                        "error %d %s", status, strerror(status));
+        goto finally;
+    }
+    locked = 1;
+
+    listing = list_collection_data_objs(conn, coll_path, flags & RECURSIVE,
+                                        error);
+    if (error->code != 0) goto finally;
+
+    // Each good replica is listed, but each data object is replicated
+    // once
+    seen = json_object();
+    repl.paths = calloc(json_array_size(listing) + 1, sizeof (char *));
+    if (!seen || !repl.paths) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    for (size_t i = 0; i < json_array_size(listing); i++) {
+        char *obj_path = json_to_path(json_array_get(listing, i), error);
+        if (error->code != 0) goto finally;
+
+        if (json_object_get(seen, obj_path)) {
+            free(obj_path);
+            continue;
+        }
+        json_object_set_new(seen, obj_path, json_true());
+        repl.paths[repl.num_paths++] = obj_path;
+    }
+
+    size_t num_used = run_worker_pool(conn, num_workers, repl.num_paths,
+                                      replicate_task, &repl, error);
+    if (error->code != 0) goto finally;
+
+    logmsg(DEBUG, "Replicated %zu data objects in '%s' using %zu workers",
+           repl.num_paths, coll_path, num_used);
+
+    if (repl.num_failed > 0) {
+        set_baton_error(error, -1, "Failed to replicate %zu of %zu data "
+                        "objects in '%s'", repl.num_failed, repl.num_paths,
+                        coll_path);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Replicated %zu data objects in '%s'",
+           repl.num_replicated, coll_path);
+
+    result = json_pack("{s:I}",
+                       JSON_COUNT_KEY, (json_int_t) repl.num_replicated);
+    if (!result) {
+        set_baton_error(error, -1, "Failed to pack the replication summary "
+                        "of '%s'", coll_path);
+    }
+
+finally:
+    if (locked) pthread_mutex_destroy(&repl.lock);
+    if (repl.paths) {
+        for (size_t i = 0; i < repl.num_paths; i++) free(repl.paths[i]);
+        free(repl.paths);
+    }
+    if (listing) json_decref(listing);
+    if (seen)    json_decref(seen);
+
+    return result;
+}
+
+// Set up the path of a target, trusting it to exist if asked to, as
+// for a single target, or resolving it otherwise
+static int set_target_path(rcComm_t *conn, bulk_modify_t *mod,
+                           json_t *target, rodsPath_t *rods_path,
+                           baton_error_t *error) {
+    char *path = json_to_path(target, error);
+    if (error->code != 0) goto finally;
+
+    if (mod->trust_input && str_starts_with(path, "/", 1)) {
+        set_trusted_rods_path(target, rods_path, error);
+    }
+    else {
+        resolve_rods_path(conn, mod->env, rods_path, path, mod->flags, error);
+    }
+
+finally:
+    if (path) free(path);
+
+    return error->code;
+}
+
+static void modify_task(rcComm_t *conn, size_t index, void *state) {
+    bulk_modify_t *mod = state;
+    json_t *target     = json_array_get(mod->targets, index);
+    json_t *record     = NULL;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    baton_error_t target_error;
+    init_baton_error(&target_error);
+
+    if (!json_is_object(target)) {
+        set_baton_error(&target_error, CAT_INVALID_ARGUMENT,
+                        "Bulk target %zu is not a JSON object", index);
+    }
+    else {
+        set_target_path(conn, mod, target, &rods_path, &target_error);
+    }
+
+    if (target_error.code == 0) {
+        if (mod->acl) {
+            apply_json_permissions(conn, &rods_path, mod->recurse, mod->acl,
+                                   &target_error);
+        }
+        else {
+            apply_checked_json_metadata(conn, &rods_path, mod->remove_avus,
+                                        mod->add_avus, &target_error);
+        }
+
+        // A trusted path found missing is reported as if resolved
+        if (mod->trust_input && target_error.code != 0) {
+            set_missing_path_error(&rods_path, &target_error);
+        }
+    }
+
+    pthread_mutex_lock(&mod->lock);
+
+    if (target_error.code != 0) {
+        logmsg(ERROR, "%s", target_error.message);
+        mod->num_failed++;
+    }
+    else {
+        mod->num_modified++;
+    }
+
+    record = json_is_object(target) ? json_deep_copy(target) : json_object();
+    if (!record) {
+        logmsg(ERROR, "Failed to report the result for target %zu", index);
+        goto finally;
+    }
+
+    if (target_error.code != 0) add_error_value(record, &target_error);
+    print_json_stream(record, mod->out);
+
+finally:
+    pthread_mutex_unlock(&mod->lock);
+
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+    if (record) json_decref(record);
+}
+
+static json_t *modify_targets(rcComm_t *conn, bulk_modify_t *mod,
+                              const char *what, size_t num_workers,
+                              baton_error_t *error) {
+    json_t *result = NULL;
+    int locked     = 0;
+
+    if (!json_is_array(mod->targets)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Bulk %s targets are not in a JSON array", what);
+        goto finally;
+    }
+
+    int status = pthread_mutex_init(&mod->lock, NULL);
+    if (status != 0) {
+        set_baton_error(error, status, "Failed to initialise a lock: "
+                        "error %d %s", status, strerror(status));
+        goto finally;
+    }
+    locked = 1;
+
+    size_t num_targets = json_array_size(mod->targets);
+    size_t num_used = run_worker_pool(conn, num_workers, num_targets,
+                                      modify_task, mod, error);
+    if (error->code != 0) goto finally;
+
+    logmsg(DEBUG, "Modified %s on %zu targets using %zu workers",
+           what, num_targets, num_used);
+
+    if (mod->num_failed > 0) {
+        set_baton_error(error, -1, "Failed to modify %s on %zu of %zu "
+                        "targets", what, mod->num_failed, num_targets);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Modified %s on %zu targets", what, mod->num_modified);
+
+    result = json_pack("{s:I}",
+                       JSON_COUNT_KEY, (json_int_t) mod->num_modified);
+    if (!result) {
+        set_baton_error(error, -1, "Failed to pack the %s summary", what);
+    }
+
+finally:
+    if (locked) pthread_mutex_destroy(&mod->lock);
+
+    return result;
+}
+
+json_t *bulk_modify_metadata(rodsEnv *env, rcComm_t *conn, json_t *targets,
+                             json_t *avus, metadata_op operation,
+                             option_flags flags, int trust_input, FILE *out,
+                             size_t num_workers, baton_error_t *error) {
+    json_t *unique = NULL;
+    json_t *result = NULL;
+
+    bulk_modify_t mod;
+    memset(&mod, 0, sizeof mod);
+    mod.env         = env;
+    mod.flags       = flags;
+    mod.trust_input = trust_input;
+    mod.targets     = targets;
+    mod.out         = out;
+
+    init_baton_error(error);
+
+    // The AVUs are checked once, rather than for each target
+    check_json_avus(avus, error);
+    if (error->code != 0) goto finally;
+
+    unique = avu_set_difference(avus, NULL, error);
+    if (error->code != 0) goto finally;
+
+    if (operation == META_ADD) {
+        mod.add_avus = unique;
+    }
+    else {
+        mod.remove_avus = unique;
+    }
+
+    result = modify_targets(conn, &mod, "metadata", num_workers, error);
+
+finally:
+    if (unique) json_decref(unique);
+
+    return result;
+}
+
+json_t *bulk_modify_permissions(rodsEnv *env, rcComm_t *conn, json_t *targets,
+                                json_t *acl, recursive_op recurse,
+                                option_flags flags, int trust_input,
+                                FILE *out, size_t num_workers,
+                                baton_error_t *error) {
+    bulk_modify_t mod;
+    memset(&mod, 0, sizeof mod);
+    mod.env         = env;
+    mod.flags       = flags;
+    mod.trust_input = trust_input;
+    mod.targets     = targets;
+    mod.acl         = acl;
+    mod.recurse     = recurse;
+    mod.out         = out;
+
+    init_baton_error(error);
+
+    if (!json_is_array(acl)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Bulk permissions are not in a JSON array");
+        return NULL;
+    }
+
+    return modify_targets(conn, &mod, "permissions", num_workers, error);
+}
+
+static json_t *make_path_record(bulk_chmod_t *walk, size_t index,
+                                baton_error_t *error) {
+    const char *path = walk->paths[index];
+
+    if (walk->obj_type == COLL_OBJ_T) {
+        return collection_path_to_json(path, error);
+    }
+
+    return data_object_path_to_json(path, error);
+}
+
+static void chmod_task(rcComm_t *conn, size_t index, void *state) {
+    bulk_chmod_t *walk = state;
+    size_t start = index * CHMOD_BATCH_SIZE;
+    size_t end   = start + CHMOD_BATCH_SIZE;
+    if (end > walk->num_paths) end = walk->num_paths;
+
+    size_t num_failed = 0;
+
+    for (size_t i = start; i < end; i++) {
+        rodsPath_t rods_path;
+        memset(&rods_path, 0, sizeof (rodsPath_t));
+        snprintf(rods_path.outPath, MAX_NAME_LEN, "%s", walk->paths[i]);
+        rods_path.objState = EXIST_ST;
+        rods_path.objType  = walk->obj_type;
+
+        baton_error_t path_error;
+        apply_json_permissions(conn, &rods_path, NO_RECURSE, walk->acl,
+                               &path_error);
+        if (path_error.code == 0) continue;
+
+        num_failed++;
+
+        pthread_mutex_lock(&walk->lock);
+
+        baton_error_t error;
+        json_t *record = make_path_record(walk, i, &error);
+        if (record) {
+            add_error_value(record, &path_error);
+            print_json_stream(record, walk->out);
+            json_decref(record);
+        }
+
+        pthread_mutex_unlock(&walk->lock);
+    }
+
+    pthread_mutex_lock(&walk->lock);
+
+    walk->num_failed   += num_failed;
+    walk->num_modified += (end - start) - num_failed;
+    walk->batch_done[index] = num_failed ? -1 : 1;
+
+    // Progress is reported as the number of leading paths done, from
+    // which a later run may resume. A failed batch stops it advancing.
+    size_t num_done = walk->num_done;
+    while (walk->batch_done[walk->num_done] == 1) walk->num_done++;
+
+    if (walk->num_done > num_done && !walk->stalled) {
+        size_t completed = walk->num_done * CHMOD_BATCH_SIZE;
+        if (completed > walk->num_paths) completed = walk->num_paths;
+        completed += walk->window_start;
+
+        json_t *progress = json_pack("{s:{s:I}}", JSON_PROGRESS_KEY,
+                                     JSON_COMPLETED_KEY,
+                                     (json_int_t) completed);
+        if (progress) {
+            print_json_stream(progress, walk->out);
+            json_decref(progress);
+        }
+    }
+
+    pthread_mutex_unlock(&walk->lock);
+}
+
+// Modify the permissions of the paths in the window, then empty it
+static int flush_chmod_window(bulk_chmod_t *walk, baton_error_t *error) {
+    if (walk->num_paths == 0) return error->code;
+
+    size_t num_batches = (walk->num_paths + CHMOD_BATCH_SIZE - 1) /
+        CHMOD_BATCH_SIZE;
+    memset(walk->batch_done, 0, (CHMOD_WINDOW_BATCHES + 1) * sizeof (int));
+    walk->num_done = 0;
+
+    logmsg(DEBUG, "Modifying permissions of %zu paths from %zu in %zu "
+           "batches", walk->num_paths, walk->window_start, num_batches);
+
+    run_worker_conns(&walk->workers, num_batches, chmod_task, walk, error);
+
+    // Progress in later windows cannot pass a failure in this one
+    if (walk->num_done < num_batches) walk->stalled = 1;
+
+    for (size_t i = 0; i < walk->num_paths; i++) free(walk->paths[i]);
+    walk->num_paths = 0;
+
+    return error->code;
+}
+
+static int add_chmod_path(bulk_chmod_t *walk, char *path,
+                          baton_error_t *error) {
+    // Paths done by an earlier run are skipped
+    if (walk->num_walked < walk->offset) {
+        walk->num_walked++;
+        free(path);
+        return error->code;
+    }
+
+    if (walk->num_paths == 0) walk->window_start = walk->num_walked;
+    walk->paths[walk->num_paths++] = path;
+    walk->num_walked++;
+
+    if (walk->num_paths == CHMOD_WINDOW_BATCHES * CHMOD_BATCH_SIZE) {
+        flush_chmod_window(walk, error);
+    }
+
+    return error->code;
+}
+
+static int chmod_listing_page(json_t *page, void *state,
+                              baton_error_t *error) {
+    bulk_chmod_t *walk = state;
+
+    for (size_t i = 0; i < json_array_size(page); i++) {
+        char *path = json_to_path(json_array_get(page, i), error);
+        if (error->code != 0) break;
+
+        add_chmod_path(walk, path, error);
+        if (error->code != 0) break;
+    }
+
+    return error->code;
+}
+
+json_t *chmod_collection(rcComm_t *conn, rodsPath_t *rods_path, json_t *acl,
+                         FILE *out, size_t offset, size_t num_workers,
+                         baton_error_t *error) {
+    json_t *result = NULL;
+    int locked     = 0;
+
+    bulk_chmod_t walk;
+    memset(&walk, 0, sizeof walk);
+    walk.acl    = acl;
+    walk.out    = out;
+    walk.offset = offset;
+
+    const char *coll_path = rods_path->outPath;
+
+    init_baton_error(error);
+
+    // Checked once here, rather than only for each path
+    if (!json_is_array(acl)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Permissions for '%s' are not in a JSON array",
+                        coll_path);
+        goto finally;
+    }
+
+    int status = pthread_mutex_init(&walk.lock, NULL);
+    if (status != 0) {
+        set_baton_error(error, status, "Failed to initialise a lock: "
+                        "error %d %s", status, strerror(status));
+        goto finally;
+    }
+    locked = 1;
+
+    walk.paths = calloc(CHMOD_WINDOW_BATCHES * CHMOD_BATCH_SIZE,
+                        sizeof (char *));
+    walk.batch_done = calloc(CHMOD_WINDOW_BATCHES + 1, sizeof (int));
+    if (!walk.paths || !walk.batch_done) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    // The listing queries stay open on the caller's connection while
+    // each window is modified, so the workers have their own
+    open_worker_conns(&walk.workers, num_workers, error);
+    if (error->code != 0) goto finally;
+
+    logmsg(DEBUG, "Modifying permissions in '%s', skipping the first %zu "
+           "paths", coll_path, offset);
+
+    // The collection itself, then the collections below it, then the
+    // data objects, each in the order they are listed
+    walk.obj_type = COLL_OBJ_T;
+
+    char *path = copy_str(coll_path, MAX_STR_LEN);
+    if (!path) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+    add_chmod_path(&walk, path, error);
+    if (error->code != 0) goto finally;
+
+    walk_sub_collections(conn, coll_path, chmod_listing_page, &walk, error);
+    if (error->code != 0) goto finally;
+
+    flush_chmod_window(&walk, error);
+    if (error->code != 0) goto finally;
+
+    walk.obj_type = DATA_OBJ_T;
+
+    walk_collection_data_objs(conn, coll_path, 1, chmod_listing_page, &walk,
+                              error);
+    if (error->code != 0) goto finally;
+
+    flush_chmod_window(&walk, error);
+    if (error->code != 0) goto finally;
+
+    if (walk.num_failed > 0) {
+        set_baton_error(error, -1, "Failed to modify permissions of %zu of "
+                        "%zu paths in '%s'", walk.num_failed,
+                        walk.num_failed + walk.num_modified, coll_path);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Modified permissions of %zu paths in '%s'",
+           walk.num_modified, coll_path);
+
+    result = json_pack("{s:I}",
+                       JSON_COUNT_KEY, (json_int_t) walk.num_modified);
+    if (!result) {
+        set_baton_error(error, -1, "Failed to pack the permissions summary "
+                        "of '%s'", coll_path);
+    }
+
+finally:
+    close_worker_conns(&walk.workers);
+    if (locked) pthread_mutex_destroy(&walk.lock);
+    if (walk.paths) {
+        for (size_t i = 0; i < walk.num_paths; i++) free(walk.paths[i]);
+        free(walk.paths);
+    }
+    if (walk.batch_done) free(walk.batch_done);
+
+    return result;
+}
@@ -0,0 +1,250 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file bulk.h
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#ifndef _BATON_BULK_H
+#define _BATON_BULK_H
+
+#include <stdio.h>
+
+#include <jansson.h>
+#include <rodsClient.h>
+
+#include "config.h"
+#include "error.h"
+#include "operations.h"
+
+// The largest number of files sent in one bulk upload; the iRODS
+// maximum
+#define BULK_PUT_MAX_FILES 50
+
+// The largest number of bytes sent in one bulk upload
+#define BULK_PUT_BUF_SIZE (10 * 1024 * 1024)
+
+// Files larger than this are put individually
+#define BULK_PUT_MAX_FILE_SIZE (4 * 1024 * 1024)
+
+// The number of paths whose permissions are modified by one task of a
+// recursive chmod
+#define CHMOD_BATCH_SIZE 256
+
+// The number of batches of paths listed and then modified at a time by
+// a recursive chmod, which bounds its memory use
+#define CHMOD_WINDOW_BATCHES 64
+
+/**
+ * Put many local files into a collection, sending small files in
+ * batches using the iRODS bulk upload API. Each batch costs one
+ * request to the server, which creates and registers all of its data
+ * objects (and their checksums, if requested) at once. Larger files
+ * are put individually. If a batch is refused by the server, its files
+ * are put individually instead.
+ *
+ * The files are either those given, or those in the local directory
+ * (and, if recursing, any directory below it). The relative paths of
+ * the files are kept, so that files in sub-directories are put into
+ * sub-collections of the same name, which are created as required.
+ *
+ * As each file is put, a JSON object describing it, with an error
+ * report if it failed, is printed to a stream, one per line.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  rods_path  An iRODS collection path.
+ * @param[in]  local_dir  A local directory path.
+ * @param[in]  files      A JSON array of file paths relative to the
+ *                        local directory. Optional, may be NULL.
+ * @param[in]  out        A file to print to.
+ * @param[in]  flags      RECURSIVE to include the contents of
+ *                        sub-directories, CALCULATE_CHECKSUM or
+ *                        VERIFY_CHECKSUM as for put_data_obj.
+ * @param[out] error      An error report struct.
+ *
+ * @return A new JSON object with the number of files and the total
+ * number of bytes put, which must be freed by the caller.
+ */
+json_t *bulk_put_files(rcComm_t *conn, rodsPath_t *rods_path,
+                       const char *local_dir, json_t *files, FILE *out,
+                       option_flags flags, baton_error_t *error);
+
+/**
+ * Make a collection mirror a local directory. The local files (and,
+ * if recursing, those in any directory below) are compared with the
+ * data objects in the collection (and any collection below), which
+ * are listed with one catalog query rather than one per data object.
+ * A file is put if there is no data object of the same size whose
+ * catalog checksum matches the file's. Missing collections are created
+ * first and the files are then compared and put by a pool of workers,
+ * each having its own connection. Data objects having no local file
+ * may optionally be removed, including those having no good replica,
+ * which are found with a further paged listing. Empty directories are
+ * not mirrored.
+ *
+ * As each file is put or skipped, or data object removed, a JSON
+ * object describing the action, with an error report if it failed, is
+ * printed to a stream, one per line.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  rods_path    An iRODS collection path.
+ * @param[in]  local_dir    A local directory path.
+ * @param[in]  out          A file to print to.
+ * @param[in]  flags        RECURSIVE to include the contents of
+ *                          sub-directories, SYNC_DELETE to remove
+ *                          data objects having no local file,
+ *                          SINGLE_SERVER to write rather than put,
+ *                          CALCULATE_CHECKSUM or VERIFY_CHECKSUM as for
+ *                          put_data_obj.
+ * @param[in]  num_workers  The number of workers putting files.
+ * @param[in]  buffer_size  The number of bytes to write at one time in
+ *                          single-server mode.
+ * @param[out] error        An error report struct.
+ *
+ * @return A new JSON object with the numbers of files put and skipped
+ * and data objects removed, which must be freed by the caller.
+ */
+json_t *sync_directory(rcComm_t *conn, rodsPath_t *rods_path,
+                       const char *local_dir, FILE *out, option_flags flags,
+                       size_t num_workers, size_t buffer_size,
+                       baton_error_t *error);
+
+/**
+ * Replicate the data objects in a collection (and, if recursing, in
+ * any collection below) on the server side. The data objects are
+ * listed with one catalog query (two if recursing) and replicated by a
+ * pool of workers, each having its own connection.
+ *
+ * As each data object is replicated, a JSON object describing it, with
+ * an error report if it failed, is printed to a stream, one per line.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  rods_path    An iRODS collection path.
+ * @param[in]  resource     The resource of the new replicas. Optional,
+ *                          may be NULL.
+ * @param[in]  out          A file to print to.
+ * @param[in]  flags        RECURSIVE to include the contents of
+ *                          sub-collections, otherwise as for
+ *                          replicate_data_obj.
+ * @param[in]  num_workers  The number of workers replicating.
+ * @param[out] error        An error report struct.
+ *
+ * @return A new JSON object with the number of data objects replicated,
+ * which must be freed by the caller.
+ */
+json_t *replicate_collection(rcComm_t *conn, rodsPath_t *rods_path,
+                             const char *resource, FILE *out,
+                             option_flags flags, size_t num_workers,
+                             baton_error_t *error);
+
+/**
+ * Apply one metadata operation with the same AVUs to many collections
+ * and data objects. The AVUs are checked once and each target is
+ * modified with apply_checked_json_metadata, by a pool of workers, each
+ * having its own connection. Each target is resolved by its worker
+ * unless trusting the input, in which case targets having absolute
+ * paths are trusted to exist, so that they are not checked with the
+ * server first. A missing trusted target then fails when its metadata
+ * is modified, with the same error as a missing resolved target.
+ *
+ * As each target is modified, it is printed to a stream, one per line,
+ * with an error report if it failed.
+ *
+ * @param[in]  env          A populated iRODS environment.
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  targets      A JSON array of collections and data objects.
+ * @param[in]  avus         A JSON array of JSON AVUs.
+ * @param[in]  operation    An operation to apply e.g. ADD, REMOVE.
+ * @param[in]  flags        Options for resolving the targets.
+ * @param[in]  trust_input  If true, trust targets to exist.
+ * @param[in]  out          A file to print to.
+ * @param[in]  num_workers  The number of workers modifying metadata.
+ * @param[out] error        An error report struct.
+ *
+ * @return A new JSON object with the number of targets modified, which
+ * must be freed by the caller.
+ */
+json_t *bulk_modify_metadata(rodsEnv *env, rcComm_t *conn, json_t *targets,
+                             json_t *avus, metadata_op operation,
+                             option_flags flags, int trust_input, FILE *out,
+                             size_t num_workers, baton_error_t *error);
+
+/**
+ * Apply the same permissions to many collections and data objects. The
+ * targets are modified with apply_json_permissions by a pool of
+ * workers, as for bulk_modify_metadata, which describes the targets and
+ * the output.
+ *
+ * @param[in]  env          A populated iRODS environment.
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  targets      A JSON array of collections and data objects.
+ * @param[in]  acl          A JSON array of JSON access control objects.
+ * @param[in]  recurse      Recurse into collections, one of RECURSE,
+ *                          NO_RECURSE.
+ * @param[in]  flags        Options for resolving the targets.
+ * @param[in]  trust_input  If true, trust targets to exist.
+ * @param[in]  out          A file to print to.
+ * @param[in]  num_workers  The number of workers modifying permissions.
+ * @param[out] error        An error report struct.
+ *
+ * @return A new JSON object with the number of targets modified, which
+ * must be freed by the caller.
+ */
+json_t *bulk_modify_permissions(rodsEnv *env, rcComm_t *conn, json_t *targets,
+                                json_t *acl, recursive_op recurse,
+                                option_flags flags, int trust_input,
+                                FILE *out, size_t num_workers,
+                                baton_error_t *error);
+
+/**
+ * Modify the permissions of a collection and everything below it, from
+ * the client rather than by one recursive request to the server. The
+ * collections and data objects are listed by paged catalog queries,
+ * including data objects having no good replica. The paths are taken
+ * from the listing a window of CHMOD_WINDOW_BATCHES batches at a time,
+ * so that memory use is bounded however large the collection, and each
+ * window is modified in batches by a pool of workers. The workers'
+ * connections are opened once for the whole walk and are separate
+ * from the caller's, on which the listing queries stay open. Each path
+ * is modified with its own request, so that no one catalog transaction
+ * is large.
+ *
+ * The collection is modified first, then the collections below it,
+ * then the data objects, each in the sorted order of the listing. As
+ * the leading batches are completed, a JSON progress record is printed
+ * to a stream, one per line, giving the number of leading paths done.
+ * A later run on the same, unchanged collection may resume from that
+ * number. A failed batch stops the progress advancing, although later
+ * batches continue. Each path that fails is printed with an error
+ * report.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  rods_path    An iRODS collection path.
+ * @param[in]  acl          A JSON array of JSON access control objects.
+ * @param[in]  out          A file to print to.
+ * @param[in]  offset       The number of leading paths to skip.
+ * @param[in]  num_workers  The number of workers modifying permissions,
+ *                          each having a connection of its own.
+ * @param[out] error        An error report struct.
+ *
+ * @return A new JSON object with the number of paths modified, which
+ * must be freed by the caller.
+ */
+json_t *chmod_collection(rcComm_t *conn, rodsPath_t *rods_path, json_t *acl,
+                         FILE *out, size_t offset, size_t num_workers,
+                         baton_error_t *error);
+
+#endif // _BATON_BULK_H
@@ -0,0 +1,315 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file checksum_cache.c
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+// Workaround for the accidental removal of client-side checksum API
+// from iRODS in iRODS 4.1.x https://github.com/irods/irods/issues/5731
+
+#if IRODS_VERSION_INTEGER <= (4*1000000 + 2*1000 + 9)
+int chksumLocFile( const char *fileName, char *chksumStr, const char* );
+#else
+#include <checksum.h>
+#endif
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "checksum_cache.h"
+#include "log.h"
+#include "utilities.h"
+
+// A file whose modification time is this close to the present may
+// still be being written within the same timestamp granule, so its
+// checksum is not cached.
+#define MIN_CACHE_AGE_NS (2LL * 1000000000LL)
+
+static char *CACHE_DIR = NULL;
+
+static long long mtime_ns(const struct stat *st) {
+    return (long long) st->st_mtim.tv_sec * 1000000000LL +
+        st->st_mtim.tv_nsec;
+}
+
+static int valid_algorithm(const char *algorithm) {
+    size_t len = strnlen(algorithm, MAX_CHECKSUM_LEN);
+    if (len == 0 || len >= MAX_CHECKSUM_LEN) return 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (!isalnum((unsigned char) algorithm[i]) &&
+            algorithm[i] != '-' && algorithm[i] != '_') return 0;
+    }
+
+    return 1;
+}
+
+static char *entry_path(const struct stat *st, const char *algorithm,
+                        baton_error_t *error) {
+    if (!valid_algorithm(algorithm)) {
+        set_baton_error(error, -1, "Invalid checksum algorithm name '%s'",
+                        algorithm);
+        return NULL;
+    }
+
+    const char *format = "%s/%llx-%llx.%s";
+    unsigned long long dev = st->st_dev;
+    unsigned long long ino = st->st_ino;
+
+    int len = snprintf(NULL, 0, format, CACHE_DIR, dev, ino, algorithm);
+    char *path = calloc(len + 1, sizeof (char));
+    if (!path) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        return NULL;
+    }
+    snprintf(path, len + 1, format, CACHE_DIR, dev, ino, algorithm);
+
+    // Algorithm names are case-insensitive
+    for (char *c = path + len - strlen(algorithm); *c; c++) {
+        *c = tolower((unsigned char) *c);
+    }
+
+    return path;
+}
+
+const char *set_checksum_cache_dir(const char *dir) {
+    if (CACHE_DIR) free(CACHE_DIR);
+    CACHE_DIR = NULL;
+
+    if (dir) {
+        struct stat st;
+        if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+            logmsg(ERROR, "Checksum cache '%s' is not a directory", dir);
+            goto finally;
+        }
+
+        CACHE_DIR = copy_str(dir, MAX_STR_LEN);
+        logmsg(DEBUG, "Using local checksum cache '%s'", CACHE_DIR);
+    }
+
+finally:
+    return CACHE_DIR;
+}
+
+const char *get_checksum_cache_dir(void) {
+    return CACHE_DIR;
+}
+
+char *get_cached_checksum(const struct stat *st, const char *algorithm,
+                          baton_error_t *error) {
+    char *path     = NULL;
+    char *checksum = NULL;
+    FILE *in       = NULL;
+
+    init_baton_error(error);
+
+    if (!CACHE_DIR) goto finally;
+
+    path = entry_path(st, algorithm, error);
+    if (error->code != 0) goto finally;
+
+    in = fopen(path, "r");
+    if (!in) {
+        // A missing entry is a cache miss, not an error
+        if (errno != ENOENT) {
+            logmsg(WARN, "Failed to open checksum cache entry '%s': "
+                   "error %d %s", path, errno, strerror(errno));
+        }
+        goto finally;
+    }
+
+    long long size;
+    long long mtime;
+    char value[MAX_CHECKSUM_LEN];
+    if (fscanf(in, "%lld %lld %1023s", &size, &mtime, value) != 3) {
+        logmsg(WARN, "Ignoring malformed checksum cache entry '%s'", path);
+        goto finally;
+    }
+
+    if (size != (long long) st->st_size || mtime != mtime_ns(st)) {
+        logmsg(DEBUG, "Checksum cache entry '%s' is stale", path);
+        goto finally;
+    }
+
+    checksum = copy_str(value, MAX_CHECKSUM_LEN);
+    logmsg(DEBUG, "Checksum cache hit '%s' for '%s'", checksum, path);
+
+finally:
+    if (in)   fclose(in);
+    if (path) free(path);
+
+    return checksum;
+}
+
+int set_cached_checksum(const struct stat *st, const char *algorithm,
+                        const char *checksum, baton_error_t *error) {
+    char *path = NULL;
+    char *tmp  = NULL;
+    FILE *out  = NULL;
+
+    init_baton_error(error);
+
+    if (!CACHE_DIR) goto finally;
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    long long now_ns = (long long) now.tv_sec * 1000000000LL + now.tv_nsec;
+    if (now_ns - mtime_ns(st) < MIN_CACHE_AGE_NS) {
+        logmsg(DEBUG, "Not caching the checksum of a recently "
+               "modified file");
+        goto finally;
+    }
+
+    path = entry_path(st, algorithm, error);
+    if (error->code != 0) goto finally;
+
+    // Write to a temporary file and rename it, so that concurrent
+    // readers never see a partial entry
+    size_t len = strlen(path) + 8;
+    tmp = calloc(len, sizeof (char));
+    if (!tmp) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+    snprintf(tmp, len, "%s.XXXXXX", path);
+
+    int fd = mkstemp(tmp);
+    if (fd < 0) {
+        set_baton_error(error, errno, "Failed to create checksum cache "
+                        "entry '%s': error %d %s", tmp, errno,
+                        strerror(errno));
+        goto finally;
+    }
+
+    out = fdopen(fd, "w");
+    if (!out) {
+        set_baton_error(error, errno, "Failed to open checksum cache "
+                        "entry '%s': error %d %s", tmp, errno,
+                        strerror(errno));
+        close(fd);
+        unlink(tmp);
+        goto finally;
+    }
+
+    fprintf(out, "%lld %lld %s\n", (long long) st->st_size, mtime_ns(st),
+            checksum);
+    int status = fclose(out);
+    out = NULL;
+
+    if (status != 0) {
+        set_baton_error(error, errno, "Failed to write checksum cache "
+                        "entry '%s': error %d %s", tmp, errno,
+                        strerror(errno));
+        unlink(tmp);
+        goto finally;
+    }
+
+    if (rename(tmp, path) != 0) {
+        set_baton_error(error, errno, "Failed to rename checksum cache "
+                        "entry '%s' to '%s': error %d %s", tmp, path, errno,
+                        strerror(errno));
+        unlink(tmp);
+        goto finally;
+    }
+
+    logmsg(DEBUG, "Cached checksum '%s' in '%s'", checksum, path);
+
+finally:
+    if (path) free(path);
+    if (tmp)  free(tmp);
+
+    return error->code;
+}
+
+int same_file_state(const struct stat *st1, const struct stat *st2) {
+    return st1->st_dev  == st2->st_dev  &&
+           st1->st_ino  == st2->st_ino  &&
+           st1->st_size == st2->st_size &&
+           mtime_ns(st1) == mtime_ns(st2);
+}
+
+int checksum_local_file(const char *local_path, const char *scheme,
+                        char chksum[NAME_LEN], baton_error_t *error) {
+    struct stat st_before;
+    struct stat st_after;
+    char *cached = NULL;
+    int status;
+
+    init_baton_error(error);
+
+    // An empty scheme makes chksumLocFile fall back to the client
+    // environment, which we read only to name the cache entry
+    const char *algorithm = scheme;
+    rodsEnv env;
+    if (strnlen(scheme, NAME_LEN) == 0) {
+        algorithm = "default";
+        if (getRodsEnv(&env) >= 0 &&
+            strnlen(env.rodsDefaultHashScheme, NAME_LEN) > 0) {
+            algorithm = env.rodsDefaultHashScheme;
+        }
+    }
+
+    int cacheable = get_checksum_cache_dir() &&
+        stat(local_path, &st_before) == 0;
+
+    if (cacheable) {
+        cached = get_cached_checksum(&st_before, algorithm, error);
+        if (error->code != 0) goto finally;
+
+        if (cached) {
+            snprintf(chksum, NAME_LEN, "%s", cached);
+            logmsg(DEBUG, "Using cached local checksum '%s' for '%s'",
+                   chksum, local_path);
+            goto finally;
+        }
+    }
+
+    status = chksumLocFile(local_path, chksum, scheme);
+    if (status != 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to calculate a local checksum for: '%s' "
+                        "error %d %s", local_path, status, err_name);
+        goto finally;
+    }
+
+    // Only cache the result if the file did not change while it was
+    // being read
+    if (cacheable && stat(local_path, &st_after) == 0 &&
+        same_file_state(&st_before, &st_after)) {
+        baton_error_t cache_error;
+        set_cached_checksum(&st_after, algorithm, chksum, &cache_error);
+        if (cache_error.code != 0) {
+            logmsg(WARN, "Failed to cache the checksum of '%s': %s",
+                   local_path, cache_error.message);
+        }
+    }
+
+finally:
+    if (cached) free(cached);
+
+    return error->code;
+}
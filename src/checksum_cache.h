@@ -0,0 +1,114 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file checksum_cache.h
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#ifndef _BATON_CHECKSUM_CACHE_H
+#define _BATON_CHECKSUM_CACHE_H
+
+#include <sys/stat.h>
+
+#include <rodsClient.h>
+
+#include "config.h"
+#include "error.h"
+
+#define CHECKSUM_ALGORITHM_MD5    "md5"
+#define CHECKSUM_ALGORITHM_SHA256 "sha256"
+
+// The prefix of SHA256 checksums in the iRODS catalog
+#define CHECKSUM_SHA256_PREFIX    "sha2:"
+
+#define MAX_CHECKSUM_LEN 1024
+
+/**
+ * Set the directory used to cache local file checksums. The cache is
+ * disabled by default and may be disabled again by passing NULL.
+ *
+ * Each entry is a small file in the cache directory, named by the
+ * device and inode of the local file and the checksum algorithm, and
+ * containing the file size, modification time (in nanoseconds) and
+ * checksum. An entry is used only if all of these match the current
+ * state of the local file. The cache directory may be cleared at any
+ * time.
+ *
+ * @param[in] dir  A directory path, which must exist.
+ *
+ * @return The directory set, or NULL if the cache is disabled or dir
+ * is not a directory.
+ */
+const char *set_checksum_cache_dir(const char *dir);
+
+/**
+ * Return the directory used to cache local file checksums, or NULL if
+ * the cache is disabled.
+ */
+const char *get_checksum_cache_dir(void);
+
+/**
+ * Look up the cached checksum for a local file.
+ *
+ * @param[in]  st         The stat of the local file.
+ * @param[in]  algorithm  The checksum algorithm name.
+ * @param[out] error      An error report struct.
+ *
+ * @return A new string, which must be freed by the caller, or NULL if
+ * there is no valid entry (or the cache is disabled).
+ */
+char *get_cached_checksum(const struct stat *st, const char *algorithm,
+                          baton_error_t *error);
+
+/**
+ * Add or replace the cached checksum for a local file. Files modified
+ * too recently for their modification time to be trusted are not
+ * cached.
+ *
+ * @param[in]  st         The stat of the local file.
+ * @param[in]  algorithm  The checksum algorithm name.
+ * @param[in]  checksum   The checksum.
+ * @param[out] error      An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int set_cached_checksum(const struct stat *st, const char *algorithm,
+                        const char *checksum, baton_error_t *error);
+
+/**
+ * Return 1 if two stats describe the same, unmodified file, or 0
+ * otherwise.
+ */
+int same_file_state(const struct stat *st1, const struct stat *st2);
+
+/**
+ * Calculate the checksum of a local file in the format used by the
+ * iRODS catalog, consulting the local checksum cache (if enabled)
+ * first and updating it afterwards.
+ *
+ * @param[in]  local_path  A local file path.
+ * @param[in]  scheme      An iRODS hash scheme name e.g. "md5" or
+ *                         "sha256". If empty, the default scheme of the
+ *                         client environment is used.
+ * @param[out] chksum      A buffer to receive the checksum.
+ * @param[out] error       An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int checksum_local_file(const char *local_path, const char *scheme,
+                        char chksum[NAME_LEN], baton_error_t *error);
+
+#endif // _BATON_CHECKSUM_CACHE_H
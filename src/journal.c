@@ -0,0 +1,482 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file journal.c
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "journal.h"
+#include "log.h"
+#include "utilities.h"
+
+// The journal is a text file. The first line is a header containing
+// the journal version and the transfer identity. Each following line
+// records one chunk as "<offset> <length> <md5>".
+#define JOURNAL_HEADER_FORMAT "baton-journal %d %s\n"
+#define JOURNAL_CHUNK_FORMAT  "%zu %zu %s\n"
+
+static char *JOURNAL_DIR = NULL;
+
+static char *join_path(const char *dir, const char *name,
+                       baton_error_t *error) {
+    size_t len = strlen(dir) + strlen(name) + 1;
+    char *path = calloc(len, sizeof (char));
+    if (!path) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        return NULL;
+    }
+    snprintf(path, len, "%s%s", dir, name);
+
+    return path;
+}
+
+// Create a directory, and any missing parents, for the current user
+// alone. An existing directory is used only if the user owns it, as
+// the default may be under a shared $TMPDIR.
+static int make_private_dir(char *dir, baton_error_t *error) {
+    for (char *c = dir + 1; ; c++) {
+        if (*c != '/' && *c != '\0') continue;
+
+        char sep = *c;
+        *c = '\0';
+        int status = mkdir(dir, S_IRWXU);
+        int mkdir_errno = errno;
+        *c = sep;
+
+        if (status != 0 && mkdir_errno != EEXIST) {
+            set_baton_error(error, mkdir_errno,
+                            "Failed to create journal directory '%s': "
+                            "error %d %s", dir, mkdir_errno,
+                            strerror(mkdir_errno));
+            goto finally;
+        }
+        if (sep == '\0') break;
+    }
+
+    struct stat st;
+    if (lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode) ||
+        st.st_uid != geteuid()) {
+        set_baton_error(error, -1,
+                        "Journal directory '%s' is not a directory owned "
+                        "by the current user", dir);
+    }
+
+finally:
+    return error->code;
+}
+
+static char *default_journal_dir(baton_error_t *error) {
+    const char *state_home = getenv("XDG_STATE_HOME");
+    const char *home       = getenv("HOME");
+    const char *tmp        = getenv("TMPDIR");
+    char *dir = NULL;
+
+    if (state_home && str_starts_with(state_home, "/", 1)) {
+        dir = join_path(state_home, "/baton", error);
+    }
+    else if (home && str_starts_with(home, "/", 1)) {
+        dir = join_path(home, "/.local/state/baton", error);
+    }
+    else {
+        char name[64];
+        snprintf(name, sizeof name, "/baton-%lu", (unsigned long) geteuid());
+        dir = join_path(tmp && str_starts_with(tmp, "/", 1) ? tmp : "/tmp",
+                        name, error);
+    }
+    if (error->code != 0) goto error;
+
+    make_private_dir(dir, error);
+    if (error->code != 0) goto error;
+
+    return dir;
+
+error:
+    if (dir) free(dir);
+
+    return NULL;
+}
+
+static void md5_hex(const char *buffer, size_t length, char md5[33],
+                    baton_error_t *error) {
+    unsigned char digest[16];
+
+    EVP_MD_CTX *context = compat_MD5Init(error);
+    if (error->code != 0) return;
+
+    compat_MD5Update(context, (unsigned char *) buffer, length, error);
+    if (error->code != 0) return;
+
+    compat_MD5Final(digest, context, error);
+    if (error->code != 0) return;
+
+    for (int i = 0; i < 16; i++) {
+        snprintf(md5 + i * 2, 3, "%02x", digest[i]);
+    }
+    MD5_FREE(context);
+}
+
+static int add_chunk(transfer_journal_t *journal, size_t offset,
+                     size_t length, const char *md5, baton_error_t *error) {
+    if (journal->num_chunks == journal->capacity) {
+        size_t capacity = journal->capacity ? journal->capacity * 2 : 64;
+        journal_chunk_t *tmp = realloc(journal->chunks,
+                                       capacity * sizeof (journal_chunk_t));
+        if (!tmp) {
+            set_baton_error(error, errno,
+                            "Failed to allocate memory: error %d %s",
+                            errno, strerror(errno));
+            return error->code;
+        }
+
+        journal->chunks   = tmp;
+        journal->capacity = capacity;
+    }
+
+    journal_chunk_t *chunk = &journal->chunks[journal->num_chunks];
+    chunk->offset = offset;
+    chunk->length = length;
+    snprintf(chunk->md5, sizeof chunk->md5, "%s", md5);
+    journal->num_chunks++;
+
+    return 0;
+}
+
+static int load_chunks(transfer_journal_t *journal, FILE *in,
+                       const char *identity, baton_error_t *error) {
+    char *line = NULL;
+    size_t n   = 0;
+    ssize_t len;
+
+    // A journal for a different transfer, or for the same transfer
+    // from a source that has since changed, is ignored
+    if ((len = getline(&line, &n, in)) < 0) goto finally;
+
+    int version;
+    int consumed = 0;
+    if (sscanf(line, "baton-journal %d %n", &version, &consumed) != 1 ||
+        version != JOURNAL_VERSION) {
+        logmsg(WARN, "Ignoring unrecognised journal '%s'", journal->path);
+        goto finally;
+    }
+
+    if (line[len - 1] == '\n') line[len - 1] = '\0';
+    if (!str_equals(line + consumed, identity, MAX_STR_LEN)) {
+        logmsg(NOTICE, "Ignoring journal '%s' of a different transfer",
+               journal->path);
+        goto finally;
+    }
+
+    while (getline(&line, &n, in) >= 0) {
+        size_t offset;
+        size_t length;
+        char md5[33];
+
+        // A partially written final line is expected after a crash
+        if (sscanf(line, "%zu %zu %32s", &offset, &length, md5) != 3 ||
+            strnlen(md5, sizeof md5) != 32) break;
+
+        add_chunk(journal, offset, length, md5, error);
+        if (error->code != 0) goto finally;
+    }
+
+    logmsg(DEBUG, "Loaded %zu chunks from journal '%s'",
+           journal->num_chunks, journal->path);
+
+finally:
+    if (line) free(line);
+
+    return error->code;
+}
+
+static int write_journal(transfer_journal_t *journal, const char *identity,
+                         baton_error_t *error) {
+    if (journal->stream) fclose(journal->stream);
+
+    journal->stream = fopen(journal->path, "w");
+    if (!journal->stream) {
+        set_baton_error(error, errno,
+                        "Failed to open journal '%s' for writing: "
+                        "error %d %s", journal->path, errno, strerror(errno));
+        goto finally;
+    }
+
+    fprintf(journal->stream, JOURNAL_HEADER_FORMAT, JOURNAL_VERSION,
+            identity);
+    for (size_t i = 0; i < journal->num_chunks; i++) {
+        journal_chunk_t *chunk = &journal->chunks[i];
+        fprintf(journal->stream, JOURNAL_CHUNK_FORMAT, chunk->offset,
+                chunk->length, chunk->md5);
+    }
+
+    if (fflush(journal->stream) != 0) {
+        set_baton_error(error, errno,
+                        "Failed to write journal '%s': error %d %s",
+                        journal->path, errno, strerror(errno));
+    }
+
+finally:
+    return error->code;
+}
+
+const char *set_journal_dir(const char *dir) {
+    if (JOURNAL_DIR) free(JOURNAL_DIR);
+    JOURNAL_DIR = NULL;
+
+    if (dir) {
+        struct stat st;
+        if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+            logmsg(ERROR, "Journal directory '%s' is not a directory", dir);
+            goto finally;
+        }
+
+        JOURNAL_DIR = copy_str(dir, MAX_STR_LEN);
+        logmsg(DEBUG, "Using journal directory '%s'", JOURNAL_DIR);
+    }
+
+finally:
+    return JOURNAL_DIR;
+}
+
+const char *get_journal_dir(void) {
+    return JOURNAL_DIR;
+}
+
+// Open the journal at path, taking ownership of path
+static transfer_journal_t *open_journal_file(char *path,
+                                             const char *identity,
+                                             baton_error_t *error) {
+    transfer_journal_t *journal = NULL;
+    FILE *in = NULL;
+
+    if (strchr(identity, '\n')) {
+        set_baton_error(error, -1, "Invalid journal identity '%s'", identity);
+        goto error;
+    }
+
+    journal = calloc(1, sizeof (transfer_journal_t));
+    if (!journal) goto error_alloc;
+
+    journal->path = path;
+    path = NULL;
+
+    journal->identity = copy_str(identity, MAX_STR_LEN);
+
+    in = fopen(journal->path, "r");
+    if (in) {
+        load_chunks(journal, in, identity, error);
+        fclose(in);
+        if (error->code != 0) goto error;
+    }
+    else if (errno != ENOENT) {
+        set_baton_error(error, errno,
+                        "Failed to open journal '%s' for reading: "
+                        "error %d %s", journal->path, errno, strerror(errno));
+        goto error;
+    }
+
+    // Rewriting the journal drops any partial final line
+    write_journal(journal, identity, error);
+    if (error->code != 0) goto error;
+
+    return journal;
+
+error_alloc:
+    set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                    errno, strerror(errno));
+
+error:
+    if (path) free(path);
+    if (journal) close_transfer_journal(journal, 0);
+
+    return NULL;
+}
+
+transfer_journal_t *open_transfer_journal(const char *local_path,
+                                          const char *identity,
+                                          baton_error_t *error) {
+    init_baton_error(error);
+
+    char *path = join_path(local_path, JOURNAL_SUFFIX, error);
+    if (error->code != 0) return NULL;
+
+    return open_journal_file(path, identity, error);
+}
+
+transfer_journal_t *open_put_journal(const struct stat *st,
+                                     const char *identity,
+                                     baton_error_t *error) {
+    char *default_dir = NULL;
+    char *path        = NULL;
+
+    init_baton_error(error);
+
+    const char *dir = JOURNAL_DIR;
+    if (!dir) {
+        default_dir = default_journal_dir(error);
+        if (error->code != 0) goto finally;
+        dir = default_dir;
+    }
+
+    char name[64];
+    snprintf(name, sizeof name, "/%llx-%llx%s",
+             (unsigned long long) st->st_dev,
+             (unsigned long long) st->st_ino, JOURNAL_SUFFIX);
+
+    path = join_path(dir, name, error);
+
+finally:
+    if (default_dir) free(default_dir);
+    if (error->code != 0) return NULL;
+
+    return open_journal_file(path, identity, error);
+}
+
+size_t validate_transfer_journal(transfer_journal_t *journal, FILE *local,
+                                 EVP_MD_CTX *context, size_t buffer_size,
+                                 baton_error_t *error) {
+    char *buffer  = NULL;
+    size_t offset = 0;
+    size_t num_valid = 0;
+
+    init_baton_error(error);
+
+    for (size_t i = 0; i < journal->num_chunks; i++) {
+        if (journal->chunks[i].length > buffer_size) {
+            buffer_size = journal->chunks[i].length;
+        }
+    }
+
+    buffer = calloc(buffer_size + 1, sizeof (char));
+    if (!buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    for (; num_valid < journal->num_chunks; num_valid++) {
+        journal_chunk_t *chunk = &journal->chunks[num_valid];
+        char md5[33];
+
+        if (chunk->offset != offset) {
+            logmsg(WARN, "Journal '%s' chunk at %zu is not contiguous "
+                   "with offset %zu", journal->path, chunk->offset, offset);
+            break;
+        }
+
+        size_t nr = fread(buffer, 1, chunk->length, local);
+        if (nr != chunk->length) {
+            logmsg(NOTICE, "Local file is shorter than journal '%s' records",
+                   journal->path);
+            break;
+        }
+
+        md5_hex(buffer, nr, md5, error);
+        if (error->code != 0) goto finally;
+
+        if (!str_equals_ignore_case(md5, chunk->md5, 32)) {
+            logmsg(WARN, "Journal '%s' chunk at %zu has MD5 %s, "
+                   "but the local file has %s", journal->path, offset,
+                   chunk->md5, md5);
+            break;
+        }
+
+        // The context belongs to the caller, so it is not freed on error
+        // as compat_MD5Update would do
+        if (!EVP_DigestUpdate(context, buffer, nr)) {
+            set_baton_error(error, -1, "Failed to update an MD5 context");
+            goto finally;
+        }
+
+        offset += nr;
+    }
+
+    if (num_valid < journal->num_chunks) {
+        journal->num_chunks = num_valid;
+        write_journal(journal, journal->identity, error);
+        if (error->code != 0) goto finally;
+    }
+
+    if (fseeko(local, offset, SEEK_SET) != 0) {
+        set_baton_error(error, errno,
+                        "Failed to seek to offset %zu: error %d %s",
+                        offset, errno, strerror(errno));
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Validated %zu journalled bytes in %zu chunks",
+           offset, num_valid);
+
+finally:
+    if (buffer) free(buffer);
+
+    return offset;
+}
+
+int reset_transfer_journal(transfer_journal_t *journal, baton_error_t *error) {
+    init_baton_error(error);
+
+    journal->num_chunks = 0;
+
+    return write_journal(journal, journal->identity, error);
+}
+
+int journal_chunk(transfer_journal_t *journal, size_t offset,
+                  const char *buffer, size_t length, baton_error_t *error) {
+    char md5[33];
+
+    init_baton_error(error);
+
+    md5_hex(buffer, length, md5, error);
+    if (error->code != 0) goto finally;
+
+    add_chunk(journal, offset, length, md5, error);
+    if (error->code != 0) goto finally;
+
+    fprintf(journal->stream, JOURNAL_CHUNK_FORMAT, offset, length, md5);
+    if (fflush(journal->stream) != 0) {
+        set_baton_error(error, errno,
+                        "Failed to write journal '%s': error %d %s",
+                        journal->path, errno, strerror(errno));
+    }
+
+finally:
+    return error->code;
+}
+
+void close_transfer_journal(transfer_journal_t *journal, int remove_file) {
+    if (journal->stream) fclose(journal->stream);
+
+    if (remove_file && journal->path) {
+        if (unlink(journal->path) != 0 && errno != ENOENT) {
+            logmsg(WARN, "Failed to remove journal '%s': error %d %s",
+                   journal->path, errno, strerror(errno));
+        }
+    }
+
+    if (journal->path)     free(journal->path);
+    if (journal->identity) free(journal->identity);
+    if (journal->chunks)   free(journal->chunks);
+
+    free(journal);
+}
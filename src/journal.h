@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file journal.h
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#ifndef _BATON_JOURNAL_H
+#define _BATON_JOURNAL_H
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include "config.h"
+#include "compat_checksum.h"
+#include "error.h"
+
+#define JOURNAL_SUFFIX  ".baton-journal"
+#define JOURNAL_VERSION 1
+
+/**
+ *  @struct journal_chunk
+ *  @brief A byte range transferred completely.
+ */
+typedef struct journal_chunk {
+    /** The offset of the first byte */
+    size_t offset;
+    /** The number of bytes */
+    size_t length;
+    /** The MD5 of the bytes */
+    char md5[33];
+} journal_chunk_t;
+
+/**
+ *  @struct transfer_journal
+ *  @brief A file recording the progress of a transfer.
+ */
+typedef struct transfer_journal {
+    /** The path of the journal file */
+    char *path;
+    /** The identity of the transfer */
+    char *identity;
+    /** The journal file, open for appending */
+    FILE *stream;
+    /** The chunks recorded in the journal, in order */
+    journal_chunk_t *chunks;
+    /** The number of chunks recorded */
+    size_t num_chunks;
+    /** The capacity of the chunks array */
+    size_t capacity;
+} transfer_journal_t;
+
+/**
+ * Set the directory in which the journals of puts are kept. By
+ * default, this is "baton" in the user's state directory
+ * ($XDG_STATE_HOME, or ~/.local/state), or "baton-<uid>" in $TMPDIR
+ * (or /tmp) if the user has no home directory. The default is created
+ * when first needed. The default is restored by passing NULL.
+ *
+ * @param[in] dir  A directory path, which must exist.
+ *
+ * @return The directory set, or NULL if the default is restored or
+ * dir is not a directory.
+ */
+const char *set_journal_dir(const char *dir);
+
+/**
+ * Return the directory set for the journals of puts, or NULL if the
+ * default is used.
+ */
+const char *get_journal_dir(void);
+
+/**
+ * Open the journal of a transfer to a local file. The journal is a
+ * sidecar file named by appending JOURNAL_SUFFIX to the local path,
+ * which is known to be writable. If an existing journal describes the
+ * same transfer (its identity matches), its chunks are loaded so that
+ * the transfer may resume. Otherwise the journal is started afresh.
+ *
+ * @param[in]  local_path  The local file path.
+ * @param[in]  identity    A single-line string identifying the transfer
+ *                         and the state of its source.
+ * @param[out] error       An error report struct.
+ *
+ * @return A new journal, which must be closed by the caller.
+ */
+transfer_journal_t *open_transfer_journal(const char *local_path,
+                                          const char *identity,
+                                          baton_error_t *error);
+
+/**
+ * Open the journal of a transfer from a local file, which may be in a
+ * directory that is not writable. The journal is kept in the journal
+ * directory (see set_journal_dir), named by the device and inode of
+ * the local file. It is otherwise as for open_transfer_journal.
+ *
+ * @param[in]  st          The stat of the local file.
+ * @param[in]  identity    A single-line string identifying the transfer
+ *                         and the state of its source.
+ * @param[out] error       An error report struct.
+ *
+ * @return A new journal, which must be closed by the caller.
+ */
+transfer_journal_t *open_put_journal(const struct stat *st,
+                                     const char *identity,
+                                     baton_error_t *error);
+
+/**
+ * Validate the journalled chunks against the local file by re-reading
+ * them. The journal is truncated at the first chunk that does not
+ * match, or which is not contiguous with its predecessor.
+ *
+ * @param[in]  journal      A journal.
+ * @param[in]  local        The local file, positioned at its start. On
+ *                          return it is positioned at the resume offset.
+ * @param[in]  context      An MD5 context to update with the validated
+ *                          bytes.
+ * @param[in]  buffer_size  The number of bytes to read at one time.
+ * @param[out] error        An error report struct.
+ *
+ * @return The offset at which to resume the transfer.
+ */
+size_t validate_transfer_journal(transfer_journal_t *journal, FILE *local,
+                                 EVP_MD_CTX *context, size_t buffer_size,
+                                 baton_error_t *error);
+
+/**
+ * Discard all journalled chunks, so that the transfer restarts from
+ * the beginning.
+ */
+int reset_transfer_journal(transfer_journal_t *journal, baton_error_t *error);
+
+/**
+ * Record a chunk as transferred completely. The journal is flushed
+ * before returning.
+ *
+ * @param[in]  journal  A journal.
+ * @param[in]  offset   The offset of the first byte.
+ * @param[in]  buffer   The bytes.
+ * @param[in]  length   The number of bytes.
+ * @param[out] error    An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int journal_chunk(transfer_journal_t *journal, size_t offset,
+                  const char *buffer, size_t length, baton_error_t *error);
+
+/**
+ * Close a journal, optionally removing its file (when the transfer is
+ * complete), and free it.
+ */
+void close_transfer_journal(transfer_journal_t *journal, int remove_file);
+
+#endif // _BATON_JOURNAL_H
@@ -97,6 +97,24 @@ error:
     return NULL;
 }
 
+static size_t get_size_value(json_t *object, const char *name,
+                             const char *key, baton_error_t *error) {
+    json_t *value = get_json_value(object, name, key, NULL, error);
+    if (error->code != 0) goto error;
+
+    if (!json_is_integer(value) || json_integer_value(value) < 0) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Invalid %s %s: not a non-negative JSON integer",
+                        name, key);
+        goto error;
+    }
+
+    return json_integer_value(value);
+
+error:
+    return 0;
+}
+
 static const char *get_opt_string_value(json_t *object, const char *name,
                                         const char *key, const char *short_key,
                                         baton_error_t *error) {
@@ -580,6 +598,25 @@ error:
     return NULL;
 }
 
+json_t *get_operation_targets(json_t *envelope, baton_error_t *error) {
+    init_baton_error(error);
+
+    json_t *targets = get_json_value(envelope, "operation targets",
+                                     JSON_TARGETS_KEY, NULL, error);
+    if (error->code != 0) goto error;
+    if (!json_is_array(targets)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Invalid '%s' attribute: not a JSON array",
+                        JSON_TARGETS_KEY);
+        goto error;
+    }
+
+    return targets;
+
+error:
+    return NULL;
+}
+
 int has_operation(json_t *object) {
     return has_json_str_value(object, JSON_OP_KEY, JSON_OP_SHORT_KEY);
 }
@@ -597,14 +634,46 @@ int has_operation_target(json_t *envelope) {
     return json_object_get(envelope, JSON_TARGET_KEY) != NULL;
 }
 
+int has_operation_targets(json_t *envelope) {
+    return json_object_get(envelope, JSON_TARGETS_KEY) != NULL;
+}
+
 int has_op_path(json_t *operation_args) {
     return json_object_get(operation_args, JSON_OP_PATH) != NULL;
 }
 
+int has_op_resource(json_t *operation_args) {
+    return json_object_get(operation_args, JSON_OP_RESOURCE) != NULL;
+}
+
+int has_op_encoding(json_t *operation_args) {
+    return json_object_get(operation_args, JSON_OP_ENCODING) != NULL;
+}
+
+int has_op_offset(json_t *operation_args) {
+    return json_object_get(operation_args, JSON_OP_OFFSET) != NULL;
+}
+
+int has_op_length(json_t *operation_args) {
+    return json_object_get(operation_args, JSON_OP_LENGTH) != NULL;
+}
+
+int has_op_resume_from(json_t *operation_args) {
+    return json_object_get(operation_args, JSON_OP_RESUME_FROM) != NULL;
+}
+
+int has_op_threads(json_t *operation_args) {
+    return json_object_get(operation_args, JSON_OP_THREADS) != NULL;
+}
+
 int op_acl_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_ACL));
 }
 
+int op_admin_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_ADMIN));
+}
+
 int op_avu_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_AVU));
 }
@@ -625,6 +694,10 @@ int op_force_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_FORCE));
 }
 
+int op_framed_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_FRAMED));
+}
+
 int op_collection_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_COLLECTION));
 }
@@ -633,6 +706,10 @@ int op_contents_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_CONTENTS));
 }
 
+int op_delete_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_DELETE));
+}
+
 int op_object_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_OBJECT));
 }
@@ -653,6 +730,10 @@ int op_replicate_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_REPLICATE));
 }
 
+int op_resume_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_RESUME));
+}
+
 int op_save_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_SAVE));
 }
@@ -665,10 +746,30 @@ int op_size_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_SIZE));
 }
 
+int op_stream_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_STREAM));
+}
+
+int op_sync_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_SYNC));
+}
+
 int op_timestamp_p(json_t *operation_args) {
     return json_is_true(json_object_get(operation_args, JSON_OP_TIMESTAMP));
 }
 
+int op_inline_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_INLINE));
+}
+
+int op_trust_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_TRUST));
+}
+
+int op_update_p(json_t *operation_args) {
+    return json_is_true(json_object_get(operation_args, JSON_OP_UPDATE));
+}
+
 const char *get_op(json_t *operation_args, baton_error_t *error) {
     init_baton_error(error);
 
@@ -683,6 +784,67 @@ const char *get_op_path(json_t *operation_args, baton_error_t *error) {
                             JSON_OP_PATH, NULL, error);
 }
 
+const char *get_op_resource(json_t *operation_args, baton_error_t *error) {
+    init_baton_error(error);
+
+    return get_string_value(operation_args, "operation resource",
+                            JSON_OP_RESOURCE, NULL, error);
+}
+
+const char *get_op_encoding(json_t *operation_args, baton_error_t *error) {
+    init_baton_error(error);
+
+    return get_string_value(operation_args, "operation encoding",
+                            JSON_OP_ENCODING, NULL, error);
+}
+
+size_t get_op_offset(json_t *operation_args, baton_error_t *error) {
+    init_baton_error(error);
+
+    return get_size_value(operation_args, "operation offset",
+                          JSON_OP_OFFSET, error);
+}
+
+size_t get_op_length(json_t *operation_args, baton_error_t *error) {
+    init_baton_error(error);
+
+    return get_size_value(operation_args, "operation length",
+                          JSON_OP_LENGTH, error);
+}
+
+size_t get_op_resume_from(json_t *operation_args, baton_error_t *error) {
+    init_baton_error(error);
+
+    return get_size_value(operation_args, "operation resume point",
+                          JSON_OP_RESUME_FROM, error);
+}
+
+size_t get_op_threads(json_t *operation_args, baton_error_t *error) {
+    init_baton_error(error);
+
+    return get_size_value(operation_args, "operation threads",
+                          JSON_OP_THREADS, error);
+}
+
+json_t *get_op_steps(json_t *operation_args, baton_error_t *error) {
+    init_baton_error(error);
+
+    json_t *steps = get_json_value(operation_args, "operation steps",
+                                   JSON_OP_STEPS, NULL, error);
+    if (error->code != 0) goto error;
+    if (!json_is_array(steps)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Invalid '%s' attribute: not a JSON array",
+                        JSON_OP_STEPS);
+        goto error;
+    }
+
+    return steps;
+
+error:
+    return NULL;
+}
+
 int has_checksum(json_t *object) {
     baton_error_t error;
 
@@ -692,6 +854,16 @@ int has_checksum(json_t *object) {
                                 NULL, &error) != NULL;
 }
 
+int has_data(json_t *object) {
+    return has_json_str_value(object, JSON_DATA_KEY, NULL);
+}
+
+int has_local_path(json_t *object) {
+    return (has_json_str_value(object, JSON_DIRECTORY_KEY,
+                               JSON_DIRECTORY_SHORT_KEY) ||
+            has_json_str_value(object, JSON_FILE_KEY, NULL));
+}
+
 int has_collection(json_t *object) {
     baton_error_t error;
 
@@ -738,6 +910,100 @@ int contains_avu(json_t *avus, json_t *avu) {
     return has_avu;
 }
 
+// Return a key identifying an AVU by its attribute, value and units
+// (absent units being the same as empty units). The lengths of the
+// attribute and value are included so that the key is unambiguous.
+static char *make_avu_key(json_t *avu, baton_error_t *error) {
+    char *key = NULL;
+
+    const char *attr = get_avu_attribute(avu, error);
+    if (error->code != 0) goto finally;
+
+    const char *value = get_avu_value(avu, error);
+    if (error->code != 0) goto finally;
+
+    const char *units = get_avu_units(avu, error);
+    if (error->code != 0) goto finally;
+    if (!units) units = "";
+
+    size_t attr_len  = strlen(attr);
+    size_t value_len = strlen(value);
+    size_t len = attr_len + value_len + strlen(units) + 48;
+
+    key = calloc(len, sizeof (char));
+    if (!key) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    snprintf(key, len, "%zu:%s%zu:%s%s", attr_len, attr, value_len, value,
+             units);
+
+finally:
+    return key;
+}
+
+json_t *avu_set_difference(json_t *avus, json_t *reference_avus,
+                           baton_error_t *error) {
+    json_t *difference = NULL;
+    json_t *seen       = NULL;
+    char *key          = NULL;
+
+    init_baton_error(error);
+
+    if ((avus && !json_is_array(avus)) ||
+        (reference_avus && !json_is_array(reference_avus))) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Invalid AVUs: not a JSON array");
+        goto error;
+    }
+
+    difference = json_array();
+    seen       = json_object();
+    if (!difference || !seen) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON value");
+        goto error;
+    }
+
+    // The reference AVUs are hashed once, so that each AVU is then
+    // found in constant time, rather than by a scan of the reference
+    for (size_t i = 0; i < json_array_size(reference_avus); i++) {
+        key = make_avu_key(json_array_get(reference_avus, i), error);
+        if (error->code != 0) goto error;
+
+        json_object_set_new(seen, key, json_true());
+        free(key);
+        key = NULL;
+    }
+
+    for (size_t i = 0; i < json_array_size(avus); i++) {
+        json_t *avu = json_array_get(avus, i);
+        key = make_avu_key(avu, error);
+        if (error->code != 0) goto error;
+
+        // Marking the AVU as seen drops any repeat of it
+        if (!json_object_get(seen, key)) {
+            json_object_set_new(seen, key, json_true());
+            json_array_append(difference, avu);
+        }
+
+        free(key);
+        key = NULL;
+    }
+
+    json_decref(seen);
+
+    return difference;
+
+error:
+    if (key)        free(key);
+    if (seen)       json_decref(seen);
+    if (difference) json_decref(difference);
+
+    return NULL;
+}
+
 int represents_collection(json_t *object) {
     return (has_json_str_value(object, JSON_COLLECTION_KEY,
                                JSON_COLLECTION_SHORT_KEY) &&
@@ -1268,6 +1534,39 @@ void print_json(json_t *json) {
     return;
 }
 
+int print_json_escaped(const char *str, size_t len, FILE *stream) {
+    // Escape as jansson does by default; runs of bytes needing no
+    // escape are written unchanged
+    size_t start = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = str[i];
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        size_t n = i - start;
+        if (n > 0 && fwrite(str + start, 1, n, stream) != n) return -1;
+        start = i + 1;
+
+        int status;
+        switch (c) {
+            case '"':  status = fputs("\\\"", stream); break;
+            case '\\': status = fputs("\\\\", stream); break;
+            case '\b': status = fputs("\\b", stream);  break;
+            case '\f': status = fputs("\\f", stream);  break;
+            case '\n': status = fputs("\\n", stream);  break;
+            case '\r': status = fputs("\\r", stream);  break;
+            case '\t': status = fputs("\\t", stream);  break;
+            default:   status = fprintf(stream, "\\u%04X", c); break;
+        }
+        if (status < 0) return -1;
+    }
+
+    size_t n = len - start;
+    if (n > 0 && fwrite(str + start, 1, n, stream) != n) return -1;
+
+    return 0;
+}
+
 int add_error_report(json_t *target, baton_error_t *error) {
     if (error->code != 0) {
         add_error_value(target, error);
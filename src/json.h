@@ -39,17 +39,38 @@
 #define JSON_DIRECTORY_KEY         "directory"
 #define JSON_DIRECTORY_SHORT_KEY   "dir"
 #define JSON_FILE_KEY              "file"
+#define JSON_FILES_KEY             "files"
 #define JSON_COLLECTION_KEY        "collection"
 #define JSON_COLLECTION_SHORT_KEY  "coll"
 #define JSON_DATA_OBJECT_KEY       "data_object"
 #define JSON_DATA_OBJECT_SHORT_KEY "obj"
 #define JSON_DATA_KEY              "data"
+#define JSON_ENCODING_KEY          "encoding"
+
+// Encodings of data
+#define JSON_ENCODING_BASE64       "base64"
 
 #define JSON_CONTENTS_KEY          "contents"
 #define JSON_SIZE_KEY              "size"
 #define JSON_CHECKSUM_KEY          "checksum"
 #define JSON_TIMESTAMPS_KEY        "timestamps"
 #define JSON_TIMESTAMPS_SHORT_KEY  "time"
+#define JSON_SKIPPED_KEY           "skipped"
+#define JSON_COUNT_KEY             "count"
+#define JSON_PROGRESS_KEY          "progress"
+#define JSON_COMPLETED_KEY         "completed"
+
+// Framed raw output
+#define JSON_FRAME_KEY             "frame"
+#define JSON_PATH_KEY              "path"
+#define JSON_OFFSET_KEY            "offset"
+#define JSON_LENGTH_KEY            "length"
+
+// Sync actions
+#define JSON_ACTION_KEY            "action"
+#define JSON_SYNC_PUT              "put"
+#define JSON_SYNC_SKIP             "skip"
+#define JSON_SYNC_REMOVE           "remove"
 
 // Permissions
 #define JSON_ACCESS_KEY            "access"
@@ -65,6 +86,10 @@
 #define JSON_UNITS_KEY             "units"
 #define JSON_UNITS_SHORT_KEY       "u"
 
+// Bulk metadata and permissions targets
+#define JSON_PATHS_KEY             "paths"
+#define JSON_QUERY_KEY             "query"
+
 #define JSON_CREATED_KEY           "created"
 #define JSON_CREATED_SHORT_KEY     "c"
 #define JSON_MODIFIED_KEY          "modified"
@@ -95,6 +120,7 @@
 
 // baton operations
 #define JSON_TARGET_KEY            "target"
+#define JSON_TARGETS_KEY           "targets"
 #define JSON_RESULT_KEY            "result"
 #define JSON_SINGLE_RESULT_KEY     "single"
 #define JSON_MULTIPLE_RESULT_KEY   "multiple"
@@ -107,32 +133,58 @@
 #define JSON_LIST_OP               "list"
 #define JSON_METAMOD_OP            "metamod"
 #define JSON_METAQUERY_OP          "metaquery"
+#define JSON_METASUPER_OP          "metasuper"
 #define JSON_PUT_OP                "put"
 #define JSON_MOVE_OP               "move"
+#define JSON_COPY_OP               "copy"
+#define JSON_REGISTER_OP           "register"
+#define JSON_REPLICATE_OP          "replicate"
 #define JSON_RM_OP                 "remove"
 #define JSON_MKCOLL_OP             "mkdir"
 #define JSON_RMCOLL_OP             "rmdir"
+#define JSON_EXPORT_OP             "export"
+#define JSON_BULK_PUT_OP           "bulkput"
+#define JSON_BULK_METAMOD_OP       "bulkmetamod"
+#define JSON_BULK_CHMOD_OP         "bulkchmod"
+#define JSON_SYNC_OP               "sync"
+#define JSON_SEQUENCE_OP           "sequence"
 
 #define JSON_OP_ARGS_KEY           "arguments"
 #define JSON_OP_ARGS_SHORT_KEY     "args"
 
 #define JSON_OP_ACL                "acl"
+#define JSON_OP_ADMIN              "admin"
 #define JSON_OP_AVU                "avu"
 #define JSON_OP_PRINT_CHECKSUM     "checksum"
 #define JSON_OP_CALCULATE_CHECKSUM "checksum"
 #define JSON_OP_VERIFY_CHECKSUM    "verify"
 #define JSON_OP_FORCE              "force"
+#define JSON_OP_LENGTH             "length"
+#define JSON_OP_OFFSET             "offset"
 #define JSON_OP_COLLECTION         "collection"
 #define JSON_OP_CONTENTS           "contents"
+#define JSON_OP_DELETE             "delete"
+#define JSON_OP_ENCODING           "encoding"
+#define JSON_OP_FRAMED             "framed"
+#define JSON_OP_INLINE             "inline"
 #define JSON_OP_OBJECT             "object"
 #define JSON_OP_OPERATION          "operation"
 #define JSON_OP_RAW                "raw"
 #define JSON_OP_RECURSE            "recurse"
 #define JSON_OP_REPLICATE          "replicate"
+#define JSON_OP_RESOURCE           "resource"
+#define JSON_OP_RESUME             "resume"
+#define JSON_OP_RESUME_FROM        "resume_from"
 #define JSON_OP_SAVE               "save"
 #define JSON_OP_SINGLE_SERVER      "single-server"
 #define JSON_OP_SIZE               "size"
+#define JSON_OP_STEPS              "steps"
+#define JSON_OP_STREAM             "stream"
+#define JSON_OP_SYNC               "sync"
+#define JSON_OP_THREADS            "threads"
 #define JSON_OP_TIMESTAMP          "timestamp"
+#define JSON_OP_TRUST              "trust"
+#define JSON_OP_UPDATE             "update"
 #define JSON_OP_PATH               "path"
 
 #define VALID_REPLICATE   "1"
@@ -251,18 +303,50 @@ json_t *get_operation_args(json_t *envelope, baton_error_t *error);
 
 json_t *get_operation_target(json_t *envelope, baton_error_t *error);
 
+json_t *get_operation_targets(json_t *envelope, baton_error_t *error);
+
 const char *get_op_path(json_t *operation_args, baton_error_t *error);
 
+const char *get_op_resource(json_t *operation_args, baton_error_t *error);
+
+const char *get_op_encoding(json_t *operation_args, baton_error_t *error);
+
+size_t get_op_offset(json_t *operation_args, baton_error_t *error);
+
+size_t get_op_length(json_t *operation_args, baton_error_t *error);
+
+size_t get_op_resume_from(json_t *operation_args, baton_error_t *error);
+
+size_t get_op_threads(json_t *operation_args, baton_error_t *error);
+
+json_t *get_op_steps(json_t *operation_args, baton_error_t *error);
+
 int has_operation(json_t *object);
 
 int has_operation_args(json_t *object);
 
 int has_operation_target(json_t *envelope);
 
+int has_operation_targets(json_t *envelope);
+
 int has_op_path(json_t *operation_args);
 
+int has_op_resource(json_t *operation_args);
+
+int has_op_encoding(json_t *operation_args);
+
+int has_op_offset(json_t *operation_args);
+
+int has_op_length(json_t *operation_args);
+
+int has_op_resume_from(json_t *operation_args);
+
+int has_op_threads(json_t *operation_args);
+
 int op_acl_p(json_t *operation_args);
 
+int op_admin_p(json_t *operation_args);
+
 int op_avu_p(json_t *operation_args);
 
 int op_print_checksum_p(json_t *operation_args);
@@ -273,10 +357,14 @@ int op_verify_checksum_p(json_t *operation_args);
 
 int op_force_p(json_t *operation_args);
 
+int op_framed_p(json_t *operation_args);
+
 int op_collection_p(json_t *operation_args);
 
 int op_contents_p(json_t *operation_args);
 
+int op_delete_p(json_t *operation_args);
+
 int op_object_p(json_t *operation_args);
 
 int op_operation_p(json_t *operation_args);
@@ -287,16 +375,32 @@ int op_recurse_p(json_t *operation_args);
 
 int op_replicate_p(json_t *operation_args);
 
+int op_resume_p(json_t *operation_args);
+
 int op_save_p(json_t *operation_args);
 
 int op_single_server_p(json_t *operation_args);
 
 int op_size_p(json_t *operation_args);
 
+int op_stream_p(json_t *operation_args);
+
+int op_sync_p(json_t *operation_args);
+
 int op_timestamp_p(json_t *operation_args);
 
+int op_inline_p(json_t *operation_args);
+
+int op_trust_p(json_t *operation_args);
+
+int op_update_p(json_t *operation_args);
+
 int has_checksum(json_t *object);
 
+int has_data(json_t *object);
+
+int has_local_path(json_t *object);
+
 int has_collection(json_t *object);
 
 int has_acl(json_t *object);
@@ -309,6 +413,20 @@ int has_modified_timestamp(json_t *object);
 
 int contains_avu(json_t *avus, json_t *avu);
 
+/**
+ * Return the AVUs that are not among some reference AVUs, comparing
+ * only their attributes, values and units. Each AVU occurs at most once
+ * in the result, which is found in time linear in the numbers of AVUs.
+ *
+ * @param[in]  avus            A JSON array of JSON AVUs.
+ * @param[in]  reference_avus  A JSON array of JSON AVUs.
+ * @param[out] error           An error report struct.
+ *
+ * @return A new JSON array of AVUs, which must be freed by the caller.
+ */
+json_t *avu_set_difference(json_t *avus, json_t *reference_avus,
+                           baton_error_t *error);
+
 int represents_collection(json_t *object);
 
 int represents_data_object(json_t *object);
@@ -377,4 +495,16 @@ void print_json_stream(json_t *json, FILE *stream);
 
 void print_json(json_t *json);
 
+/**
+ * Print a UTF-8 string to a stream, escaped for use as the content of
+ * a JSON string (i.e. without the enclosing quotes).
+ *
+ * @param[in]  str     A UTF-8 string, which may contain NUL bytes.
+ * @param[in]  len     The string length in bytes.
+ * @param[in]  stream  The stream.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+int print_json_escaped(const char *str, size_t len, FILE *stream);
+
 #endif // _BATON_JSON_H
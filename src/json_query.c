@@ -20,7 +20,9 @@
  * @author Joshua C. Randall <jcrandall@alum.mit.edu>
  */
 
+#include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <jansson.h>
 
@@ -52,13 +54,14 @@ static int is_zone_hint(const char *path) {
     return is_zone;
 }
 
-static size_t parse_attr_value(int column, const char *label,
-                               const char *input, char *output,
-                               size_t max_len) {
-    size_t size;
+static json_t *parse_attr_value(int column, const char *label,
+                                const char *input, size_t len) {
+    json_t *value = NULL;
 
-    if (maybe_utf8(input, max_len)) {
-        size = snprintf(output, max_len, "%s", input);
+    // Valid UTF-8, the usual case, is packed without copying or
+    // validating it again
+    if (utf8_valid(input, len)) {
+        value = json_stringn_nocheck(input, len);
     }
     else {
         logmsg(WARN,
@@ -66,15 +69,22 @@ static size_t parse_attr_value(int column, const char *label,
                "Attempting to coerce to UTF-8 assuming it is ISO_8859-1",
                column, label, input);
 
-        size = to_utf8(input, output, max_len);
-        if (!maybe_utf8(output, max_len)) {
-            size = 0;
-            logmsg(ERROR, "Failed to coerce column %d '%s' value '%s' "
-                   "to UTF-8", column, label, input);
+        // Transcoding Latin-1 always produces valid UTF-8
+        size_t max_len = len * 2 + 1; // +1 includes NUL
+        char *output = calloc(max_len, sizeof (char));
+        if (!output) {
+            logmsg(ERROR, "Failed to allocate memory: error %d %s",
+                   errno, strerror(errno));
+            goto finally;
         }
+
+        size_t size = to_utf8(input, output, max_len);
+        value = json_stringn_nocheck(output, size);
+        free(output);
     }
 
-    return size;
+finally:
+    return value;
 }
 
 // Map a user-visible access level to the iCAT token
@@ -383,20 +393,43 @@ error:
     return NULL;
 }
 
-json_t *do_query(rcComm_t *conn, genQueryInp_t *query_in,
-                 const char *labels[], baton_error_t *error) {
+// Close a query whose results have not all been fetched, releasing its
+// statement on the server
+static void close_query(rcComm_t *conn, genQueryInp_t *query_in) {
+    genQueryOut_t *query_out = NULL;
+
+    query_in->maxRows = 0;
+
+    int status = rcGenQuery(conn, query_in, &query_out);
+    if (status != 0 && status != CAT_NO_ROWS_FOUND) {
+        logmsg(WARN, "Failed to close a query: error %d", status);
+    }
+
+    if (query_out) free_query_output(query_out);
+}
+
+static int extend_results(json_t *page, void *state, baton_error_t *error) {
+    json_t *results = state;
+
+    int status = json_array_extend(results, page);
+    if (status != 0) {
+        set_baton_error(error, status,
+                        "Failed to add JSON query result to total: "
+                        "error %d", status);
+    }
+
+    return error->code;
+}
+
+int do_paged_query(rcComm_t *conn, genQueryInp_t *query_in,
+                   const char *labels[], query_page_fn page_fn, void *state,
+                   baton_error_t *error) {
     genQueryOut_t *query_out = NULL;
     size_t chunk_num  = 0;
     int continue_flag = 0;
 
     init_baton_error(error);
 
-    json_t *results = json_array();
-    if (!results) {
-        set_baton_error(error, -1, "Failed to allocate a new JSON array");
-        goto error;
-    }
-
     logmsg(DEBUG, "Running query ...");
 
     while (chunk_num == 0 || continue_flag > 0) {
@@ -432,17 +465,18 @@ json_t *do_query(rcComm_t *conn, genQueryInp_t *query_in,
                    chunk_num, json_array_size(chunk));
             chunk_num++;
 
-            status = json_array_extend(results, chunk);
+            free_query_output(query_out);
+            query_out = NULL;
+
+            page_fn(chunk, state, error);
             json_decref(chunk);
 
-            if (status != 0) {
-                set_baton_error(error, status,
-                                "Failed to add JSON query result to total: "
-                                "in chunk %d error %d", chunk_num, status);
-                goto error;
+            if (error->code != 0) {
+                // The caller has reported its own error; the rest of
+                // the results are abandoned
+                if (continue_flag > 0) close_query(conn, query_in);
+                return error->code;
             }
-
-            free_query_output(query_out);
         }
         else if (status == CAT_NO_ROWS_FOUND && chunk_num > 0) {
             // Oddly CAT_NO_ROWS_FOUND is also returned at the end of a
@@ -466,10 +500,9 @@ json_t *do_query(rcComm_t *conn, genQueryInp_t *query_in,
         }
     }
 
-    logmsg(DEBUG, "Obtained a total of %d JSON results in %d chunks",
-           chunk_num, json_array_size(results));
+    logmsg(DEBUG, "Obtained query results in %d chunks", chunk_num);
 
-    return results;
+    return error->code;
 
 error:
     if (conn->rError) {
@@ -481,7 +514,31 @@ error:
     }
 
     if (query_out) free_query_output(query_out);
-    if (results)   json_decref(results);
+
+    return error->code;
+}
+
+json_t *do_query(rcComm_t *conn, genQueryInp_t *query_in,
+                 const char *labels[], baton_error_t *error) {
+    init_baton_error(error);
+
+    json_t *results = json_array();
+    if (!results) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON array");
+        logmsg(ERROR, "%s", error->message);
+        goto error;
+    }
+
+    do_paged_query(conn, query_in, labels, extend_results, results, error);
+    if (error->code != 0) goto error;
+
+    logmsg(DEBUG, "Obtained a total of %d JSON results",
+           json_array_size(results));
+
+    return results;
+
+error:
+    if (results) json_decref(results);
 
     return NULL;
 }
@@ -616,18 +673,13 @@ json_t *make_json_objects(genQueryOut_t *query_out, const char *labels[]) {
 
             // Skip any results which return as an empty string
             // (notably units, when they are absent from an AVU).
-            if (strnlen(result, len) > 0) {
-                size_t vlen = len * 2 + 1; // +1 includes NUL
-                char value[vlen];
-                memset(value, 0, sizeof value);
-
-                if (parse_attr_value(i, labels[i], result, value, vlen) > 0) {
-                    json_t *jvalue = json_pack("s", value);
-                    if (!jvalue) goto error;
+            size_t rlen = strnlen(result, len);
+            if (rlen > 0) {
+                json_t *jvalue = parse_attr_value(i, labels[i], result, rlen);
+                if (!jvalue) goto error;
 
-                    // TODO: check return value
-                    json_object_set_new(jrow, labels[i], jvalue);
-                }
+                // TODO: check return value
+                json_object_set_new(jrow, labels[i], jvalue);
             }
         }
 
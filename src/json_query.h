@@ -116,6 +116,38 @@ json_t *do_specific(rcComm_t *conn, char *zone_name, json_t *query,
 json_t *do_query(rcComm_t *conn, genQueryInp_t *query_in,
                  const char *labels[], baton_error_t *error);
 
+/**
+ * A function passed each page of the results of a general query.
+ *
+ * @param[in]  page   A JSON array of objects, one per result row, which
+ *                    is owned by the query.
+ * @param[in]  state  The caller's state.
+ * @param[out] error  An error report struct, set to stop the query.
+ *
+ * @return The error code.
+ */
+typedef int (*query_page_fn)(json_t *page, void *state, baton_error_t *error);
+
+/**
+ * Execute a general query and pass its results to a function, one page
+ * of at most the query's maximum number of rows at a time, so that
+ * they need not all be held in memory at once. If the function sets an
+ * error, the rest of the results are abandoned.
+ *
+ * @param[in]  conn          An open iRODS connection.
+ * @param[in]  query_in      A populated query input.
+ * @param[in]  labels        An array of as many labels as there were columns
+ *                           selected in the query.
+ * @param[in]  page_fn       The function passed each page.
+ * @param[in]  state         The caller's state, passed to page_fn.
+ * @param[in,out] error      An error report struct.
+ *
+ * @return The error code.
+ */
+int do_paged_query(rcComm_t *conn, genQueryInp_t *query_in,
+                   const char *labels[], query_page_fn page_fn, void *state,
+                   baton_error_t *error);
+
 /**
  * Execute a specific query and obtain results as a JSON array of objects.
  * Columns in the query are mapped to JSON object properties specified
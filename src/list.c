@@ -250,6 +250,76 @@ error:
     return NULL;
 }
 
+json_t *list_size_checksum(rcComm_t *conn, rodsPath_t *rods_path,
+                           baton_error_t *error) {
+    genQueryInp_t *query_in = NULL;
+    json_t *results         = NULL;
+    json_t *result          = NULL;
+
+    init_baton_error(error);
+
+    if (rods_path->objState == NOT_EXIST_ST) {
+        set_baton_error(error, USER_FILE_DOES_NOT_EXIST,
+                        "Path '%s' does not exist "
+                        "(or lacks access permission)", rods_path->outPath);
+        goto error;
+    }
+
+    if (rods_path->objType != DATA_OBJ_T) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Failed to get the size and checksum of '%s' as it "
+                        "is not a data object",  rods_path->outPath);
+        goto error;
+    }
+
+    query_format_in_t obj_format =
+        { .num_columns = 2,
+          .columns     = { COL_DATA_SIZE, COL_D_DATA_CHECKSUM },
+          .labels      = { JSON_SIZE_KEY, JSON_CHECKSUM_KEY } };
+
+    query_in = make_query_input(SEARCH_MAX_ROWS, obj_format.num_columns,
+                                obj_format.columns);
+    query_in = prepare_obj_list(query_in, rods_path, NULL);
+    query_in = limit_to_good_repl(query_in);
+
+    results = do_query(conn, query_in, obj_format.labels, error);
+    if (error->code != 0) goto error;
+
+    if (json_array_size(results) != 1) {
+        set_baton_error(error, -1, "Expected 1 data object result but "
+                        "found %d. This occurs when the object replicates "
+                        "have different sizes or checksum values in the "
+                        "iRODS database", json_array_size(results));
+        goto error;
+    }
+
+    json_t *obj = json_array_get(results, 0);
+    json_t *size = json_object_get(obj, JSON_SIZE_KEY);
+    json_t *checksum = json_object_get(obj, JSON_CHECKSUM_KEY);
+
+    result = json_pack("{s:I, s:O}",
+                       JSON_SIZE_KEY, (json_int_t)
+                       atoll(json_string_value(size)),
+                       JSON_CHECKSUM_KEY,
+                       checksum ? checksum : json_null());
+    if (!result) {
+        set_baton_error(error, -1, "Failed to pack the size and checksum "
+                        "of '%s' as JSON", rods_path->outPath);
+        goto error;
+    }
+
+    free_query_input(query_in);
+    json_decref(results);
+
+    return result;
+
+error:
+    if (query_in) free_query_input(query_in);
+    if (results)  json_decref(results);
+
+    return NULL;
+}
+
 json_t *list_path(rcComm_t *conn, rodsPath_t *rods_path, option_flags flags,
                   baton_error_t *error) {
     json_t *result = NULL;
@@ -699,3 +769,369 @@ error:
 
     return NULL;
 }
+
+static int within_collection(const char *coll, const char *coll_path) {
+    size_t len = strlen(coll_path);
+
+    if (str_equals(coll, coll_path, MAX_STR_LEN)) return 1;
+    if (strncmp(coll, coll_path, len) != 0)       return 0;
+
+    return (len > 0 && coll_path[len - 1] == '/') || coll[len] == '/';
+}
+
+// Return a new LIKE pattern matching the collections below a collection
+static char *make_descendant_pattern(const char *coll_path,
+                                     baton_error_t *error) {
+    size_t len = strlen(coll_path) + 3;
+    char *pattern = calloc(len, sizeof (char));
+    if (!pattern) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        return NULL;
+    }
+    snprintf(pattern, len, "%s%s%%", coll_path,
+             str_ends_with(coll_path, "/", MAX_STR_LEN) ? "" : "/");
+
+    return pattern;
+}
+
+json_t *list_collection_data_objs(rcComm_t *conn, const char *coll_path,
+                                  int recurse, baton_error_t *error) {
+    genQueryInp_t *query_in = NULL;
+    json_t *results         = NULL;
+    json_t *matches         = NULL;
+    char *pattern           = NULL;
+
+    query_format_in_t obj_format =
+        { .num_columns = 5,
+          .columns     = { COL_COLL_NAME, COL_DATA_NAME, COL_DATA_SIZE,
+                           COL_D_DATA_CHECKSUM, COL_D_MODIFY_TIME },
+          .labels      = { JSON_COLLECTION_KEY, JSON_DATA_OBJECT_KEY,
+                           JSON_SIZE_KEY, JSON_CHECKSUM_KEY,
+                           JSON_MODIFIED_KEY } };
+
+    init_baton_error(error);
+
+    results = json_array();
+    if (!results) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON array");
+        goto error;
+    }
+
+    // The data objects in the collection itself, and if recursing,
+    // those in any collection below it
+    pattern = make_descendant_pattern(coll_path, error);
+    if (error->code != 0) goto error;
+
+    query_cond_t conds[2] = {
+        { .column = COL_COLL_NAME, .operator = SEARCH_OP_EQUALS,
+          .value  = coll_path },
+        { .column = COL_COLL_NAME, .operator = SEARCH_OP_LIKE,
+          .value  = pattern } };
+
+    size_t num_queries = recurse ? 2 : 1;
+    for (size_t i = 0; i < num_queries; i++) {
+        query_in = make_query_input(COLL_LISTING_MAX_ROWS, obj_format.num_columns,
+                                    obj_format.columns);
+        query_in = add_query_conds(query_in, 1, &conds[i]);
+        query_in = limit_to_good_repl(query_in);
+
+        matches = do_query(conn, query_in, obj_format.labels, error);
+        if (error->code != 0) goto error;
+
+        // The LIKE pattern may match sibling collections whose names
+        // contain wildcard characters
+        for (size_t j = 0; j < json_array_size(matches); j++) {
+            json_t *row = json_array_get(matches, j);
+            const char *coll = get_collection_value(row, error);
+            if (error->code != 0) goto error;
+
+            if (within_collection(coll, coll_path)) {
+                json_array_append(results, row);
+            }
+        }
+        json_decref(matches);
+        matches = NULL;
+
+        free_query_input(query_in);
+        query_in = NULL;
+    }
+
+    free(pattern);
+
+    return results;
+
+error:
+    if (query_in) free_query_input(query_in);
+    if (matches)  json_decref(matches);
+    if (results)  json_decref(results);
+    if (pattern)  free(pattern);
+
+    return NULL;
+}
+
+/**
+ *  @struct listing_filter
+ *  @brief A page function, passed only the rows within a collection.
+ */
+typedef struct listing_filter {
+    const char *coll_path;
+    query_page_fn page_fn;
+    void *state;
+} listing_filter_t;
+
+// Pass on the rows of a page which are within the collection. The LIKE
+// pattern may match sibling collections whose names contain wildcard
+// characters.
+static int filter_listing_page(json_t *page, void *state,
+                               baton_error_t *error) {
+    listing_filter_t *filter = state;
+
+    json_t *rows = json_array();
+    if (!rows) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON array");
+        goto finally;
+    }
+
+    for (size_t i = 0; i < json_array_size(page); i++) {
+        json_t *row = json_array_get(page, i);
+        const char *coll = get_collection_value(row, error);
+        if (error->code != 0) goto finally;
+
+        if (within_collection(coll, filter->coll_path)) {
+            json_array_append(rows, row);
+        }
+    }
+
+    if (json_array_size(rows) > 0) {
+        filter->page_fn(rows, filter->state, error);
+    }
+
+finally:
+    if (rows) json_decref(rows);
+
+    return error->code;
+}
+
+static int append_listing_page(json_t *page, void *state,
+                               baton_error_t *error) {
+    json_t *results = state;
+
+    if (json_array_extend(results, page) != 0) {
+        set_baton_error(error, -1, "Failed to add a page to the listing");
+    }
+
+    return error->code;
+}
+
+int walk_collection_data_objs(rcComm_t *conn, const char *coll_path,
+                              int recurse, query_page_fn page_fn,
+                              void *state, baton_error_t *error) {
+    genQueryInp_t *query_in = NULL;
+    char *pattern           = NULL;
+
+    // No replica column is selected, so each data object is one row,
+    // whatever the state of its replicas
+    query_format_in_t obj_format =
+        { .num_columns = 2,
+          .columns     = { COL_COLL_NAME, COL_DATA_NAME },
+          .labels      = { JSON_COLLECTION_KEY, JSON_DATA_OBJECT_KEY } };
+
+    listing_filter_t filter = { .coll_path = coll_path,
+                                .page_fn   = page_fn,
+                                .state     = state };
+
+    init_baton_error(error);
+
+    pattern = make_descendant_pattern(coll_path, error);
+    if (error->code != 0) goto finally;
+
+    query_cond_t conds[2] = {
+        { .column = COL_COLL_NAME, .operator = SEARCH_OP_EQUALS,
+          .value  = coll_path },
+        { .column = COL_COLL_NAME, .operator = SEARCH_OP_LIKE,
+          .value  = pattern } };
+
+    size_t num_queries = recurse ? 2 : 1;
+    for (size_t i = 0; i < num_queries; i++) {
+        query_in = make_query_input(COLL_LISTING_MAX_ROWS,
+                                    obj_format.num_columns,
+                                    obj_format.columns);
+        query_in = add_query_conds(query_in, 1, &conds[i]);
+        query_in = add_select_modifier(query_in, COL_COLL_NAME, ORDER_BY);
+        query_in = add_select_modifier(query_in, COL_DATA_NAME, ORDER_BY);
+
+        do_paged_query(conn, query_in, obj_format.labels,
+                       filter_listing_page, &filter, error);
+        if (error->code != 0) goto finally;
+
+        free_query_input(query_in);
+        query_in = NULL;
+    }
+
+finally:
+    if (query_in) free_query_input(query_in);
+    if (pattern)  free(pattern);
+
+    return error->code;
+}
+
+int walk_sub_collections(rcComm_t *conn, const char *coll_path,
+                         query_page_fn page_fn, void *state,
+                         baton_error_t *error) {
+    genQueryInp_t *query_in = NULL;
+    char *pattern           = NULL;
+
+    query_format_in_t coll_format =
+        { .num_columns = 1,
+          .columns     = { COL_COLL_NAME },
+          .labels      = { JSON_COLLECTION_KEY } };
+
+    listing_filter_t filter = { .coll_path = coll_path,
+                                .page_fn   = page_fn,
+                                .state     = state };
+
+    init_baton_error(error);
+
+    pattern = make_descendant_pattern(coll_path, error);
+    if (error->code != 0) goto finally;
+
+    query_cond_t cond = { .column = COL_COLL_NAME,
+                          .operator = SEARCH_OP_LIKE,
+                          .value  = pattern };
+
+    query_in = make_query_input(COLL_LISTING_MAX_ROWS, coll_format.num_columns,
+                                coll_format.columns);
+    query_in = add_query_conds(query_in, 1, &cond);
+    query_in = add_select_modifier(query_in, COL_COLL_NAME, ORDER_BY);
+
+    do_paged_query(conn, query_in, coll_format.labels, filter_listing_page,
+                   &filter, error);
+
+finally:
+    if (query_in) free_query_input(query_in);
+    if (pattern)  free(pattern);
+
+    return error->code;
+}
+
+json_t *list_sub_collections(rcComm_t *conn, const char *coll_path,
+                             baton_error_t *error) {
+    init_baton_error(error);
+
+    json_t *results = json_array();
+    if (!results) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON array");
+        goto error;
+    }
+
+    walk_sub_collections(conn, coll_path, append_listing_page, results,
+                         error);
+    if (error->code != 0) goto error;
+
+    return results;
+
+error:
+    if (results) json_decref(results);
+
+    return NULL;
+}
+
+json_t *list_data_objs_by_name(rcComm_t *conn, const char *coll_path,
+                               json_t *data_names, baton_error_t *error) {
+    genQueryInp_t *query_in = NULL;
+    json_t *results         = NULL;
+    json_t *matches         = NULL;
+    char *in_clause         = NULL;
+
+    query_format_in_t obj_format =
+        { .num_columns = 4,
+          .columns     = { COL_COLL_NAME, COL_DATA_NAME, COL_DATA_SIZE,
+                           COL_D_DATA_CHECKSUM },
+          .labels      = { JSON_COLLECTION_KEY, JSON_DATA_OBJECT_KEY,
+                           JSON_SIZE_KEY, JSON_CHECKSUM_KEY } };
+
+    init_baton_error(error);
+
+    results = json_array();
+    if (!results) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON array");
+        goto error;
+    }
+
+    size_t max_len = NAME_IN_CLAUSE_MAX_LEN;
+    in_clause = calloc(max_len + 1, sizeof (char));
+    if (!in_clause) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto error;
+    }
+
+    // Each query has as many names in its IN clause as will fit
+    size_t num_names = json_array_size(data_names);
+    size_t i = 0;
+    while (i < num_names) {
+        size_t len    = snprintf(in_clause, max_len + 1, "(");
+        size_t num_in = 0;
+
+        for (; i < num_names; i++) {
+            const char *name = json_string_value(json_array_get(data_names, i));
+            if (!name || strchr(name, '\'')) {
+                set_baton_error(error, CAT_INVALID_ARGUMENT,
+                                "Invalid data object name at position %zu "
+                                "to list by name", i);
+                goto error;
+            }
+
+            // The name, its quotes, a separator and the closing paren
+            if (len + strlen(name) + 5 > max_len) break;
+
+            len += snprintf(in_clause + len, max_len + 1 - len, "%s'%s'",
+                            num_in > 0 ? ", " : "", name);
+            num_in++;
+        }
+
+        if (num_in == 0) {
+            set_baton_error(error, CAT_INVALID_ARGUMENT,
+                            "Data object name at position %zu is too long "
+                            "to list by name", i);
+            goto error;
+        }
+
+        snprintf(in_clause + len, max_len + 1 - len, ")");
+
+        query_cond_t conds[2] = {
+            { .column = COL_COLL_NAME, .operator = SEARCH_OP_EQUALS,
+              .value  = coll_path },
+            { .column = COL_DATA_NAME, .operator = SEARCH_OP_IN,
+              .value  = in_clause } };
+
+        query_in = make_query_input(COLL_LISTING_MAX_ROWS,
+                                    obj_format.num_columns,
+                                    obj_format.columns);
+        query_in = add_query_conds(query_in, 2, conds);
+        query_in = limit_to_good_repl(query_in);
+
+        matches = do_query(conn, query_in, obj_format.labels, error);
+        if (error->code != 0) goto error;
+
+        json_array_extend(results, matches);
+        json_decref(matches);
+        matches = NULL;
+
+        free_query_input(query_in);
+        query_in = NULL;
+    }
+
+    free(in_clause);
+
+    return results;
+
+error:
+    if (query_in)  free_query_input(query_in);
+    if (matches)   json_decref(matches);
+    if (results)   json_decref(results);
+    if (in_clause) free(in_clause);
+
+    return NULL;
+}
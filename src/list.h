@@ -33,9 +33,33 @@
 #include "operations.h"
 #include "query.h"
 
+// The number of rows fetched in each chunk of a collection listing
+// query; the iRODS maximum
+#define COLL_LISTING_MAX_ROWS 256
+
+// The largest number of characters in the IN clause of a query listing
+// data objects by name, which keeps the query well within the server's
+// limit on its length
+#define NAME_IN_CLAUSE_MAX_LEN 2048
+
 json_t *list_checksum(rcComm_t *conn, rodsPath_t *rods_path,
                       baton_error_t *error);
 
+/**
+ * Return the size and checksum of a resolved iRODS data object, as
+ * recorded in the catalog for its good replicates, as a JSON object
+ * with "size" and "checksum" properties. The checksum may be JSON
+ * null.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  rodspath     An iRODS path.
+ * @param[out] error        An error report struct.
+ *
+ * @return A new struct, which must be freed by the caller.
+ */
+json_t *list_size_checksum(rcComm_t *conn, rodsPath_t *rods_path,
+                           baton_error_t *error);
+
 /**
  * Return a JSON representation of the content of a resolved iRODS
  * path (data object or collection). In the case of a data object,
@@ -110,4 +134,99 @@ json_t *list_timestamps(rcComm_t *conn, rodsPath_t *rods_path,
 json_t *list_metadata(rcComm_t *conn, rodsPath_t *rods_path, char *attr_name,
                       baton_error_t *error);
 
+/**
+ * List the good replicas of the data objects in a collection and,
+ * optionally, in any collection below it. The data objects are found
+ * with one catalog query (two if recursing), rather than one query per
+ * data object.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  coll_path  An iRODS collection path.
+ * @param[in]  recurse    If true, include the data objects in any
+ *                        collection below.
+ * @param[out] error      An error report struct.
+ *
+ * @return A new JSON array of objects, one per replica, having
+ * collection, data object, size, checksum and modification time
+ * properties, which must be freed by the caller.
+ */
+json_t *list_collection_data_objs(rcComm_t *conn, const char *coll_path,
+                                  int recurse, baton_error_t *error);
+
+/**
+ * List the collections below a collection, at any depth, with one
+ * catalog query.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  coll_path  An iRODS collection path.
+ * @param[out] error      An error report struct.
+ *
+ * @return A new JSON array of objects having a collection property,
+ * which must be freed by the caller.
+ */
+json_t *list_sub_collections(rcComm_t *conn, const char *coll_path,
+                             baton_error_t *error);
+
+/**
+ * Pass the data objects in a collection and, optionally, in any
+ * collection below it to a function, one page at a time, so that the
+ * listing need not be held in memory at once. Unlike
+ * list_collection_data_objs, each data object is listed once, whatever
+ * the state of its replicas, so that those without a good replica are
+ * included. The data objects in the collection itself are passed first,
+ * then the others, each sorted by collection and name.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  coll_path  An iRODS collection path.
+ * @param[in]  recurse    If true, include the data objects in any
+ *                        collection below.
+ * @param[in]  page_fn    The function passed each page, a JSON array of
+ *                        objects having collection and data object
+ *                        properties.
+ * @param[in]  state      The caller's state, passed to page_fn.
+ * @param[out] error      An error report struct.
+ *
+ * @return The error code.
+ */
+int walk_collection_data_objs(rcComm_t *conn, const char *coll_path,
+                              int recurse, query_page_fn page_fn,
+                              void *state, baton_error_t *error);
+
+/**
+ * Pass the collections below a collection, at any depth, to a function,
+ * one page at a time, sorted by name.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  coll_path  An iRODS collection path.
+ * @param[in]  page_fn    The function passed each page, a JSON array of
+ *                        objects having a collection property.
+ * @param[in]  state      The caller's state, passed to page_fn.
+ * @param[out] error      An error report struct.
+ *
+ * @return The error code.
+ */
+int walk_sub_collections(rcComm_t *conn, const char *coll_path,
+                         query_page_fn page_fn, void *state,
+                         baton_error_t *error);
+
+/**
+ * List the good replicas of the named data objects in a collection,
+ * with their sizes and checksums. The names are given in the IN
+ * clauses of as few catalog queries as their length allows, rather
+ * than with one query per data object. Names having no data object
+ * are not listed.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  coll_path   An iRODS collection path.
+ * @param[in]  data_names  A JSON array of data object names, which may
+ *                         not contain single quotes.
+ * @param[out] error       An error report struct.
+ *
+ * @return A new JSON array of objects, one per replica, having
+ * collection, data object, size and (if any) checksum properties,
+ * which must be freed by the caller.
+ */
+json_t *list_data_objs_by_name(rcComm_t *conn, const char *coll_path,
+                               json_t *data_names, baton_error_t *error);
+
 #endif // _BATON_LIST_H
@@ -19,12 +19,19 @@
  * @author Keith James <kdj@sanger.ac.uk>, Rob Davies <rmd@sanger.ac.uk>
  */
 
+#include <stdint.h>
+
 #include "config.h"
 #include "time.h"
 
 #include "baton.h"
 #include "operations.h"
 
+// The JSON string value which stands in for streamed data object
+// contents when serialising a result; the control characters make a
+// clash with a genuine value unlikely
+#define STREAM_PLACEHOLDER "\001baton-stream-contents\001"
+
 // Mutex protecting the connection and the run_timeout_thread flag
 pthread_mutex_t conn_mutex = PTHREAD_MUTEX_INITIALIZER;
 // The connection used by iterate_json and connection_timeout
@@ -65,6 +72,269 @@ void *connection_timeout(void *timeout) {
     return 0;
 }
 
+// Return true if an item is an envelope listing a data object with, at
+// most, its size and checksum. Consecutive items of this kind are
+// read-only and may be answered together.
+static int lookahead_item_p(json_t *item, option_flags *flags) {
+    baton_error_t error;
+
+    const char *op = get_operation(item, &error);
+    if (error.code != 0 || !op) return 0;
+    if (!str_equals(op, JSON_LIST_OP, MAX_STR_LEN)) return 0;
+    if (has_operation_targets(item)) return 0;
+
+    json_t *target = json_object_get(item, JSON_TARGET_KEY);
+    json_t *coll   = json_object_get(target, JSON_COLLECTION_KEY);
+    json_t *name   = json_object_get(target, JSON_DATA_OBJECT_KEY);
+    if (!json_is_string(coll) || !json_is_string(name)) return 0;
+
+    const char *coll_path = json_string_value(coll);
+    const char *data_name = json_string_value(name);
+    if (!str_starts_with(coll_path, "/", 1))  return 0;
+    if (strchr(coll_path, '\'') || strchr(data_name, '\'')) return 0;
+    if (strchr(data_name, '/')) return 0;
+
+    *flags = 0;
+    if (has_operation_args(item)) {
+        json_t *args = get_operation_args(item, &error);
+        if (error.code != 0) return 0;
+
+        const char *key;
+        json_t *value;
+        json_object_foreach(args, key, value) {
+            if (!str_equals(key, JSON_OP_SIZE, MAX_STR_LEN) &&
+                !str_equals(key, JSON_OP_PRINT_CHECKSUM, MAX_STR_LEN)) {
+                return 0;
+            }
+        }
+
+        if (op_size_p(args))           *flags = *flags | PRINT_SIZE;
+        if (op_print_checksum_p(args)) *flags = *flags | PRINT_CHECKSUM;
+    }
+
+    return 1;
+}
+
+// Answer the data object listings of a window of items with one catalog
+// query per collection (or a few, for many data objects), rather than
+// several per item. Items are answered only where the query found
+// exactly one good replica, so that any others may be run in the usual
+// way, which reports errors and inconsistent replicas as before.
+static void answer_lookahead(rcComm_t *conn, json_t **items, size_t num_items,
+                             json_t **results) {
+    json_t *names = json_object();
+    json_t *found = json_object();
+    if (!names || !found) goto finally;
+
+    for (size_t i = 0; i < num_items; i++) {
+        json_t *target = json_object_get(items[i], JSON_TARGET_KEY);
+        const char *coll =
+            json_string_value(json_object_get(target, JSON_COLLECTION_KEY));
+        json_t *name = json_object_get(target, JSON_DATA_OBJECT_KEY);
+
+        json_t *coll_names = json_object_get(names, coll);
+        if (!coll_names) {
+            coll_names = json_array();
+            json_object_set_new(names, coll, coll_names);
+        }
+        json_array_append(coll_names, name);
+    }
+
+    const char *coll_path;
+    json_t *coll_names;
+    json_object_foreach(names, coll_path, coll_names) {
+        baton_error_t error;
+        json_t *rows = list_data_objs_by_name(conn, coll_path, coll_names,
+                                              &error);
+        if (error.code != 0) {
+            logmsg(WARN, "Failed to list %zu data objects in '%s' together; "
+                   "listing them individually: %s",
+                   json_array_size(coll_names), coll_path, error.message);
+            continue;
+        }
+
+        json_t *coll_found = json_object();
+        json_object_set_new(found, coll_path, coll_found);
+
+        // A data object with more than one distinct good replica is
+        // marked with null
+        size_t index;
+        json_t *row;
+        json_array_foreach(rows, index, row) {
+            const char *name = json_string_value(json_object_get(row,
+                                                 JSON_DATA_OBJECT_KEY));
+            if (!name) continue;
+
+            if (json_object_get(coll_found, name)) {
+                json_object_set_new(coll_found, name, json_null());
+            }
+            else {
+                json_object_set(coll_found, name, row);
+            }
+        }
+        json_decref(rows);
+    }
+
+    for (size_t i = 0; i < num_items; i++) {
+        json_t *target = json_object_get(items[i], JSON_TARGET_KEY);
+        const char *coll =
+            json_string_value(json_object_get(target, JSON_COLLECTION_KEY));
+        const char *name =
+            json_string_value(json_object_get(target, JSON_DATA_OBJECT_KEY));
+
+        json_t *row = json_object_get(json_object_get(found, coll), name);
+        if (!json_is_object(row)) continue;
+
+        option_flags flags = 0;
+        lookahead_item_p(items[i], &flags);
+
+        json_t *result = json_pack("{s:s, s:s}",
+                                   JSON_COLLECTION_KEY,  coll,
+                                   JSON_DATA_OBJECT_KEY, name);
+        if (!result) continue;
+
+        if (flags & PRINT_SIZE) {
+            const char *size =
+                json_string_value(json_object_get(row, JSON_SIZE_KEY));
+            json_object_set_new(result, JSON_SIZE_KEY,
+                                json_integer(size ? atoll(size) : 0));
+        }
+        if (flags & PRINT_CHECKSUM) {
+            json_t *checksum = json_object_get(row, JSON_CHECKSUM_KEY);
+            json_object_set_new(result, JSON_CHECKSUM_KEY,
+                                checksum ? json_incref(checksum) :
+                                json_null());
+        }
+
+        results[i] = result;
+    }
+
+finally:
+    if (names) json_decref(names);
+    if (found) json_decref(found);
+}
+
+// Ensure there is an open connection. Must be called with the
+// connection lock held.
+static int ensure_connection(rodsEnv *env) {
+    if (!connection) {
+        logmsg(NOTICE, "Opening a new iRODS connection");
+        connection = rods_login(env);
+        if (!connection) return 1;
+    }
+
+    return 0;
+}
+
+// Run the operation for one item and print its output, unless a result
+// is given, having already been found for it
+static int process_item(rodsEnv *env, baton_json_op fn, json_t *item,
+                        json_t *answer, operation_args_t *args,
+                        int *item_count, int *error_count) {
+    baton_error_t error;
+    json_t *result;
+
+    pthread_mutex_lock(&conn_mutex); // Lock before connecting and executing a job
+    logmsg(DEBUG, "Work to do, lock obtained");
+
+    args->output_done = 0;
+    if (answer) {
+        logmsg(DEBUG, "Using the result found for item %d", *item_count);
+        init_baton_error(&error);
+        result = answer;
+    }
+    else {
+        if (ensure_connection(env) != 0) {
+            pthread_mutex_unlock(&conn_mutex);
+            json_decref(item);
+            return 1;
+        }
+
+        result = fn(env, connection, item, args, &error);
+    }
+    pthread_mutex_unlock(&conn_mutex); // Unlock before processing the result
+    logmsg(DEBUG, "Work done, lock released");
+
+    if (args->output_done) {
+        // The operation printed its own output, including any
+        // error report
+        if (error.code != 0) (*error_count)++;
+        if (result) json_decref(result);
+    }
+    else if (error.code != 0) {
+        // On error, add an error report to the input JSON as a
+        // property and print the input JSON. A NULL result should
+        // always be an error.
+        (*error_count)++;
+        add_error_value(item, &error);
+        print_json(item);
+    }
+    else {
+        if (has_operation(item) && has_operation_target(item)) {
+            // It's an envelope, so we add the result to the input
+            // JSON as a property and print the input JSON, The
+            // result will be freed as part of the input JSON.
+            baton_error_t rerror;
+            add_result(item, result, &rerror);
+            if (rerror.code != 0) {
+                logmsg(ERROR, "Failed to add error report to item %d "
+                       "in stream. Error code %d: %s", item_count,
+                       rerror.code, rerror.message);
+                (*error_count)++;
+            }
+            print_json(item);
+        }
+        else {
+            // There is no envelope and there is some result JSON,
+            // so we print the result JSON. The result is not
+            // freed as part of the input JSON, so we free it here.
+            print_json(result);
+            json_decref(result);
+        }
+    }
+
+    if (args->flags & FLUSH) fflush(stdout);
+
+    (*item_count)++;
+
+    json_decref(item); // JSON free
+
+    return 0;
+}
+
+// Answer a window of consecutive data object listings together, then
+// print their outputs in order
+static int process_window(rodsEnv *env, baton_json_op fn, json_t **window,
+                          size_t num_items, operation_args_t *args,
+                          int *item_count, int *error_count) {
+    int status = 0;
+    json_t *answers[LOOKAHEAD_MAX_ITEMS] = { NULL };
+
+    logmsg(DEBUG, "Answering %zu listings together", num_items);
+
+    pthread_mutex_lock(&conn_mutex);
+    if (ensure_connection(env) == 0) {
+        answer_lookahead(connection, window, num_items, answers);
+    }
+    pthread_mutex_unlock(&conn_mutex);
+
+    size_t i = 0;
+    for (; i < num_items; i++) {
+        status = process_item(env, fn, window[i], answers[i], args,
+                              item_count, error_count);
+        if (status != 0) break;
+    }
+
+    // Any items not processed after a failure are freed, with their
+    // answers
+    for (i++; i < num_items; i++) {
+        json_decref(window[i]);
+        if (answers[i]) json_decref(answers[i]);
+    }
+
+    return status;
+}
+
 static int iterate_json(FILE *input, rodsEnv *env, baton_json_op fn,
                         operation_args_t *args,
                         int *item_count, int *error_count) {
@@ -73,6 +343,12 @@ static int iterate_json(FILE *input, rodsEnv *env, baton_json_op fn,
     pthread_t tid;
     int thread_status = -1;
 
+    // Consecutive data object listings held back to be answered together
+    json_t *window[LOOKAHEAD_MAX_ITEMS];
+    size_t num_pending = 0;
+    size_t window_size = args->lookahead < LOOKAHEAD_MAX_ITEMS ?
+        args->lookahead : LOOKAHEAD_MAX_ITEMS;
+
     if (timeout < 10) {
         logmsg(ERROR, "The connection timeout (--connect-time argument) "
                "must be >=10 seconds");
@@ -107,62 +383,36 @@ static int iterate_json(FILE *input, rodsEnv *env, baton_json_op fn,
             continue;
         }
 
-        pthread_mutex_lock(&conn_mutex); // Lock before connecting and executing a job
-        logmsg(DEBUG, "Work to do, lock obtained");
-        if (!connection) {
-            logmsg(NOTICE, "Opening a new iRODS connection");
-            connection = rods_login(env);
-            if (!connection) {
-                status = 1;
-                pthread_mutex_unlock(&conn_mutex);
-                goto finally;
-            }
+        option_flags lookahead_flags;
+        int lookahead = window_size > 1 && fn == baton_json_dispatch_op &&
+            lookahead_item_p(item, &lookahead_flags);
+        if (lookahead) {
+            window[num_pending++] = item;
+            if (num_pending < window_size) continue;
         }
 
-        baton_error_t error;
-        json_t *result = fn(env, connection, item, args, &error);
-        pthread_mutex_unlock(&conn_mutex); // Unlock before processing the result
-        logmsg(DEBUG, "Work done, lock released");
-
-        if (error.code != 0) {
-            // On error, add an error report to the input JSON as a
-            // property and print the input JSON. A NULL result should
-            // always be an error.
-            (*error_count)++;
-            add_error_value(item, &error);
-            print_json(item);
-        }
-        else {
-            if (has_operation(item) && has_operation_target(item)) {
-                // It's an envelope, so we add the result to the input
-                // JSON as a property and print the input JSON, The
-                // result will be freed as part of the input JSON.
-                baton_error_t rerror;
-                add_result(item, result, &rerror);
-                if (rerror.code != 0) {
-                    logmsg(ERROR, "Failed to add error report to item %d "
-                           "in stream. Error code %d: %s", item_count,
-                           rerror.code, rerror.message);
-                    (*error_count)++;
-                }
-                print_json(item);
-            }
-            else {
-                // There is no envelope and there is some result JSON,
-                // so we print the result JSON. The result is not
-                // freed as part of the input JSON, so we free it here.
-                print_json(result);
-                json_decref(result);
-            }
+        // Pending items are answered before any later item is run
+        if (num_pending > 0) {
+            status = process_window(env, fn, window, num_pending, args,
+                                    item_count, error_count);
+            num_pending = 0;
+            if (status != 0) goto finally;
         }
 
-        if (args->flags & FLUSH) fflush(stdout);
-
-        (*item_count)++;
-
-        json_decref(item); // JSON free
+        if (!lookahead) {
+            status = process_item(env, fn, item, NULL, args, item_count,
+                                  error_count);
+            if (status != 0) goto finally;
+        }
     } // while
 
+    if (num_pending > 0 && !exit_flag) {
+        status = process_window(env, fn, window, num_pending, args,
+                                item_count, error_count);
+        num_pending = 0;
+        if (status != 0) goto finally;
+    }
+
     if (exit_flag) {
       status = exit_flag;
       logmsg(WARN, "Exiting on signal with code %d", exit_flag);
@@ -170,6 +420,10 @@ static int iterate_json(FILE *input, rodsEnv *env, baton_json_op fn,
     }
 
 finally:
+    for (size_t i = 0; i < num_pending; i++) {
+        json_decref(window[i]);
+    }
+
     pthread_mutex_lock(&conn_mutex);
     run_timeout_thread = 0;
     pthread_cond_signal(&watchdog_cond); // Unblock the thread waiting on cond
@@ -191,6 +445,119 @@ finally:
     return status;
 }
 
+// Return a copy of target marked as skipped, for transfers that were
+// unnecessary because the destination was already in sync
+static json_t *skipped_result(json_t *target, const char *path,
+                              baton_error_t *error) {
+    json_t *result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+        goto finally;
+    }
+
+    json_object_set_new(result, JSON_SKIPPED_KEY, json_true());
+
+finally:
+    return result;
+}
+
+// Print the output for a data object with its contents streamed into
+// the JSON, rather than held in memory. The output is serialised with
+// a placeholder for the contents, which are written in its place.
+static json_t *stream_data_obj_json(rcComm_t *conn, rodsPath_t *rods_path,
+                                    operation_args_t *args,
+                                    size_t buffer_size,
+                                    baton_error_t *error) {
+    json_t *result    = NULL;
+    json_t *output    = NULL;
+    char *placeholder = NULL;
+    char *dumped      = NULL;
+    char *err_dumped  = NULL;
+
+    init_baton_error(error);
+
+    if (rods_path->objType != DATA_OBJ_T) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot read the contents of '%s' because "
+                        "it is not a data object", rods_path->outPath);
+        goto finally;
+    }
+
+    result = list_path(conn, rods_path, args->flags, error);
+    if (error->code != 0) goto finally;
+
+    if (args->flags & BASE64_ENCODING) {
+        json_object_set_new(result, JSON_ENCODING_KEY,
+                            json_string(JSON_ENCODING_BASE64));
+    }
+
+    json_t *marker = json_string(STREAM_PLACEHOLDER);
+    placeholder = json_dumps(marker, JSON_ENCODE_ANY);
+    json_object_set_new(result, JSON_DATA_KEY, marker);
+
+    // The output is either the result, or the result within a copy of
+    // its envelope, as it would be printed by iterate_json
+    if (args->envelope) {
+        output = json_copy(args->envelope);
+        add_result(output, json_incref(result), error);
+        if (error->code != 0) goto finally;
+    }
+    else {
+        output = json_incref(result);
+    }
+
+    dumped = json_dumps(output, JSON_INDENT(0));
+    char *pos = (placeholder && dumped) ? strstr(dumped, placeholder) : NULL;
+    if (!pos || strstr(pos + 1, placeholder)) {
+        set_baton_error(error, -1, "Failed to serialise the result for '%s' "
+                        "for streaming", rods_path->outPath);
+        goto finally;
+    }
+
+    // Print up to and including the opening quote of the contents
+    size_t prefix_len = pos - dumped + 1;
+    fwrite(dumped, 1, prefix_len, stdout);
+    args->output_done = 1;
+
+    get_data_obj_json_stream(conn, rods_path, stdout, args->flags,
+                             buffer_size, error);
+
+    // Continue from the closing quote of the contents
+    const char *suffix = pos + strlen(placeholder) - 1;
+
+    if (error->code != 0) {
+        // Report the error in the output, where the serialisation with
+        // the error added has the same prefix
+        add_error_value(output, error);
+        err_dumped = json_dumps(output, JSON_INDENT(0));
+
+        char *err_pos = err_dumped ? strstr(err_dumped, placeholder) : NULL;
+        if (err_pos && (size_t) (err_pos - err_dumped + 1) == prefix_len &&
+            memcmp(err_dumped, dumped, prefix_len) == 0) {
+            suffix = err_pos + strlen(placeholder) - 1;
+        }
+        else {
+            logmsg(ERROR, "Failed to report an error in the streamed output "
+                   "for '%s'", rods_path->outPath);
+        }
+    }
+
+    fprintf(stdout, "%s\n", suffix);
+
+finally:
+    if (error->code != 0 && !args->output_done && result) {
+        json_decref(result);
+        result = NULL;
+    }
+    if (output)      json_decref(output);
+    if (placeholder) free(placeholder);
+    if (dumped)      free(dumped);
+    if (err_dumped)  free(err_dumped);
+
+    return result;
+}
+
 int do_operation(FILE *input, baton_json_op fn, operation_args_t *args) {
     int item_count  = 0;
     int error_count = 0;
@@ -225,6 +592,199 @@ error:
     return status;
 }
 
+// Inline data is requested explicitly, or implied by its encoding
+static int inline_data_p(operation_args_t *args) {
+    return args->inline_data || (args->flags & BASE64_ENCODING);
+}
+
+// Run an operation on one target, with arguments already parsed from
+// its envelope
+static json_t *dispatch_target(rodsEnv *env, rcComm_t *conn, const char *op,
+                               json_t *envelope, json_t *target,
+                               operation_args_t *args, baton_error_t *error) {
+    json_t *result = NULL;
+
+    logmsg(DEBUG, "Dispatching to operation '%s'", op);
+
+    if (str_equals(op, JSON_CHMOD_OP, MAX_STR_LEN)) {
+        result = baton_json_chmod_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_CHECKSUM_OP, MAX_STR_LEN)) {
+        result = baton_json_checksum_op(env, conn, target, args, error);
+        if (error->code != 0) goto finally;
+
+        if (args->flags & PRINT_CHECKSUM) {
+            result = add_checksum_json_object(conn, result, error);
+            if (error->code != 0) goto finally;
+        }
+    }
+    else if (str_equals(op, JSON_LIST_OP, MAX_STR_LEN)) {
+        result = baton_json_list_op(env, conn, target, args, error);
+        if (error->code != 0) goto finally;
+    }
+    else if (str_equals(op, JSON_METAMOD_OP, MAX_STR_LEN)) {
+        result = baton_json_metamod_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_METAQUERY_OP, MAX_STR_LEN)) {
+        result = baton_json_metaquery_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_METASUPER_OP, MAX_STR_LEN)) {
+        result = baton_json_metasuper_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_BULK_METAMOD_OP, MAX_STR_LEN)) {
+        result = baton_json_bulk_metamod_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_BULK_CHMOD_OP, MAX_STR_LEN)) {
+        result = baton_json_bulk_chmod_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_GET_OP, MAX_STR_LEN)) {
+        args->envelope = envelope;
+        result = baton_json_get_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_PUT_OP, MAX_STR_LEN)) {
+        if (args->flags & SINGLE_SERVER) {
+            logmsg(DEBUG, "Single-server mode, falling back "
+                   "to operation 'write'");
+            result = baton_json_write_op(env, conn, target, args, error);
+        }
+        else if (args->flags & RESUME) {
+            logmsg(DEBUG, "Resumable transfer, falling back "
+                   "to operation 'write'");
+            result = baton_json_write_op(env, conn, target, args, error);
+        }
+        else if (inline_data_p(args)) {
+            logmsg(DEBUG, "Inline data, falling back to operation 'write'");
+            result = baton_json_write_op(env, conn, target, args, error);
+        }
+        else {
+            result = baton_json_put_op(env, conn, target, args, error);
+        }
+        if (error->code != 0) goto finally;
+
+        if (args->flags & PRINT_CHECKSUM) {
+            result = add_checksum_json_object(conn, result, error);
+            if (error->code != 0) goto finally;
+        }
+    }
+    else if (str_equals(op, JSON_EXPORT_OP, MAX_STR_LEN)) {
+        result = baton_json_export_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_BULK_PUT_OP, MAX_STR_LEN)) {
+        result = baton_json_bulk_put_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_SYNC_OP, MAX_STR_LEN)) {
+        result = baton_json_sync_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_MOVE_OP, MAX_STR_LEN)) {
+        result = baton_json_move_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_COPY_OP, MAX_STR_LEN)) {
+        result = baton_json_copy_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_REGISTER_OP, MAX_STR_LEN)) {
+        result = baton_json_register_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_REPLICATE_OP, MAX_STR_LEN)) {
+        result = baton_json_replicate_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_RM_OP, MAX_STR_LEN)) {
+        result = baton_json_rm_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_SEQUENCE_OP, MAX_STR_LEN)) {
+        args->envelope = envelope;
+        result = baton_json_sequence_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_MKCOLL_OP, MAX_STR_LEN)) {
+        result = baton_json_mkcoll_op(env, conn, target, args, error);
+    }
+    else if (str_equals(op, JSON_RMCOLL_OP, MAX_STR_LEN)) {
+        result = baton_json_rmcoll_op(env, conn, target, args, error);
+    }
+    else {
+        set_baton_error(error, -1, "Invalid baton operation '%s'", op);
+    }
+
+finally:
+    return result;
+}
+
+// Run an operation on each of the targets of a batch envelope, whose
+// arguments have been parsed only once. The output for each target is
+// printed as iterate_json would print it for an envelope having that
+// target alone.
+static int dispatch_targets(rodsEnv *env, rcComm_t *conn, const char *op,
+                            json_t *envelope, json_t *targets,
+                            operation_args_t *args, baton_error_t *error) {
+    size_t num_failed = 0;
+    size_t index;
+    json_t *target;
+    json_array_foreach(targets, index, target) {
+        baton_error_t target_error;
+        init_baton_error(&target_error);
+
+        json_t *output = json_copy(envelope);
+        if (!output) {
+            set_baton_error(error, -1, "Failed to copy the envelope "
+                            "of target %zu", index);
+            goto finally;
+        }
+        json_object_del(output, JSON_TARGETS_KEY);
+        json_object_set(output, JSON_TARGET_KEY, target);
+
+        operation_args_t target_args = *args;
+        target_args.envelope    = NULL;
+        target_args.output_done = 0;
+
+        json_t *result = NULL;
+        if (!json_is_object(target)) {
+            set_baton_error(&target_error, CAT_INVALID_ARGUMENT,
+                            "Invalid target %zu: not a JSON object", index);
+        }
+        else {
+            result = dispatch_target(env, conn, op, output, target,
+                                     &target_args, &target_error);
+        }
+
+        if (target_error.code != 0) num_failed++;
+
+        if (target_args.output_done) {
+            if (result) json_decref(result);
+        }
+        else if (target_error.code != 0) {
+            if (result) json_decref(result);
+            add_error_value(output, &target_error);
+            print_json(output);
+        }
+        else {
+            if (result) {
+                baton_error_t rerror;
+                add_result(output, result, &rerror);
+                if (rerror.code != 0) {
+                    logmsg(ERROR, "Failed to add the result of target "
+                           "%zu: %s", index, rerror.message);
+                    num_failed++;
+                }
+            }
+            print_json(output);
+        }
+
+        if (args->flags & FLUSH) fflush(stdout);
+
+        json_decref(output);
+    }
+
+    logmsg(DEBUG, "Dispatched operation '%s' to %zu targets", op,
+           json_array_size(targets));
+
+    if (num_failed > 0) {
+        set_baton_error(error, -1, "Failed on %zu of %zu targets",
+                        num_failed, json_array_size(targets));
+    }
+
+finally:
+    return error->code;
+}
+
 json_t *baton_json_dispatch_op(rodsEnv *env, rcComm_t *conn, json_t *envelope,
                                operation_args_t *args, baton_error_t *error) {
     json_t *result = NULL;
@@ -232,7 +792,12 @@ json_t *baton_json_dispatch_op(rodsEnv *env, rcComm_t *conn, json_t *envelope,
     operation_args_t args_copy = { .flags       = args->flags,
                                    .buffer_size = args->buffer_size,
                                    .zone_name   = args->zone_name,
-                                   .path        = NULL };
+                                   .num_streams = args->num_streams,
+                                   .path        = NULL,
+                                   .resource    = NULL,
+                                   .resolved_path = args->resolved_path,
+                                   .trust_input = args->trust_input,
+                                   .inline_data = args->inline_data };
 
     const char *op = get_operation(envelope, error);
     if (error->code != 0) goto finally;
@@ -242,9 +807,6 @@ json_t *baton_json_dispatch_op(rodsEnv *env, rcComm_t *conn, json_t *envelope,
         goto finally;
     }
 
-    json_t *target = get_operation_target(envelope, error);
-    if (error->code != 0) goto finally;
-
     if (has_operation(envelope)) {
         json_t *args = get_operation_args(envelope, error);
         if (error->code != 0)  goto finally;
@@ -260,14 +822,37 @@ json_t *baton_json_dispatch_op(rodsEnv *env, rcComm_t *conn, json_t *envelope,
         if (op_size_p(args))                flags = flags | PRINT_SIZE;
         if (op_timestamp_p(args))           flags = flags | PRINT_TIMESTAMP;
         if (op_raw_p(args))                 flags = flags | PRINT_RAW;
+        if (op_framed_p(args))              flags = flags | PRINT_RAW | PRINT_FRAMED;
         if (op_save_p(args))                flags = flags | SAVE_FILES;
         if (op_recurse_p(args))             flags = flags | RECURSIVE;
         if (op_force_p(args))               flags = flags | FORCE;
         if (op_collection_p(args))          flags = flags | SEARCH_COLLECTIONS;
         if (op_object_p(args))              flags = flags | SEARCH_OBJECTS;
         if (op_single_server_p(args))       flags = flags | SINGLE_SERVER;
+        if (op_sync_p(args))                flags = flags | SYNC;
+        if (op_resume_p(args))              flags = flags | RESUME;
+        if (op_stream_p(args))              flags = flags | STREAM_CONTENTS;
+        if (op_delete_p(args))              flags = flags | SYNC_DELETE;
+        if (op_admin_p(args))               flags = flags | ADMIN_MODE;
+        if (op_update_p(args))              flags = flags | UPDATE_STALE;
         args_copy.flags = flags;
 
+        if (op_trust_p(args))  args_copy.trust_input = 1;
+        if (op_inline_p(args)) args_copy.inline_data = 1;
+
+        if (has_op_encoding(args)) {
+            const char *encoding = get_op_encoding(args, error);
+            if (error->code != 0) goto finally;
+
+            if (str_equals(encoding, JSON_ENCODING_BASE64, MAX_STR_LEN)) {
+                args_copy.flags = args_copy.flags | BASE64_ENCODING;
+            }
+            else {
+                set_baton_error(error, -1, "Invalid encoding '%s'", encoding);
+                goto finally;
+            }
+        }
+
         if (has_operation(args)) {
             const char *arg = get_operation(args, error);
             if (error->code != 0) goto finally;
@@ -299,71 +884,197 @@ json_t *baton_json_dispatch_op(rodsEnv *env, rcComm_t *conn, json_t *envelope,
 
             args_copy.path = tmp;
         }
-    }
 
-    logmsg(DEBUG, "Dispatching to operation '%s'", op);
+        if (has_op_resource(args)) {
+            const char *resource = get_op_resource(args, error);
+            if (error->code != 0) goto finally;
 
-    if (str_equals(op, JSON_CHMOD_OP, MAX_STR_LEN)) {
-        result = baton_json_chmod_op(env, conn, target, &args_copy, error);
-    }
-    else if (str_equals(op, JSON_CHECKSUM_OP, MAX_STR_LEN)) {
-        result = baton_json_checksum_op(env, conn, target, &args_copy, error);
-        if (error->code != 0) goto finally;
+            char *tmp = copy_str(resource, MAX_STR_LEN);
+            if (!tmp) {
+                set_baton_error(error, errno, "Failed to copy string '%s'",
+                                resource);
+                goto finally;
+            }
 
-        if (args_copy.flags & PRINT_CHECKSUM) {
-            result = add_checksum_json_object(conn, result, error);
-            if (error->code != 0) goto finally;
+            args_copy.resource = tmp;
         }
-    }
-    else if (str_equals(op, JSON_LIST_OP, MAX_STR_LEN)) {
-        result = baton_json_list_op(env, conn, target, &args_copy, error);
-        if (error->code != 0) goto finally;
-    }
-    else if (str_equals(op, JSON_METAMOD_OP, MAX_STR_LEN)) {
-        result = baton_json_metamod_op(env, conn, target, &args_copy, error);
-    }
-    else if (str_equals(op, JSON_METAQUERY_OP, MAX_STR_LEN)) {
-        result = baton_json_metaquery_op(env, conn, target, &args_copy, error);
-    }
-    else if (str_equals(op, JSON_GET_OP, MAX_STR_LEN)) {
-        result = baton_json_get_op(env, conn, target, &args_copy, error);
-    }
-    else if (str_equals(op, JSON_PUT_OP, MAX_STR_LEN)) {
-        if (args_copy.flags & SINGLE_SERVER) {
-            logmsg(DEBUG, "Single-server mode, falling back "
-                   "to operation 'write'");
-            result = baton_json_write_op(env, conn, target, &args_copy, error);
+
+        if (has_op_offset(args) || has_op_length(args)) {
+            if (!str_equals(op, JSON_GET_OP, MAX_STR_LEN)) {
+                set_baton_error(error, USER_INPUT_OPTION_ERR,
+                                "The '%s' and '%s' arguments apply only to "
+                                "the '%s' operation", JSON_OP_OFFSET,
+                                JSON_OP_LENGTH, JSON_GET_OP);
+                goto finally;
+            }
+
+            args_copy.flags  = args_copy.flags | BYTE_RANGE;
+            args_copy.offset = 0;
+            args_copy.length = SIZE_MAX; // To the end of the data object
+
+            if (has_op_offset(args)) {
+                args_copy.offset = get_op_offset(args, error);
+                if (error->code != 0) goto finally;
+            }
+            if (has_op_length(args)) {
+                args_copy.length = get_op_length(args, error);
+                if (error->code != 0) goto finally;
+            }
         }
-        else {
-            result = baton_json_put_op(env, conn, target, &args_copy, error);
+
+        if (has_op_resume_from(args)) {
+            if (!str_equals(op, JSON_CHMOD_OP, MAX_STR_LEN)) {
+                set_baton_error(error, USER_INPUT_OPTION_ERR,
+                                "The '%s' argument applies only to the "
+                                "'%s' operation", JSON_OP_RESUME_FROM,
+                                JSON_CHMOD_OP);
+                goto finally;
+            }
+
+            args_copy.resume_from = get_op_resume_from(args, error);
+            if (error->code != 0) goto finally;
         }
-        if (error->code != 0) goto finally;
 
-        if (args_copy.flags & PRINT_CHECKSUM) {
-            result = add_checksum_json_object(conn, result, error);
+        if (has_op_threads(args)) {
+            args_copy.num_streams = get_op_threads(args, error);
             if (error->code != 0) goto finally;
         }
     }
-    else if (str_equals(op, JSON_MOVE_OP, MAX_STR_LEN)) {
-        result = baton_json_move_op(env, conn, target, &args_copy, error);
+
+    if (has_operation_targets(envelope)) {
+        if (has_operation_target(envelope)) {
+            set_baton_error(error, CAT_INVALID_ARGUMENT,
+                            "An envelope may have either a '%s' or '%s', "
+                            "but not both", JSON_TARGET_KEY, JSON_TARGETS_KEY);
+            goto finally;
+        }
+
+        json_t *targets = get_operation_targets(envelope, error);
+        if (error->code != 0) goto finally;
+
+        dispatch_targets(env, conn, op, envelope, targets, &args_copy, error);
+        args->output_done = 1;
     }
-    else if (str_equals(op, JSON_RM_OP, MAX_STR_LEN)) {
-        result = baton_json_rm_op(env, conn, target, &args_copy, error);
+    else {
+        json_t *target = get_operation_target(envelope, error);
+        if (error->code != 0) goto finally;
+
+        result = dispatch_target(env, conn, op, envelope, target, &args_copy,
+                                 error);
+        args->output_done = args_copy.output_done;
     }
-    else if (str_equals(op, JSON_MKCOLL_OP, MAX_STR_LEN)) {
-        result = baton_json_mkcoll_op(env, conn, target, &args_copy, error);
+
+finally:
+    if (args_copy.path)     free(args_copy.path);
+    if (args_copy.resource) free(args_copy.resource);
+
+    return result;
+}
+
+static rodsObjStat_t *copy_obj_stat(const rodsObjStat_t *stat,
+                                    baton_error_t *error) {
+    rodsObjStat_t *copy = malloc(sizeof (rodsObjStat_t));
+    if (!copy) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        return NULL;
     }
-    else if (str_equals(op, JSON_RMCOLL_OP, MAX_STR_LEN)) {
-        result = baton_json_rmcoll_op(env, conn, target, &args_copy, error);
+
+    memcpy(copy, stat, sizeof (rodsObjStat_t));
+
+    return copy;
+}
+
+// Resolve the path of an operation's target, reusing the resolution
+// made by an earlier step of a sequence, if any. Each operation frees
+// the rodsObjStat of its path, so it is given its own copy.
+static int resolve_target_path(rcComm_t *conn, rodsEnv *env,
+                               rodsPath_t *rods_path, char *path,
+                               operation_args_t *args, baton_error_t *error) {
+    rodsPath_t *cached = args->resolved_path;
+
+    init_baton_error(error);
+
+    if (cached && cached->objState == EXIST_ST &&
+        str_equals(cached->inPath, path, MAX_NAME_LEN)) {
+        logmsg(DEBUG, "Reusing the resolved path '%s'", path);
+
+        *rods_path = *cached;
+        rods_path->rodsObjStat = NULL;
+        if (cached->rodsObjStat) {
+            rods_path->rodsObjStat = copy_obj_stat(cached->rodsObjStat,
+                                                   error);
+        }
+
+        goto finally;
     }
-    else {
-        set_baton_error(error, -1, "Invalid baton operation '%s'", op);
+
+    resolve_rods_path(conn, env, rods_path, path, args->flags, error);
+    if (error->code != 0) goto finally;
+
+    if (cached && rods_path->objState == EXIST_ST) {
+        if (cached->rodsObjStat) free(cached->rodsObjStat);
+
+        *cached = *rods_path;
+        cached->rodsObjStat = NULL;
+        if (rods_path->rodsObjStat) {
+            cached->rodsObjStat = copy_obj_stat(rods_path->rodsObjStat,
+                                                error);
+        }
     }
 
 finally:
-    if (args_copy.path) free(args_copy.path);
+    return error->code;
+}
 
-    return result;
+// Record that an operation has left its target as an existing data
+// object, so that a later step of a sequence need not resolve it
+// again. The operation may have changed the object, so its stat is
+// not kept.
+static int seed_target_path(rodsPath_t *rods_path, char *path,
+                            operation_args_t *args, baton_error_t *error) {
+    rodsPath_t *cached = args->resolved_path;
+
+    init_baton_error(error);
+
+    if (!cached) goto finally;
+
+    if (cached->rodsObjStat) free(cached->rodsObjStat);
+
+    *cached = *rods_path;
+    cached->objState    = EXIST_ST;
+    cached->objType     = DATA_OBJ_T;
+    cached->rodsObjStat = NULL;
+    snprintf(cached->inPath, MAX_NAME_LEN, "%s", path);
+
+finally:
+    return error->code;
+}
+
+// Set up the path of a target for an operation whose own request
+// reports a missing path. When trusting the input, the shape of the
+// target gives its type and the server is not asked.
+static int trust_target_path(rcComm_t *conn, rodsEnv *env,
+                             rodsPath_t *rods_path, json_t *target, char *path,
+                             operation_args_t *args, baton_error_t *error) {
+    if (args->trust_input && str_starts_with(path, "/", 1)) {
+        logmsg(DEBUG, "Trusting '%s' to exist", path);
+        return set_trusted_rods_path(target, rods_path, error);
+    }
+
+    return resolve_target_path(conn, env, rods_path, path, args, error);
+}
+
+// Report a trusted path found missing by the server in the same way as
+// a path found missing by resolving it
+static void map_missing_path_error(rodsPath_t *rods_path,
+                                   operation_args_t *args,
+                                   baton_error_t *error) {
+    if (!args->trust_input || !str_starts_with(rods_path->inPath, "/", 1)) {
+        return;
+    }
+
+    set_missing_path_error(rods_path, error);
 }
 
 json_t *baton_json_list_op(rodsEnv *env, rcComm_t *conn, json_t *target,
@@ -375,7 +1086,7 @@ json_t *baton_json_list_op(rodsEnv *env, rcComm_t *conn, json_t *target,
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    resolve_target_path(conn, env, &rods_path, path, args, error);
     if (error->code != 0) goto finally;
 
     result = list_path(conn, &rods_path, args->flags, error);
@@ -390,14 +1101,15 @@ finally:
 
 json_t *baton_json_chmod_op(rodsEnv *env, rcComm_t *conn, json_t *target,
                             operation_args_t *args, baton_error_t *error) {
-    json_t *result = NULL;
+    json_t *result  = NULL;
+    json_t *summary = NULL;
     rodsPath_t rods_path;
     memset(&rods_path, 0, sizeof (rodsPath_t));
 
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    trust_target_path(conn, env, &rods_path, target, path, args, error);
     if (error->code != 0) goto finally;
 
     json_t *perms = json_object_get(target, JSON_ACCESS_KEY);
@@ -409,20 +1121,38 @@ json_t *baton_json_chmod_op(rodsEnv *env, rcComm_t *conn, json_t *target,
 
     recursive_op recurse = (args->flags & RECURSIVE) ? RECURSE : NO_RECURSE;
 
-    for (size_t i = 0; i < json_array_size(perms); i++) {
-        json_t *perm = json_array_get(perms, i);
-        modify_json_permissions(conn, &rods_path, recurse, perm, error);
-
-        if (error->code != 0) goto finally;
+    // Given a number of workers, a collection is walked by the client,
+    // rather than by one recursive request to the server
+    if (recurse == RECURSE && rods_path.objType == COLL_OBJ_T &&
+        args->num_streams > 0) {
+        // One line is printed for each batch or failure, before the result
+        summary = chmod_collection(conn, &rods_path, perms, stdout,
+                                   args->resume_from,
+                                   args->num_streams, error);
+    }
+    else if (args->resume_from > 0) {
+        set_baton_error(error, USER_INPUT_OPTION_ERR,
+                        "Cannot resume modifying the permissions of %s "
+                        "unless recursing on a collection with threads",
+                        path);
+    }
+    else {
+        apply_json_permissions(conn, &rods_path, recurse, perms, error);
     }
+    if (error->code != 0) goto finally;
 
     result = json_deep_copy(target);
     if (!result) {
         set_baton_error(error, -1, "Internal error: failed to deep-copy "
                         "result for %s", path);
+        goto finally;
     }
 
+    if (summary) json_object_update(result, summary);
+
 finally:
+    fflush(stdout);
+    if (summary) json_decref(summary);
     if (path) free(path);
     if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
 
@@ -440,7 +1170,7 @@ json_t *baton_json_checksum_op(rodsEnv *env, rcComm_t *conn, json_t *target,
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    trust_target_path(conn, env, &rods_path, target, path, args, error);
     if (error->code != 0) goto finally;
 
     if (!represents_data_object(target)) {
@@ -451,6 +1181,7 @@ json_t *baton_json_checksum_op(rodsEnv *env, rcComm_t *conn, json_t *target,
 
     option_flags flags = args->flags;
     checksum = checksum_data_obj(conn, &rods_path, flags, error);
+    map_missing_path_error(&rods_path, args, error);
     if (error->code != 0) goto finally;
 
     jchecksum = checksum_to_json(checksum, error);
@@ -463,6 +1194,9 @@ json_t *baton_json_checksum_op(rodsEnv *env, rcComm_t *conn, json_t *target,
         goto finally;
     }
 
+    seed_target_path(&rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
     result = json_deep_copy(target);
     if (!result) {
         set_baton_error(error, -1, "Internal error: failed to deep-copy "
@@ -504,7 +1238,7 @@ json_t *baton_json_metamod_op(rodsEnv *env, rcComm_t *conn, json_t *target,
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    trust_target_path(conn, env, &rods_path, target, path, args, error);
     if (error->code != 0) goto finally;
 
     json_t *avus = json_object_get(target, JSON_AVUS_KEY);
@@ -527,12 +1261,50 @@ json_t *baton_json_metamod_op(rodsEnv *env, rcComm_t *conn, json_t *target,
         goto finally;
     }
 
-    for (size_t i = 0; i < json_array_size(avus); i++) {
-        json_t *avu = json_array_get(avus, i);
-        modify_json_metadata(conn, &rods_path, operation, avu, error);
-        if (error->code != 0) goto finally;
+    if (operation == META_ADD) {
+        apply_json_metadata(conn, &rods_path, NULL, avus, error);
+    }
+    else {
+        apply_json_metadata(conn, &rods_path, avus, NULL, error);
+    }
+    map_missing_path_error(&rods_path, args, error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+    }
+
+finally:
+    if (path) free(path);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    return result;
+}
+
+json_t *baton_json_metasuper_op(rodsEnv *env, rcComm_t *conn, json_t *target,
+                                operation_args_t *args, baton_error_t *error) {
+    json_t *result = NULL;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    char *path = json_to_path(target, error);
+    if (error->code != 0) goto finally;
+
+    json_t *avus = json_object_get(target, JSON_AVUS_KEY);
+    if (!json_is_array(avus)) {
+        set_baton_error(error, -1, "AVU data for %s is not in a JSON array",
+                        path);
+        goto finally;
     }
 
+    resolve_target_path(conn, env, &rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    supersede_json_metadata(conn, &rods_path, avus, error);
+    if (error->code != 0) goto finally;
+
     result = json_deep_copy(target);
     if (!result) {
         set_baton_error(error, -1, "Internal error: failed to deep-copy "
@@ -546,6 +1318,142 @@ finally:
     return result;
 }
 
+// Return the targets of a bulk operation, either its paths or the
+// matches of its query
+static json_t *get_bulk_targets(rodsEnv *env, rcComm_t *conn, json_t *target,
+                                operation_args_t *args, baton_error_t *error) {
+    json_t *paths = json_object_get(target, JSON_PATHS_KEY);
+    json_t *query = json_object_get(target, JSON_QUERY_KEY);
+    if ((paths && query) || (!paths && !query)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Bulk targets must be given either as '%s' or "
+                        "as a '%s'", JSON_PATHS_KEY, JSON_QUERY_KEY);
+        return NULL;
+    }
+
+    if (paths) return json_incref(paths);
+
+    if (!json_is_object(query)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Bulk target query is not a JSON object");
+        return NULL;
+    }
+
+    if (has_collection(query)) {
+        resolve_collection(query, conn, env, args->flags, error);
+        if (error->code != 0) return NULL;
+    }
+
+    // Only the paths of the matches are needed, so nothing else is
+    // added to them. Both kinds are searched unless one is chosen.
+    option_flags search_flags =
+        args->flags & (SEARCH_COLLECTIONS | SEARCH_OBJECTS);
+    if (!search_flags) search_flags = SEARCH_COLLECTIONS | SEARCH_OBJECTS;
+
+    return search_metadata(conn, query, args->zone_name, search_flags, error);
+}
+
+// Return the result of a bulk operation, without echoing its paths
+static json_t *make_bulk_result(json_t *target, json_t *summary,
+                                baton_error_t *error) {
+    json_t *result = json_object();
+    if (!result) {
+        set_baton_error(error, -1, "Failed to allocate a new JSON object");
+        return NULL;
+    }
+
+    const char *key;
+    json_t *value;
+    json_object_foreach(target, key, value) {
+        if (str_equals(key, JSON_PATHS_KEY, MAX_STR_LEN)) continue;
+        json_object_set_new(result, key, json_deep_copy(value));
+    }
+    json_object_update(result, summary);
+
+    return result;
+}
+
+json_t *baton_json_bulk_metamod_op(rodsEnv *env, rcComm_t *conn,
+                                  json_t *target, operation_args_t *args,
+                                  baton_error_t *error) {
+    json_t *result  = NULL;
+    json_t *targets = NULL;
+    json_t *summary = NULL;
+
+    json_t *avus = json_object_get(target, JSON_AVUS_KEY);
+    if (!json_is_array(avus)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Bulk AVU data is not in a JSON array");
+        goto finally;
+    }
+
+    metadata_op operation;
+    if (args->flags & ADD_AVU) {
+        operation = META_ADD;
+    }
+    else if (args->flags & REMOVE_AVU) {
+        operation = META_REM;
+    }
+    else {
+        set_baton_error(error, USER_INPUT_OPTION_ERR,
+                        "No bulk metadata operation was specified");
+        goto finally;
+    }
+
+    targets = get_bulk_targets(env, conn, target, args, error);
+    if (error->code != 0) goto finally;
+
+    // One line is printed for each target, before the result
+    summary = bulk_modify_metadata(env, conn, targets, avus, operation,
+                                   args->flags, args->trust_input, stdout,
+                                   args->num_streams, error);
+    if (error->code != 0) goto finally;
+
+    result = make_bulk_result(target, summary, error);
+
+finally:
+    fflush(stdout);
+    if (targets) json_decref(targets);
+    if (summary) json_decref(summary);
+
+    return result;
+}
+
+json_t *baton_json_bulk_chmod_op(rodsEnv *env, rcComm_t *conn,
+                                json_t *target, operation_args_t *args,
+                                baton_error_t *error) {
+    json_t *result  = NULL;
+    json_t *targets = NULL;
+    json_t *summary = NULL;
+
+    json_t *perms = json_object_get(target, JSON_ACCESS_KEY);
+    if (!json_is_array(perms)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Bulk permissions data is not in a JSON array");
+        goto finally;
+    }
+
+    targets = get_bulk_targets(env, conn, target, args, error);
+    if (error->code != 0) goto finally;
+
+    recursive_op recurse = (args->flags & RECURSIVE) ? RECURSE : NO_RECURSE;
+
+    // One line is printed for each target, before the result
+    summary = bulk_modify_permissions(env, conn, targets, perms, recurse,
+                                      args->flags, args->trust_input, stdout,
+                                      args->num_streams, error);
+    if (error->code != 0) goto finally;
+
+    result = make_bulk_result(target, summary, error);
+
+finally:
+    fflush(stdout);
+    if (targets) json_decref(targets);
+    if (summary) json_decref(summary);
+
+    return result;
+}
+
 json_t *baton_json_get_op(rodsEnv *env, rcComm_t *conn, json_t *target,
                           operation_args_t *args, baton_error_t *error) {
     json_t *result = NULL;
@@ -556,23 +1464,59 @@ json_t *baton_json_get_op(rodsEnv *env, rcComm_t *conn, json_t *target,
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    resolve_target_path(conn, env, &rods_path, path, args, error);
     if (error->code != 0) goto finally;
 
+    // A path left by an earlier put in a sequence has no stat, which
+    // gives the size, checksum and modification time of what is got
+    if (rods_path.objState == EXIST_ST && !rods_path.rodsObjStat) {
+        resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+        if (error->code != 0) goto finally;
+    }
+
     file = json_to_local_path(target, error);
     if (error->code != 0) goto finally;
 
     size_t bsize = args->buffer_size;
     logmsg(DEBUG, "Using a 'get' buffer size of %zu bytes", bsize);
 
+    int range = args->flags & BYTE_RANGE;
+    if (range && (args->flags & (SYNC | RESUME))) {
+        set_baton_error(error, USER_INPUT_OPTION_ERR,
+                        "Cannot combine a byte range with sync or resume "
+                        "when getting '%s'", path);
+        goto finally;
+    }
+
     if (args->flags & SAVE_FILES) {
+        if (args->flags & SYNC) {
+            int in_sync = local_file_in_sync(conn, &rods_path, file, error);
+            if (error->code != 0) goto finally;
+
+            if (in_sync) {
+                logmsg(NOTICE, "Skipping get of '%s' to '%s' which is "
+                       "already in sync", path, file);
+                result = skipped_result(target, path, error);
+                goto finally;
+            }
+        }
+
         result = json_deep_copy(target);
         if (!result) {
             set_baton_error(error, errno,
                             "Failed to allocate memory for result");
             goto finally;
         }
-        get_data_obj_file(conn, &rods_path, file, bsize, error);
+        if (range) {
+            get_data_obj_range_file(conn, &rods_path, file, args->offset,
+                                    args->length, bsize, error);
+        }
+        else if (args->flags & RESUME) {
+            get_data_obj_file_resumable(conn, &rods_path, file, bsize, error);
+        }
+        else {
+            get_data_obj_file(conn, &rods_path, file, bsize, error);
+        }
         if (error->code != 0) goto finally;
     }
     else if (args->flags & PRINT_RAW) {
@@ -582,9 +1526,29 @@ json_t *baton_json_get_op(rodsEnv *env, rcComm_t *conn, json_t *target,
                             "Failed to allocate memory for result");
             goto finally;
         }
-        get_data_obj_stream(conn, &rods_path, stdout, bsize, error);
+        if (args->flags & PRINT_FRAMED) {
+            size_t offset = range ? args->offset : 0;
+            size_t length = range ? args->length : SIZE_MAX;
+            get_data_obj_framed_stream(conn, &rods_path, stdout, offset,
+                                       length, bsize, error);
+        }
+        else if (range) {
+            get_data_obj_range_stream(conn, &rods_path, stdout, args->offset,
+                                      args->length, bsize, error);
+        }
+        else {
+            get_data_obj_stream(conn, &rods_path, stdout, bsize, error);
+        }
         if (error->code != 0) goto finally;
     }
+    else if (range) {
+        result = ingest_data_obj_range(conn, &rods_path, args->flags,
+                                       args->offset, args->length, bsize,
+                                       error);
+    }
+    else if (args->flags & STREAM_CONTENTS) {
+        result = stream_data_obj_json(conn, &rods_path, args, bsize, error);
+    }
     else {
         result = ingest_data_obj(conn, &rods_path, args->flags, bsize, error);
     }
@@ -607,7 +1571,7 @@ json_t *baton_json_write_op(rodsEnv *env, rcComm_t *conn, json_t *target,
     rodsPath_t rods_path;
     memset(&rods_path, 0, sizeof (rodsPath_t));
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    resolve_target_path(conn, env, &rods_path, path, args, error);
     if (error->code != 0) goto finally;
 
     file = json_to_local_path(target, error);
@@ -619,32 +1583,97 @@ json_t *baton_json_write_op(rodsEnv *env, rcComm_t *conn, json_t *target,
         goto finally;
     }
 
-    size_t bsize = args->buffer_size;
-    logmsg(DEBUG, "Using a 'write' buffer size of %zu bytes", bsize);
-
-    FILE *in = fopen(file, "r");
-    if (!in) {
-        set_baton_error(error, errno,
-                        "Failed to open '%s' for reading: error %d %s",
-                        file, errno, strerror(errno));
+    // The contents may be given in the target, rather than a local file,
+    // but only when asked for. A get result carries its contents as
+    // data beside its local file, which is what is put.
+    int inline_data = inline_data_p(args);
+    if (inline_data && !has_data(target)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Inline data was requested for '%s', but the "
+                        "target has none", path);
+        goto finally;
+    }
+    if (inline_data && has_local_path(target)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "Cannot write '%s' from both inline data and a "
+                        "local file", path);
+        goto finally;
+    }
+    if (inline_data && (args->flags & (SYNC | RESUME))) {
+        set_baton_error(error, USER_INPUT_OPTION_ERR,
+                        "Cannot combine inline data with sync or resume "
+                        "when writing '%s'", path);
         goto finally;
     }
 
-    write_data_obj(conn, in, &rods_path, bsize, args->flags, error);
-    int status = fclose(in);
+    if (args->flags & SYNC) {
+        int in_sync = local_file_in_sync(conn, &rods_path, file, error);
+        if (error->code != 0) goto finally;
 
-    if (error->code != 0) goto finally;
-    if (status != 0) {
-        set_baton_error(error, errno,
-                        "Failed to close '%s': error %d %s",
-                        file, errno, strerror(errno));
+        if (in_sync) {
+            logmsg(NOTICE, "Skipping write of '%s' to '%s' which is "
+                   "already in sync", file, path);
+            result = skipped_result(target, path, error);
+            goto finally;
+        }
     }
 
-finally:
-    if (path) free(path);
-    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
-    if (file) free(file);
-
+    size_t bsize = args->buffer_size;
+    logmsg(DEBUG, "Using a 'write' buffer size of %zu bytes", bsize);
+
+    if (inline_data) {
+        json_t *data = json_object_get(target, JSON_DATA_KEY);
+        write_data_obj_content(conn, json_string_value(data),
+                               json_string_length(data), &rods_path, bsize,
+                               args->flags, error);
+    }
+    else if (args->flags & RESUME) {
+        write_data_obj_resumable(conn, file, &rods_path, bsize, args->flags,
+                                 error);
+    }
+    else if (args->num_streams > 1) {
+        write_data_obj_parallel(conn, file, &rods_path, bsize,
+                                args->num_streams, args->flags, error);
+    }
+    else {
+        FILE *in = fopen(file, "r");
+        if (!in) {
+            set_baton_error(error, errno,
+                            "Failed to open '%s' for reading: error %d %s",
+                            file, errno, strerror(errno));
+            goto finally;
+        }
+
+        write_data_obj(conn, in, &rods_path, bsize, args->flags, error);
+        int status = fclose(in);
+
+        if (error->code != 0) goto finally;
+        if (status != 0) {
+            set_baton_error(error, errno,
+                            "Failed to close '%s': error %d %s",
+                            file, errno, strerror(errno));
+        }
+    }
+    if (error->code != 0) goto finally;
+
+    seed_target_path(&rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+        goto finally;
+    }
+
+    // Don't echo inline data back
+    json_object_del(result, JSON_DATA_KEY);
+
+finally:
+    if (path) free(path);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+    if (file) free(file);
+
     return result;
 }
 
@@ -660,7 +1689,7 @@ json_t *baton_json_put_op(rodsEnv *env, rcComm_t *conn, json_t *target,
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    resolve_target_path(conn, env, &rods_path, path, args, error);
     if (error->code != 0) goto finally;
 
     file = json_to_local_path(target, error);
@@ -671,6 +1700,18 @@ json_t *baton_json_put_op(rodsEnv *env, rcComm_t *conn, json_t *target,
         logmsg(DEBUG, "Using default iRODS resource '%s'", def_resource);
     }
 
+    if (args->flags & SYNC) {
+        int in_sync = local_file_in_sync(conn, &rods_path, file, error);
+        if (error->code != 0) goto finally;
+
+        if (in_sync) {
+            logmsg(NOTICE, "Skipping put of '%s' to '%s' which is "
+                   "already in sync", file, path);
+            result = skipped_result(target, path, error);
+            goto finally;
+        }
+    }
+
     if (has_checksum(target)) {
         checksum = json_to_checksum(target, error);
         if (error->code != 0) goto finally;
@@ -687,6 +1728,9 @@ json_t *baton_json_put_op(rodsEnv *env, rcComm_t *conn, json_t *target,
         goto finally;
     }
 
+    seed_target_path(&rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
     result = json_deep_copy(target);
     if (!result) {
         set_baton_error(error, -1, "Internal error: failed to deep-copy "
@@ -711,7 +1755,7 @@ json_t *baton_json_move_op(rodsEnv *env, rcComm_t *conn, json_t *target,
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    resolve_target_path(conn, env, &rods_path, path, args, error);
     if (error->code != 0) goto finally;
 
     char *new_path = args->path;
@@ -733,6 +1777,161 @@ finally:
     return result;
 }
 
+json_t *baton_json_copy_op(rodsEnv *env, rcComm_t *conn, json_t *target,
+                           operation_args_t *args, baton_error_t *error) {
+    json_t *result = NULL;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    char *path = json_to_path(target, error);
+    if (error->code != 0) goto finally;
+
+    resolve_target_path(conn, env, &rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    char *new_path = args->path;
+    logmsg(DEBUG, "Copying '%s' to '%s'", path, new_path);
+
+    copy_rods_path(conn, &rods_path, new_path, args->resource, args->flags,
+                   error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+    }
+
+finally:
+    if (path) free(path);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    return result;
+}
+
+json_t *baton_json_register_op(rodsEnv *env, rcComm_t *conn,
+                               json_t *target, operation_args_t *args,
+                               baton_error_t *error) {
+    json_t *result = NULL;
+    char *file     = NULL;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    char *path = json_to_path(target, error);
+    if (error->code != 0) goto finally;
+
+    if (!represents_data_object(target)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "cannot register a non-data-object");
+        goto finally;
+    }
+
+    json_t *avus = json_object_get(target, JSON_AVUS_KEY);
+    if (avus && !json_is_array(avus)) {
+        set_baton_error(error, -1, "AVU data for %s is not in a JSON array",
+                        path);
+        goto finally;
+    }
+
+    // The AVUs are checked before registering, so that an invalid AVU
+    // does not leave a data object registered without its metadata
+    check_json_avus(avus, error);
+    if (error->code != 0) goto finally;
+
+    resolve_target_path(conn, env, &rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    // The local path is the physical path on the resource server
+    file = json_to_local_path(target, error);
+    if (error->code != 0) goto finally;
+
+    register_data_obj(conn, file, &rods_path, args->resource, args->flags,
+                      error);
+    if (error->code != 0) goto finally;
+
+    rods_path.objState = EXIST_ST;
+    rods_path.objType  = DATA_OBJ_T;
+
+    // All the AVUs are added in one request, where the server allows
+    apply_checked_json_metadata(conn, &rods_path, NULL, avus, error);
+    if (error->code != 0) goto finally;
+
+    seed_target_path(&rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+    }
+
+finally:
+    if (path) free(path);
+    if (file) free(file);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    return result;
+}
+
+json_t *baton_json_replicate_op(rodsEnv *env, rcComm_t *conn,
+                                json_t *target, operation_args_t *args,
+                                baton_error_t *error) {
+    json_t *result  = NULL;
+    json_t *summary = NULL;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    char *path = json_to_path(target, error);
+    if (error->code != 0) goto finally;
+
+    resolve_target_path(conn, env, &rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    switch (rods_path.objType) {
+        case DATA_OBJ_T:
+            replicate_data_obj(conn, rods_path.outPath, args->resource,
+                               args->flags, error);
+            break;
+
+        case COLL_OBJ_T:
+            if (!(args->flags & RECURSIVE)) {
+                set_baton_error(error, USER_INPUT_OPTION_ERR,
+                                "Cannot replicate collection '%s' without "
+                                "recursion", path);
+                goto finally;
+            }
+
+            // One line is printed for each data object, before the result
+            summary = replicate_collection(conn, &rods_path, args->resource,
+                                           stdout, args->flags,
+                                           args->num_streams, error);
+            break;
+
+        default:
+            set_baton_error(error, USER_INPUT_PATH_ERR,
+                            "Failed to replicate '%s' as it is "
+                            "neither data object nor collection", path);
+    }
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+        goto finally;
+    }
+
+    if (summary) json_object_update(result, summary);
+
+finally:
+    fflush(stdout);
+    if (summary) json_decref(summary);
+    if (path) free(path);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    return result;
+}
+
 json_t *baton_json_rm_op(rodsEnv *env, rcComm_t *conn,
                          json_t *target, operation_args_t *args,
                          baton_error_t *error) {
@@ -743,7 +1942,7 @@ json_t *baton_json_rm_op(rodsEnv *env, rcComm_t *conn,
     char *path = json_to_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    trust_target_path(conn, env, &rods_path, target, path, args, error);
     if (error->code != 0) goto finally;
 
     if (!represents_data_object(target)) {
@@ -779,7 +1978,7 @@ json_t *baton_json_mkcoll_op(rodsEnv *env, rcComm_t *conn,
     char *path = json_to_collection_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    resolve_target_path(conn, env, &rods_path, path, args, error);
     if (error->code != 0) goto finally;
 
     if (represents_data_object(target)) {
@@ -815,7 +2014,7 @@ json_t *baton_json_rmcoll_op(rodsEnv *env, rcComm_t *conn,
     char *path = json_to_collection_path(target, error);
     if (error->code != 0) goto finally;
 
-    resolve_rods_path(conn, env, &rods_path, path, args->flags, error);
+    resolve_target_path(conn, env, &rods_path, path, args, error);
     if (error->code != 0) goto finally;
 
     if (represents_data_object(target)) {
@@ -841,6 +2040,334 @@ finally:
     return result;
 }
 
+json_t *baton_json_export_op(rodsEnv *env, rcComm_t *conn,
+                             json_t *target, operation_args_t *args,
+                             baton_error_t *error) {
+    json_t *result  = NULL;
+    json_t *summary = NULL;
+    char *file      = NULL;
+    FILE *out       = stdout;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    char *path = json_to_collection_path(target, error);
+    if (error->code != 0) goto finally;
+
+    resolve_target_path(conn, env, &rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    if (represents_data_object(target)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "cannot export a collection given a data object");
+        goto finally;
+    }
+
+    // The archive is saved to the local file named in the target, or
+    // printed to stdout
+    if (args->flags & SAVE_FILES) {
+        if (!json_is_string(json_object_get(target, JSON_FILE_KEY))) {
+            set_baton_error(error, CAT_INVALID_ARGUMENT,
+                            "cannot save an export of '%s' without a "
+                            "local file name", path);
+            goto finally;
+        }
+
+        file = json_to_local_path(target, error);
+        if (error->code != 0) goto finally;
+
+        out = fopen(file, "w");
+        if (!out) {
+            set_baton_error(error, errno,
+                            "Failed to open '%s' for writing: error %d %s",
+                            file, errno, strerror(errno));
+            goto finally;
+        }
+    }
+
+    size_t bsize = args->buffer_size;
+    logmsg(DEBUG, "Using an 'export' buffer size of %zu bytes", bsize);
+
+    summary = export_collection(conn, &rods_path, out, args->flags, bsize,
+                                args->num_streams, error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+        goto finally;
+    }
+    json_object_update(result, summary);
+
+finally:
+    if (out && out != stdout) {
+        if (fclose(out) != 0 && error->code == 0) {
+            set_baton_error(error, errno, "Failed to close '%s': error %d %s",
+                            file, errno, strerror(errno));
+            json_decref(result);
+            result = NULL;
+        }
+    }
+    else {
+        fflush(stdout);
+    }
+    if (summary) json_decref(summary);
+    if (path) free(path);
+    if (file) free(file);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    return result;
+}
+
+json_t *baton_json_bulk_put_op(rodsEnv *env, rcComm_t *conn,
+                               json_t *target, operation_args_t *args,
+                               baton_error_t *error) {
+    json_t *result  = NULL;
+    json_t *summary = NULL;
+    char *dir       = NULL;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    char *path = json_to_collection_path(target, error);
+    if (error->code != 0) goto finally;
+
+    if (represents_data_object(target)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "cannot put files into a data object");
+        goto finally;
+    }
+
+    if (!json_is_string(json_object_get(target, JSON_DIRECTORY_KEY))) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "cannot put files into '%s' without a local "
+                        "directory", path);
+        goto finally;
+    }
+
+    resolve_target_path(conn, env, &rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    dir = json_to_local_path(target, error);
+    if (error->code != 0) goto finally;
+
+    // One line is printed for each file, before the result
+    json_t *files = json_object_get(target, JSON_FILES_KEY);
+    summary = bulk_put_files(conn, &rods_path, dir, files, stdout,
+                             args->flags, error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+        goto finally;
+    }
+
+    // Don't echo the list of files back
+    json_object_del(result, JSON_FILES_KEY);
+    json_object_update(result, summary);
+
+finally:
+    fflush(stdout);
+    if (summary) json_decref(summary);
+    if (path) free(path);
+    if (dir)  free(dir);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    return result;
+}
+
+json_t *baton_json_sync_op(rodsEnv *env, rcComm_t *conn, json_t *target,
+                           operation_args_t *args, baton_error_t *error) {
+    json_t *result  = NULL;
+    json_t *summary = NULL;
+    char *dir       = NULL;
+    rodsPath_t rods_path;
+    memset(&rods_path, 0, sizeof (rodsPath_t));
+
+    char *path = json_to_collection_path(target, error);
+    if (error->code != 0) goto finally;
+
+    if (represents_data_object(target)) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "cannot sync a directory with a data object");
+        goto finally;
+    }
+
+    if (!json_is_string(json_object_get(target, JSON_DIRECTORY_KEY))) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "cannot sync '%s' without a local directory", path);
+        goto finally;
+    }
+
+    resolve_target_path(conn, env, &rods_path, path, args, error);
+    if (error->code != 0) goto finally;
+
+    dir = json_to_local_path(target, error);
+    if (error->code != 0) goto finally;
+
+    // One line is printed for each file, before the result
+    summary = sync_directory(conn, &rods_path, dir, stdout, args->flags,
+                             args->num_streams, args->buffer_size, error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "result for %s", path);
+        goto finally;
+    }
+
+    json_object_update(result, summary);
+
+finally:
+    fflush(stdout);
+    if (summary) json_decref(summary);
+    if (path) free(path);
+    if (dir)  free(dir);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    return result;
+}
+
+// Return true if an operation leaves its target as it was resolved,
+// or records what it left itself, so that a later step of a sequence
+// may reuse the resolution
+static int op_keeps_target_path(const char *op) {
+    const char *keeps[] = { JSON_CHECKSUM_OP, JSON_CHMOD_OP,
+                            JSON_COPY_OP,     JSON_EXPORT_OP,
+                            JSON_GET_OP,      JSON_LIST_OP,
+                            JSON_METAMOD_OP,  JSON_METASUPER_OP,
+                            JSON_PUT_OP,      JSON_REGISTER_OP };
+
+    for (size_t i = 0; i < sizeof keeps / sizeof keeps[0]; i++) {
+        if (str_equals(op, keeps[i], MAX_STR_LEN)) return 1;
+    }
+
+    return 0;
+}
+
+json_t *baton_json_sequence_op(rodsEnv *env, rcComm_t *conn, json_t *target,
+                               operation_args_t *args, baton_error_t *error) {
+    json_t *result = NULL;
+    rodsPath_t local_resolved;
+    memset(&local_resolved, 0, sizeof (rodsPath_t));
+
+    // The caller may keep the resolution of the target beyond the
+    // sequence
+    rodsPath_t *resolved = args->resolved_path ? args->resolved_path :
+                                                 &local_resolved;
+
+    init_baton_error(error);
+
+    if (!args->envelope) {
+        set_baton_error(error, CAT_INVALID_ARGUMENT,
+                        "A sequence must be given in an envelope");
+        goto finally;
+    }
+
+    json_t *seq_args = get_operation_args(args->envelope, error);
+    if (error->code != 0) goto finally;
+
+    json_t *steps = get_op_steps(seq_args, error);
+    if (error->code != 0) goto finally;
+
+    result = json_deep_copy(target);
+    if (!result) {
+        set_baton_error(error, -1, "Internal error: failed to deep-copy "
+                        "the target of a sequence");
+        goto finally;
+    }
+
+    size_t index;
+    json_t *step;
+    json_array_foreach(steps, index, step) {
+        baton_error_t step_error;
+        json_t *step_args = NULL;
+
+        const char *step_op = get_operation(step, &step_error);
+        if (step_error.code == 0 && !step_op) {
+            set_baton_error(&step_error, CAT_INVALID_ARGUMENT,
+                            "No baton operation given");
+        }
+        if (step_error.code == 0 &&
+            str_equals(step_op, JSON_SEQUENCE_OP, MAX_STR_LEN)) {
+            set_baton_error(&step_error, CAT_INVALID_ARGUMENT,
+                            "A sequence may not contain a sequence");
+        }
+        if (step_error.code == 0 && has_operation_args(step)) {
+            step_args = get_operation_args(step, &step_error);
+        }
+        if (step_error.code == 0 &&
+            ((args->flags & STREAM_CONTENTS) || op_stream_p(step_args))) {
+            set_baton_error(&step_error, CAT_INVALID_ARGUMENT,
+                            "Streaming is not supported in a sequence");
+        }
+
+        if (step_error.code != 0) {
+            set_baton_error(error, step_error.code,
+                            "Invalid step %zu of a sequence: %s",
+                            index, step_error.message);
+            goto finally;
+        }
+
+        json_t *step_envelope =
+            json_pack("{s:s, s:o, s:O}", JSON_OP_KEY, step_op,
+                      JSON_OP_ARGS_KEY,
+                      step_args ? json_incref(step_args) : json_object(),
+                      JSON_TARGET_KEY, target);
+        if (!step_envelope) {
+            set_baton_error(error, -1, "Internal error: failed to pack "
+                            "step %zu of a sequence", index);
+            goto finally;
+        }
+
+        // The arguments of the sequence apply to each step, which
+        // shares the resolution of the target path
+        operation_args_t step_opts = *args;
+        step_opts.envelope      = NULL;
+        step_opts.output_done   = 0;
+        step_opts.resolved_path = resolved;
+
+        logmsg(DEBUG, "Running step %zu '%s' of a sequence", index, step_op);
+
+        json_t *step_result = baton_json_dispatch_op(env, conn, step_envelope,
+                                                     &step_opts, &step_error);
+        json_decref(step_envelope);
+
+        if (step_error.code != 0) {
+            if (step_result) json_decref(step_result);
+            set_baton_error(error, step_error.code,
+                            "Failed at step %zu '%s' of a sequence: %s",
+                            index, step_op, step_error.message);
+            goto finally;
+        }
+
+        if (!op_keeps_target_path(step_op)) {
+            if (resolved->rodsObjStat) free(resolved->rodsObjStat);
+            memset(resolved, 0, sizeof (rodsPath_t));
+        }
+
+        if (json_is_object(step_result)) {
+            json_object_update(result, step_result);
+            json_decref(step_result);
+        }
+        else if (step_result) {
+            json_object_set_new(result, step_op, step_result);
+        }
+    }
+
+finally:
+    if (local_resolved.rodsObjStat) free(local_resolved.rodsObjStat);
+
+    if (error->code != 0 && result) {
+        json_decref(result);
+        result = NULL;
+    }
+
+    return result;
+}
+
 int check_str_arg(const char *arg_name, const char *arg_value,
                   size_t arg_size, baton_error_t *error) {
     if (!arg_value) {
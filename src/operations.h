@@ -30,6 +30,10 @@
 #include "config.h"
 #include "signal_handler.h"
 
+// The largest number of consecutive data object listings which may be
+// read ahead and answered together
+#define LOOKAHEAD_MAX_ITEMS 1024
+
 /**
  *  @enum metadata_op
  *  @brief AVU metadata operations.
@@ -92,7 +96,25 @@ typedef enum {
     /** Avoid any operations that contact servers other than rodshost */
     SINGLE_SERVER      = 1 << 20,
     /** Use advisory write lock on server */
-    WRITE_LOCK         = 1 << 21
+    WRITE_LOCK         = 1 << 21,
+    /** Skip transfers where the destination already matches the source */
+    SYNC               = 1 << 22,
+    /** Journal transfers so that they may be resumed */
+    RESUME             = 1 << 23,
+    /** Read a byte range of a data object */
+    BYTE_RANGE         = 1 << 24,
+    /** Stream data object contents into JSON output */
+    STREAM_CONTENTS    = 1 << 25,
+    /** Encode or decode data object contents as base64 */
+    BASE64_ENCODING    = 1 << 26,
+    /** Precede raw data object content with a header giving its length */
+    PRINT_FRAMED       = 1 << 27,
+    /** Remove data objects which have no local file when syncing */
+    SYNC_DELETE        = 1 << 28,
+    /** Act as an iRODS administrator */
+    ADMIN_MODE         = 1 << 29,
+    /** Update stale replicas only, rather than create new ones */
+    UPDATE_STALE       = 1 << 30
 } option_flags;
 
 typedef struct operation_args {
@@ -101,6 +123,35 @@ typedef struct operation_args {
     char *zone_name;
     char *path;
     unsigned long max_connect_time;
+    /** The offset of a BYTE_RANGE */
+    size_t offset;
+    /** The length of a BYTE_RANGE */
+    size_t length;
+    /** The number of leading paths a recursive chmod skips, having
+        done them in an earlier run */
+    size_t resume_from;
+    /** The envelope of the operation, if any */
+    json_t *envelope;
+    /** Set by an operation that has printed its own output */
+    int output_done;
+    /** The number of streams with which to write a data object in
+        single-server mode, or of workers syncing or replicating */
+    size_t num_streams;
+    /** The destination resource of a copy, registration or
+        replication */
+    char *resource;
+    /** A target path already resolved by an earlier step of a
+        sequence, if any. Steps which leave the target as a data
+        object, such as a put, update it. */
+    rodsPath_t *resolved_path;
+    /** The number of consecutive data object listings which may be
+        read ahead and answered together */
+    size_t lookahead;
+    /** Trust targets to exist, skipping their resolution where the
+        operation's own request would find a missing path */
+    int trust_input;
+    /** Write the contents given as data in the target of a put */
+    int inline_data;
 } operation_args_t;
 
 /**
@@ -162,6 +213,18 @@ json_t *baton_json_metamod_op(rodsEnv *env, rcComm_t *conn,
                               json_t *target, operation_args_t *args,
                               baton_error_t *error);
 
+json_t *baton_json_metasuper_op(rodsEnv *env, rcComm_t *conn,
+                                json_t *target, operation_args_t *args,
+                                baton_error_t *error);
+
+json_t *baton_json_bulk_metamod_op(rodsEnv *env, rcComm_t *conn,
+                                  json_t *target, operation_args_t *args,
+                                  baton_error_t *error);
+
+json_t *baton_json_bulk_chmod_op(rodsEnv *env, rcComm_t *conn,
+                                json_t *target, operation_args_t *args,
+                                baton_error_t *error);
+
 json_t *baton_json_get_op(rodsEnv *env, rcComm_t *conn,
                           json_t *target, operation_args_t *args,
                           baton_error_t *error);
@@ -178,6 +241,18 @@ json_t *baton_json_move_op(rodsEnv *env, rcComm_t *conn,
                            json_t *target, operation_args_t *args,
                            baton_error_t *error);
 
+json_t *baton_json_copy_op(rodsEnv *env, rcComm_t *conn,
+                           json_t *target, operation_args_t *args,
+                           baton_error_t *error);
+
+json_t *baton_json_register_op(rodsEnv *env, rcComm_t *conn,
+                               json_t *target, operation_args_t *args,
+                               baton_error_t *error);
+
+json_t *baton_json_replicate_op(rodsEnv *env, rcComm_t *conn,
+                                json_t *target, operation_args_t *args,
+                                baton_error_t *error);
+
 json_t *baton_json_rm_op(rodsEnv *env, rcComm_t *conn,
                          json_t *target, operation_args_t *args,
                          baton_error_t *error);
@@ -190,6 +265,22 @@ json_t *baton_json_rmcoll_op(rodsEnv *env, rcComm_t *conn,
                              json_t *target, operation_args_t *args,
                              baton_error_t *error);
 
+json_t *baton_json_export_op(rodsEnv *env, rcComm_t *conn,
+                             json_t *target, operation_args_t *args,
+                             baton_error_t *error);
+
+json_t *baton_json_bulk_put_op(rodsEnv *env, rcComm_t *conn,
+                               json_t *target, operation_args_t *args,
+                               baton_error_t *error);
+
+json_t *baton_json_sequence_op(rodsEnv *env, rcComm_t *conn,
+                               json_t *target, operation_args_t *args,
+                               baton_error_t *error);
+
+json_t *baton_json_sync_op(rodsEnv *env, rcComm_t *conn,
+                           json_t *target, operation_args_t *args,
+                           baton_error_t *error);
+
 int check_str_arg(const char *arg_name, const char *arg_value,
                   size_t arg_size, baton_error_t *error);
 
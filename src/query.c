@@ -388,6 +388,17 @@ genQueryInp_t *limit_to_good_repl(genQueryInp_t *query_in) {
     return add_query_conds(query_in, num_conds, (query_cond_t []) { rs });
 }
 
+genQueryInp_t *add_select_modifier(genQueryInp_t *query_in, int column,
+                                   int modifier) {
+    for (int i = 0; i < query_in->selectInp.len; i++) {
+        if (query_in->selectInp.inx[i] == column) {
+            query_in->selectInp.value[i] |= modifier;
+        }
+    }
+
+    return query_in;
+}
+
 genQueryInp_t *prepare_obj_acl_search(genQueryInp_t *query_in,
                                       const char *user,
                                       const char *access_level) {
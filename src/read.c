@@ -20,9 +20,13 @@
  */
 
 #include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "config.h"
+#include "checksum_cache.h"
 #include "compat_checksum.h"
+#include "journal.h"
 #include "read.h"
 
 static char *do_slurp(rcComm_t *conn, rodsPath_t *rods_path,
@@ -64,6 +68,31 @@ error:
     return NULL;
 }
 
+static int add_content_json(json_t *results, const char *content,
+                            rodsPath_t *rods_path, baton_error_t *error) {
+    size_t len = strlen(content);
+
+    if (!utf8_valid(content, len)) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "The contents of '%s' cannot be encoded as UTF-8 "
+                        "for JSON output", rods_path->outPath);
+        goto finally;
+    }
+
+    // Already validated, so not validated again by jansson
+    json_t *packed = json_stringn_nocheck(content, len);
+    if (!packed) {
+        set_baton_error(error, -1, "Failed to pack the %zu byte contents "
+                        "of '%s' as JSON", len, rods_path->outPath);
+        goto finally;
+    }
+
+    json_object_set_new(results, JSON_DATA_KEY, packed);
+
+finally:
+    return error->code;
+}
+
 json_t *ingest_data_obj(rcComm_t *conn, rodsPath_t *rods_path,
                         option_flags flags, size_t buffer_size,
                         baton_error_t *error) {
@@ -88,35 +117,104 @@ json_t *ingest_data_obj(rcComm_t *conn, rodsPath_t *rods_path,
     json_t *results = list_path(conn, rods_path, flags, error);
     if (error->code != 0) goto error;
 
+    if (flags & BASE64_ENCODING) {
+        // Encoded while being read, avoiding a copy of the raw contents
+        size_t size  = 0;
+        FILE *stream = open_memstream(&content, &size);
+        if (!stream) {
+            set_baton_error(error, errno, "Failed to open a memory stream: "
+                            "error %d %s", errno, strerror(errno));
+            goto error;
+        }
+
+        get_data_obj_json_stream(conn, rods_path, stream, flags, buffer_size,
+                                 error);
+        fclose(stream);
+        if (error->code != 0) goto error;
+
+        json_object_set_new(results, JSON_ENCODING_KEY,
+                            json_string(JSON_ENCODING_BASE64));
+        json_object_set_new(results, JSON_DATA_KEY, json_string(content));
+        free(content);
+
+        return results;
+    }
+
     content = do_slurp(conn, rods_path, buffer_size, error);
     if (error->code != 0) goto error;
 
     if (content) {
-        size_t len = strlen(content);
-
-        if (maybe_utf8(content, len)) {
-            json_t *packed = json_pack("s", content);
-            if (!packed) {
-                set_baton_error(error, -1,
-                                "Failed to pack the %zu byte contents "
-                                "of '%s' as JSON", len, rods_path->outPath);
-                goto error;
-            }
+        add_content_json(results, content, rods_path, error);
+        if (error->code != 0) goto error;
 
-            json_object_set_new(results, JSON_DATA_KEY, packed);
-        }
-        else {
-            set_baton_error(error, USER_INPUT_PATH_ERR,
-                            "The contents of '%s' cannot be encoded as UTF-8 "
-                            "for JSON output", rods_path->outPath);
+        free(content);
+    }
+
+    return results;
+
+error:
+    if (content) free(content);
+
+    return NULL;
+}
+
+json_t *ingest_data_obj_range(rcComm_t *conn, rodsPath_t *rods_path,
+                              option_flags flags, size_t offset,
+                              size_t length, size_t buffer_size,
+                              baton_error_t *error) {
+    json_t *results = NULL;
+    char *content   = NULL;
+    size_t size     = 0;
+
+    init_baton_error(error);
+
+    results = list_path(conn, rods_path, flags, error);
+    if (error->code != 0) goto error;
+
+    // The range is bounded by length, so it is collected in memory
+    FILE *stream = open_memstream(&content, &size);
+    if (!stream) {
+        set_baton_error(error, errno, "Failed to open a memory stream: "
+                        "error %d %s", errno, strerror(errno));
+        goto error;
+    }
+
+    get_data_obj_range_stream(conn, rods_path, stream, offset, length,
+                              buffer_size, error);
+    int status = fclose(stream);
+
+    if (error->code != 0) goto error;
+    if (status != 0) {
+        set_baton_error(error, errno, "Failed to close a memory stream: "
+                        "error %d %s", errno, strerror(errno));
+        goto error;
+    }
+
+    if (flags & BASE64_ENCODING) {
+        char *encoded = calloc(BASE64_ENCODED_LEN(size), sizeof (char));
+        if (!encoded) {
+            set_baton_error(error, errno, "Failed to allocate memory: "
+                            "error %d %s", errno, strerror(errno));
             goto error;
         }
-        free(content);
+        base64_encode(content, size, encoded);
+
+        json_object_set_new(results, JSON_ENCODING_KEY,
+                            json_string(JSON_ENCODING_BASE64));
+        json_object_set_new(results, JSON_DATA_KEY, json_string(encoded));
+        free(encoded);
+    }
+    else {
+        add_content_json(results, content, rods_path, error);
+        if (error->code != 0) goto error;
     }
 
+    free(content);
+
     return results;
 
 error:
+    if (results) json_decref(results);
     if (content) free(content);
 
     return NULL;
@@ -150,6 +248,16 @@ data_obj_file_t *open_data_obj(rcComm_t *conn, rodsPath_t *rods_path,
 
         case (O_WRONLY):
           obj_open_in.openFlags  = O_WRONLY;
+
+          if (flags & RESUME) {
+              // Reopen an existing data object without truncating it,
+              // so that a transfer may continue from an offset
+              logmsg(DEBUG, "Reopening '%s' to resume writing",
+                     rods_path->outPath);
+              descriptor = rcDataObjOpen(conn, &obj_open_in);
+              break;
+          }
+
           obj_open_in.createMode = 0750;
           obj_open_in.dataSize   = 0;
           addKeyVal(&obj_open_in.condInput, FORCE_FLAG_KW, "");
@@ -213,6 +321,44 @@ void free_data_obj(data_obj_file_t *data_obj) {
     free(data_obj);
 }
 
+size_t seek_data_obj(rcComm_t *conn, data_obj_file_t *data_obj,
+                     size_t offset, baton_error_t *error) {
+    openedDataObjInp_t obj_lseek_in;
+    fileLseekOut_t *obj_lseek_out = NULL;
+    size_t position = 0;
+
+    init_baton_error(error);
+
+    memset(&obj_lseek_in, 0, sizeof obj_lseek_in);
+    obj_lseek_in.l1descInx = data_obj->open_obj->l1descInx;
+    obj_lseek_in.offset    = offset;
+    obj_lseek_in.whence    = SEEK_SET;
+
+    logmsg(DEBUG, "Seeking to offset %zu in '%s'", offset, data_obj->path);
+
+    int status = rcDataObjLseek(conn, &obj_lseek_in, &obj_lseek_out);
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to seek to offset %zu in '%s': %s",
+                        offset, data_obj->path, err_name);
+        goto finally;
+    }
+
+    position = obj_lseek_out->offset;
+    if (position != offset) {
+        set_baton_error(error, -1, "Failed to seek to offset %zu in '%s': "
+                        "reached offset %zu", offset, data_obj->path,
+                        position);
+    }
+
+finally:
+    if (obj_lseek_out) free(obj_lseek_out);
+
+    return position;
+}
+
 size_t read_chunk(rcComm_t *conn, data_obj_file_t *data_obj, char *buffer,
                   size_t len, baton_error_t *error) {
     init_baton_error(error);
@@ -322,6 +468,247 @@ finally:
     return num_written;
 }
 
+size_t read_data_obj_json(rcComm_t *conn, data_obj_file_t *data_obj,
+                          FILE *out, size_t buffer_size,
+                          baton_error_t *error) {
+    size_t num_read = 0;
+    char *buffer    = NULL;
+
+    init_baton_error(error);
+
+    if (buffer_size == 0) {
+        set_baton_error(error, -1, "Invalid buffer_size argument %zu",
+                        buffer_size);
+        goto finally;
+    }
+
+    // Space for the incomplete UTF-8 character, of up to 3 bytes,
+    // which may be carried over from the end of the previous chunk
+    const size_t max_carry = 3;
+    buffer = calloc(buffer_size + max_carry + 1, sizeof (char));
+    if (!buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    unsigned char digest[16];
+    EVP_MD_CTX *context = compat_MD5Init(error);
+    if (error->code != 0) goto finally;
+
+    size_t carry = 0;
+    size_t nr;
+    while ((nr = read_chunk(conn, data_obj, buffer + carry, buffer_size,
+                            error)) > 0) {
+        compat_MD5Update(context, (unsigned char *) buffer + carry, nr,
+                         error);
+        if (error->code != 0) goto finally;
+
+        num_read += nr;
+
+        size_t len = carry + nr;
+        size_t complete;
+        if (!utf8_chunk_valid(buffer, len, &complete)) {
+            set_baton_error(error, USER_INPUT_PATH_ERR,
+                            "The contents of '%s' cannot be encoded as UTF-8 "
+                            "for JSON output", data_obj->path);
+            MD5_FREE(context);
+            goto finally;
+        }
+
+        if (print_json_escaped(buffer, complete, out) != 0) {
+            set_baton_error(error, errno,
+                            "Failed to write to stream: error %d %s",
+                            errno, strerror(errno));
+            MD5_FREE(context);
+            goto finally;
+        }
+
+        carry = len - complete;
+        memmove(buffer, buffer + complete, carry);
+    }
+    if (error->code != 0) {
+        MD5_FREE(context);
+        goto finally;
+    }
+
+    if (carry > 0) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "The contents of '%s' end with an incomplete UTF-8 "
+                        "character", data_obj->path);
+        MD5_FREE(context);
+        goto finally;
+    }
+
+    compat_MD5Final(digest, context, error);
+    if (error->code != 0) goto finally;
+    MD5_FREE(context);
+
+    set_md5_last_read(data_obj, digest);
+
+    if (!validate_md5_last_read(conn, data_obj)) {
+        logmsg(WARN, "Checksum mismatch for '%s' having MD5 %s on reading",
+               data_obj->path, data_obj->md5_last_read);
+    }
+
+    logmsg(NOTICE, "Wrote %zu bytes from '%s' to JSON stream having MD5 %s",
+           num_read, data_obj->path, data_obj->md5_last_read);
+
+finally:
+    if (buffer) free(buffer);
+
+    return num_read;
+}
+
+size_t read_data_obj_base64(rcComm_t *conn, data_obj_file_t *data_obj,
+                            FILE *out, size_t buffer_size,
+                            baton_error_t *error) {
+    size_t num_read = 0;
+    char *buffer    = NULL;
+    char *encoded   = NULL;
+
+    init_baton_error(error);
+
+    if (buffer_size == 0) {
+        set_baton_error(error, -1, "Invalid buffer_size argument %zu",
+                        buffer_size);
+        goto finally;
+    }
+
+    // Space for up to 2 bytes, short of a whole base64 group, which may
+    // be carried over from the end of the previous chunk
+    const size_t max_carry = 2;
+    buffer  = calloc(buffer_size + max_carry, sizeof (char));
+    encoded = calloc(BASE64_ENCODED_LEN(buffer_size + max_carry),
+                     sizeof (char));
+    if (!buffer || !encoded) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    unsigned char digest[16];
+    EVP_MD_CTX *context = compat_MD5Init(error);
+    if (error->code != 0) goto finally;
+
+    size_t carry = 0;
+    size_t nr;
+    while ((nr = read_chunk(conn, data_obj, buffer + carry, buffer_size,
+                            error)) > 0) {
+        compat_MD5Update(context, (unsigned char *) buffer + carry, nr,
+                         error);
+        if (error->code != 0) goto finally;
+
+        num_read += nr;
+
+        size_t len = carry + nr;
+        size_t complete = len - len % 3;
+        size_t ne = base64_encode(buffer, complete, encoded);
+
+        if (fwrite(encoded, 1, ne, out) != ne) {
+            set_baton_error(error, errno,
+                            "Failed to write to stream: error %d %s",
+                            errno, strerror(errno));
+            MD5_FREE(context);
+            goto finally;
+        }
+
+        carry = len - complete;
+        memmove(buffer, buffer + complete, carry);
+    }
+    if (error->code != 0) {
+        MD5_FREE(context);
+        goto finally;
+    }
+
+    // The final, padded group
+    size_t ne = base64_encode(buffer, carry, encoded);
+    if (fwrite(encoded, 1, ne, out) != ne) {
+        set_baton_error(error, errno, "Failed to write to stream: error %d %s",
+                        errno, strerror(errno));
+        MD5_FREE(context);
+        goto finally;
+    }
+
+    compat_MD5Final(digest, context, error);
+    if (error->code != 0) goto finally;
+    MD5_FREE(context);
+
+    set_md5_last_read(data_obj, digest);
+
+    if (!validate_md5_last_read(conn, data_obj)) {
+        logmsg(WARN, "Checksum mismatch for '%s' having MD5 %s on reading",
+               data_obj->path, data_obj->md5_last_read);
+    }
+
+    logmsg(NOTICE, "Wrote %zu bytes from '%s' to base64 stream having MD5 %s",
+           num_read, data_obj->path, data_obj->md5_last_read);
+
+finally:
+    if (buffer)  free(buffer);
+    if (encoded) free(encoded);
+
+    return num_read;
+}
+
+size_t read_data_obj_range(rcComm_t *conn, data_obj_file_t *data_obj,
+                           FILE *out, size_t offset, size_t length,
+                           size_t buffer_size, baton_error_t *error) {
+    size_t num_written = 0;
+    char *buffer       = NULL;
+
+    init_baton_error(error);
+
+    if (buffer_size == 0) {
+        set_baton_error(error, -1, "Invalid buffer_size argument %zu",
+                        buffer_size);
+        goto finally;
+    }
+
+    if (offset > 0) {
+        seek_data_obj(conn, data_obj, offset, error);
+        if (error->code != 0) goto finally;
+    }
+
+    // Don't allocate more than the range requires
+    size_t bsize = length < buffer_size ? length : buffer_size;
+    buffer = calloc(bsize + 1, sizeof (char));
+    if (!buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    size_t remaining = length;
+    while (remaining > 0) {
+        size_t len = remaining < bsize ? remaining : bsize;
+        size_t nr = read_chunk(conn, data_obj, buffer, len, error);
+        if (error->code != 0 || nr == 0) goto finally;
+
+        logmsg(DEBUG, "Writing %zu bytes from '%s' to stream",
+               nr, data_obj->path);
+
+        if (fwrite(buffer, 1, nr, out) != nr) {
+            set_baton_error(error, errno,
+                            "Failed to write to stream: error %d %s",
+                            errno, strerror(errno));
+            goto finally;
+        }
+
+        num_written += nr;
+        remaining   -= nr;
+    }
+
+finally:
+    if (error->code == 0) {
+        logmsg(NOTICE, "Wrote %zu bytes from offset %zu of '%s' to stream",
+               num_written, offset, data_obj->path);
+    }
+    if (buffer) free(buffer);
+
+    return num_written;
+}
+
 char *slurp_data_obj(rcComm_t *conn, data_obj_file_t *data_obj,
                      size_t buffer_size, baton_error_t *error) {
     char *buffer  = NULL;
@@ -504,6 +891,386 @@ error:
     return error->code;
 }
 
+int get_data_obj_json_stream(rcComm_t *conn, rodsPath_t *rods_path,
+                             FILE *out, option_flags flags,
+                             size_t buffer_size, baton_error_t *error) {
+    data_obj_file_t *data_obj = NULL;
+
+    init_baton_error(error);
+
+    if (rods_path->objType != DATA_OBJ_T) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot read the contents of '%s' because "
+                        "it is not a data object", rods_path->outPath);
+        goto finally;
+    }
+
+    logmsg(DEBUG, "Writing '%s' to a JSON stream", rods_path->outPath);
+
+    data_obj = open_data_obj(conn, rods_path, O_RDONLY, 0, error);
+    if (error->code != 0) goto finally;
+
+    if (flags & BASE64_ENCODING) {
+        read_data_obj_base64(conn, data_obj, out, buffer_size, error);
+    }
+    else {
+        read_data_obj_json(conn, data_obj, out, buffer_size, error);
+    }
+    int status = close_data_obj(conn, data_obj);
+
+    if (error->code != 0) goto finally;
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to close data object: '%s' error %d %s",
+                        rods_path->outPath, status, err_name);
+    }
+
+finally:
+    if (data_obj) free_data_obj(data_obj);
+
+    return error->code;
+}
+
+int get_data_obj_range_file(rcComm_t *conn, rodsPath_t *rods_path,
+                            const char *local_path, size_t offset,
+                            size_t length, size_t buffer_size,
+                            baton_error_t *error) {
+    init_baton_error(error);
+
+    logmsg(DEBUG, "Writing '%s' to '%s'", rods_path->outPath, local_path);
+
+    FILE *stream = fopen(local_path, "w");
+    if (!stream) {
+        set_baton_error(error, errno,
+                        "Failed to open '%s' for writing: error %d %s",
+                        local_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    get_data_obj_range_stream(conn, rods_path, stream, offset, length,
+                              buffer_size, error);
+    int status = fclose(stream);
+
+    if (error->code != 0) goto finally;
+    if (status != 0) {
+        set_baton_error(error, errno,
+                        "Failed to close '%s': error %d %s",
+                        local_path, errno, strerror(errno));
+    }
+
+finally:
+    return error->code;
+}
+
+int get_data_obj_range_stream(rcComm_t *conn, rodsPath_t *rods_path,
+                              FILE *out, size_t offset, size_t length,
+                              size_t buffer_size, baton_error_t *error) {
+    data_obj_file_t *data_obj = NULL;
+    int                 flags = 0;
+
+    init_baton_error(error);
+
+    if (rods_path->objType != DATA_OBJ_T) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot write the contents of '%s' because "
+                        "it is not a data object", rods_path->outPath);
+        goto finally;
+    }
+
+    logmsg(DEBUG, "Writing %zu bytes from offset %zu of '%s' to a stream",
+           length, offset, rods_path->outPath);
+
+    data_obj = open_data_obj(conn, rods_path, O_RDONLY, flags, error);
+    if (error->code != 0) goto finally;
+
+    read_data_obj_range(conn, data_obj, out, offset, length, buffer_size,
+                        error);
+    int status = close_data_obj(conn, data_obj);
+
+    if (error->code != 0) goto finally;
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to close data object: '%s' error %d %s",
+                        rods_path->outPath, status, err_name);
+    }
+
+finally:
+    if (data_obj) free_data_obj(data_obj);
+
+    return error->code;
+}
+
+int get_data_obj_framed_stream(rcComm_t *conn, rodsPath_t *rods_path,
+                               FILE *out, size_t offset, size_t length,
+                               size_t buffer_size, baton_error_t *error) {
+    data_obj_file_t *data_obj = NULL;
+    json_t *header            = NULL;
+    char *header_str          = NULL;
+    char *padding             = NULL;
+
+    init_baton_error(error);
+
+    if (rods_path->objType != DATA_OBJ_T || !rods_path->rodsObjStat) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot write the contents of '%s' because "
+                        "it is not a data object", rods_path->outPath);
+        goto finally;
+    }
+
+    data_obj = open_data_obj(conn, rods_path, O_RDONLY, 0, error);
+    if (error->code != 0) goto finally;
+
+    // The frame length is fixed before any bytes are written, as the
+    // catalog size clipped to the requested range
+    size_t size = rods_path->rodsObjStat->objSize;
+    size_t frame_len = 0;
+    if (offset < size) {
+        frame_len = size - offset < length ? size - offset : length;
+    }
+
+    header = json_pack("{s:{s:s, s:I, s:I}}", JSON_FRAME_KEY,
+                       JSON_PATH_KEY,   rods_path->outPath,
+                       JSON_OFFSET_KEY, (json_int_t) offset,
+                       JSON_LENGTH_KEY, (json_int_t) frame_len);
+    if (!header) {
+        set_baton_error(error, -1, "Failed to pack the frame header of '%s'",
+                        rods_path->outPath);
+        goto finally;
+    }
+
+    // A catalog checksum describes only the whole object
+    const char *chksum = rods_path->rodsObjStat->chksum;
+    if (offset == 0 && frame_len == size && strnlen(chksum, NAME_LEN) > 0) {
+        json_object_set_new(json_object_get(header, JSON_FRAME_KEY),
+                            JSON_CHECKSUM_KEY, json_string(chksum));
+    }
+
+    header_str = json_dumps(header, JSON_COMPACT);
+    if (!header_str) {
+        set_baton_error(error, -1, "Failed to encode the frame header "
+                        "of '%s'", rods_path->outPath);
+        goto finally;
+    }
+
+    fprintf(out, "%s\n", header_str);
+
+    baton_error_t read_error;
+    size_t nw = read_data_obj_range(conn, data_obj, out, offset, frame_len,
+                                    buffer_size, &read_error);
+
+    // Having promised frame_len bytes, the frame is completed with NUL
+    // padding if fewer could be read, so that the reader may continue
+    // with the next record. The error is reported in the result.
+    if (nw < frame_len) {
+        size_t remaining = frame_len - nw;
+        size_t plen = remaining < buffer_size ? remaining : buffer_size;
+        padding = calloc(plen, sizeof (char));
+        if (!padding) {
+            set_baton_error(error, errno, "Failed to allocate memory: "
+                            "error %d %s", errno, strerror(errno));
+            goto finally;
+        }
+
+        while (remaining > 0) {
+            size_t n = remaining < plen ? remaining : plen;
+            if (fwrite(padding, 1, n, out) != n) break;
+            remaining -= n;
+        }
+
+        if (read_error.code != 0) {
+            set_baton_error(error, read_error.code, "%s", read_error.message);
+        }
+        else {
+            set_baton_error(error, -1, "Read %zu of %zu bytes from '%s'; "
+                            "the frame was padded", nw, frame_len,
+                            rods_path->outPath);
+        }
+        goto finally;
+    }
+
+    if (read_error.code != 0) {
+        set_baton_error(error, read_error.code, "%s", read_error.message);
+        goto finally;
+    }
+
+    int status = close_data_obj(conn, data_obj);
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to close data object: '%s' error %d %s",
+                        rods_path->outPath, status, err_name);
+    }
+    free_data_obj(data_obj);
+    data_obj = NULL;
+
+finally:
+    if (data_obj) {
+        close_data_obj(conn, data_obj);
+        free_data_obj(data_obj);
+    }
+    if (header)     json_decref(header);
+    if (header_str) free(header_str);
+    if (padding)    free(padding);
+
+    return error->code;
+}
+
+int get_data_obj_file_resumable(rcComm_t *conn, rodsPath_t *rods_path,
+                                const char *local_path, size_t buffer_size,
+                                baton_error_t *error) {
+    transfer_journal_t *journal = NULL;
+    data_obj_file_t *data_obj   = NULL;
+    EVP_MD_CTX *context         = NULL;
+    char *buffer                = NULL;
+    char *identity              = NULL;
+    FILE *stream                = NULL;
+    int flags                   = 0;
+
+    init_baton_error(error);
+
+    if (buffer_size == 0) {
+        set_baton_error(error, -1, "Invalid buffer_size argument %zu",
+                        buffer_size);
+        goto finally;
+    }
+
+    if (rods_path->objType != DATA_OBJ_T) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot write the contents of '%s' because "
+                        "it is not a data object", rods_path->outPath);
+        goto finally;
+    }
+
+    // The journal is valid only while the data object is unchanged
+    long long obj_size = -1;
+    const char *modify_time = "";
+    if (rods_path->rodsObjStat) {
+        obj_size    = rods_path->rodsObjStat->objSize;
+        modify_time = rods_path->rodsObjStat->modifyTime;
+    }
+
+    const char *format = "get %lld %s %s";
+    int len = snprintf(NULL, 0, format, obj_size, modify_time,
+                       rods_path->outPath);
+    identity = calloc(len + 1, sizeof (char));
+    if (!identity) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+    snprintf(identity, len + 1, format, obj_size, modify_time,
+             rods_path->outPath);
+
+    journal = open_transfer_journal(local_path, identity, error);
+    if (error->code != 0) goto finally;
+
+    // Open without truncating, so that a partial file may be resumed
+    int fd = open(local_path, O_RDWR | O_CREAT, 0666);
+    if (fd < 0 || !(stream = fdopen(fd, "r+"))) {
+        set_baton_error(error, errno,
+                        "Failed to open '%s' for writing: error %d %s",
+                        local_path, errno, strerror(errno));
+        if (fd >= 0) close(fd);
+        goto finally;
+    }
+
+    unsigned char digest[16];
+    context = compat_MD5Init(error);
+    if (error->code != 0) goto finally;
+
+    size_t offset = validate_transfer_journal(journal, stream, context,
+                                              buffer_size, error);
+    if (error->code != 0) goto finally;
+
+    // Discard any bytes beyond those validated
+    if (ftruncate(fileno(stream), offset) != 0) {
+        set_baton_error(error, errno,
+                        "Failed to truncate '%s' to %zu bytes: error %d %s",
+                        local_path, offset, errno, strerror(errno));
+        goto finally;
+    }
+
+    data_obj = open_data_obj(conn, rods_path, O_RDONLY, flags, error);
+    if (error->code != 0) goto finally;
+
+    if (offset > 0) {
+        logmsg(NOTICE, "Resuming get of '%s' to '%s' at offset %zu",
+               rods_path->outPath, local_path, offset);
+        seek_data_obj(conn, data_obj, offset, error);
+        if (error->code != 0) goto finally;
+    }
+
+    buffer = calloc(buffer_size + 1, sizeof (char));
+    if (!buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    size_t nr;
+    while ((nr = read_chunk(conn, data_obj, buffer, buffer_size, error)) > 0) {
+        if (fwrite(buffer, 1, nr, stream) != nr || fflush(stream) != 0) {
+            set_baton_error(error, errno,
+                            "Failed to write to '%s': error %d %s",
+                            local_path, errno, strerror(errno));
+            goto finally;
+        }
+
+        compat_MD5Update(context, (unsigned char *) buffer, nr, error);
+        if (error->code != 0) {
+            context = NULL;
+            goto finally;
+        }
+
+        // A chunk is journalled only once it is safely in the local file
+        journal_chunk(journal, offset, buffer, nr, error);
+        if (error->code != 0) goto finally;
+
+        offset += nr;
+    }
+    if (error->code != 0) goto finally;
+
+    compat_MD5Final(digest, context, error);
+    if (error->code != 0) {
+        context = NULL;
+        goto finally;
+    }
+    set_md5_last_read(data_obj, digest);
+
+    int status = fclose(stream);
+    stream = NULL;
+    if (status != 0) {
+        set_baton_error(error, errno, "Failed to close '%s': error %d %s",
+                        local_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    verify_data_obj_checksum(conn, rods_path->outPath, local_path,
+                             data_obj->md5_last_read, 0, error);
+    if (error->code != 0) goto finally;
+
+    logmsg(NOTICE, "Wrote %zu bytes from '%s' to '%s' having MD5 %s",
+           offset, rods_path->outPath, local_path, data_obj->md5_last_read);
+
+finally:
+    if (data_obj) {
+        close_data_obj(conn, data_obj);
+        free_data_obj(data_obj);
+    }
+    if (stream)   fclose(stream);
+    if (context)  MD5_FREE(context);
+    if (journal)  close_transfer_journal(journal, error->code == 0);
+    if (identity) free(identity);
+    if (buffer)   free(buffer);
+
+    return error->code;
+}
+
 char *checksum_data_obj(rcComm_t *conn, rodsPath_t *rods_path,
                         option_flags flags, baton_error_t *error) {
     char *checksum = NULL;
@@ -623,3 +1390,61 @@ finally:
 
     return status;
 }
+
+int verify_data_obj_checksum(rcComm_t *conn, const char *obj_path,
+                             const char *local_path, const char *md5,
+                             int force, baton_error_t *error) {
+    dataObjInp_t obj_chk_in;
+    char *checksum = NULL;
+
+    init_baton_error(error);
+
+    memset(&obj_chk_in, 0, sizeof obj_chk_in);
+    snprintf(obj_chk_in.objPath, MAX_NAME_LEN, "%s", obj_path);
+
+    if (force) {
+        addKeyVal(&obj_chk_in.condInput, FORCE_CHKSUM_KW, "");
+    }
+
+    int status = rcDataObjChksum(conn, &obj_chk_in, &checksum);
+    clearKeyVal(&obj_chk_in.condInput);
+
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to get the checksum of '%s': %d %s",
+                        obj_path, status, err_name);
+        goto finally;
+    }
+
+    size_t prefix_len = strlen(CHECKSUM_SHA256_PREFIX);
+    if (str_starts_with(checksum, CHECKSUM_SHA256_PREFIX, prefix_len)) {
+        // The server uses SHA256, so the local file must be read again
+        char chksum[NAME_LEN];
+        checksum_local_file(local_path, CHECKSUM_ALGORITHM_SHA256, chksum,
+                            error);
+        if (error->code != 0) goto finally;
+
+        logmsg(DEBUG, "Comparing local checksum '%s' of '%s' with "
+               "checksum '%s' of '%s'", chksum, local_path, checksum,
+               obj_path);
+        status = str_equals(chksum, checksum, NAME_LEN);
+    }
+    else {
+        logmsg(DEBUG, "Comparing MD5 '%s' of '%s' with checksum '%s' "
+               "of '%s'", md5, local_path, checksum, obj_path);
+        status = str_equals_ignore_case(md5, checksum, 32);
+    }
+
+    if (!status) {
+        set_baton_error(error, -1, "Checksum mismatch between '%s' and "
+                        "'%s' having checksum %s", local_path, obj_path,
+                        checksum);
+    }
+
+finally:
+    if (checksum) free(checksum);
+
+    return error->code;
+}
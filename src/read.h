@@ -56,8 +56,9 @@ typedef struct data_obj_file {
  * @param[in]  conn       An open iRODS connection.
  * @param[in]  rods_path  An iRODS data object path.
  * @param[in]  open_flag  O_RDONLY or O_WRONLY.
- * @param[in]  flags      WRITE_LOCK to use an advisory lock server-side.
- *                        Optional.
+ * @param[in]  flags      WRITE_LOCK to use an advisory lock server-side,
+ *                        RESUME to reopen an existing data object for
+ *                        writing without truncating it. Optional.
  * @param[out] error      An error report struct.
  *
  * @return A new struct, which must be freed by the caller.
@@ -69,6 +70,20 @@ int close_data_obj(rcComm_t *conn, data_obj_file_t *obj_file);
 
 void free_data_obj(data_obj_file_t *obj_file);
 
+/**
+ * Set the offset of a data object handle, from the start of the data
+ * object.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  obj_file   A data object handle.
+ * @param[in]  offset     The offset in bytes.
+ * @param[out] error      An error report struct.
+ *
+ * @return The new offset.
+ */
+size_t seek_data_obj(rcComm_t *conn, data_obj_file_t *obj_file,
+                     size_t offset, baton_error_t *error);
+
 /**
  * Read bytes from a data object into a buffer.
  *
@@ -97,6 +112,57 @@ size_t read_chunk(rcComm_t *conn, data_obj_file_t *obj_file,
 size_t read_data_obj(rcComm_t *conn, data_obj_file_t *obj_file, FILE *out,
                      size_t buffer_size, baton_error_t *error);
 
+/**
+ * Read a data object and write its contents to a stream, validated as
+ * UTF-8 and escaped as the contents of a JSON string. Memory use is
+ * bounded by the buffer size.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  obj_file    A data object handle.
+ * @param[in]  out         A file to write to.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[out] error       An error report struct.
+ *
+ * @return The number of bytes read in total.
+ */
+size_t read_data_obj_json(rcComm_t *conn, data_obj_file_t *obj_file,
+                          FILE *out, size_t buffer_size,
+                          baton_error_t *error);
+
+/**
+ * Read a data object and write its contents to a stream, encoded as
+ * base64. Memory use is bounded by the buffer size.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  obj_file    A data object handle.
+ * @param[in]  out         A file to write to.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[out] error       An error report struct.
+ *
+ * @return The number of bytes read in total.
+ */
+size_t read_data_obj_base64(rcComm_t *conn, data_obj_file_t *obj_file,
+                            FILE *out, size_t buffer_size,
+                            baton_error_t *error);
+
+/**
+ * Read a range of bytes from a data object and write to a stream.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  obj_file    A data object handle.
+ * @param[in]  out         A file to write to.
+ * @param[in]  offset      The offset of the first byte to read.
+ * @param[in]  length      The maximum number of bytes to read. Fewer are
+ *                         read if the data object ends first.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[out] error       An error report struct.
+ *
+ * @return The number of bytes copied in total.
+ */
+size_t read_data_obj_range(rcComm_t *conn, data_obj_file_t *obj_file,
+                           FILE *out, size_t offset, size_t length,
+                           size_t buffer_size, baton_error_t *error);
+
 /**
  * Read a data object to a new byte string.
  *
@@ -116,6 +182,11 @@ json_t *ingest_data_obj(rcComm_t *conn, rodsPath_t *rods_path,
                         option_flags flags,
                         size_t buffer_size, baton_error_t *error);
 
+json_t *ingest_data_obj_range(rcComm_t *conn, rodsPath_t *rods_path,
+                              option_flags flags, size_t offset,
+                              size_t length, size_t buffer_size,
+                              baton_error_t *error);
+
 int get_data_obj_file(rcComm_t *conn, rodsPath_t *rods_path,
                       const char *local_path, size_t buffer_size,
                       baton_error_t *error);
@@ -123,6 +194,77 @@ int get_data_obj_file(rcComm_t *conn, rodsPath_t *rods_path,
 int get_data_obj_stream(rcComm_t *conn, rodsPath_t *rods_path, FILE *out,
                         size_t buffer_size, baton_error_t *error);
 
+/**
+ * Read a data object and write its contents to a stream, in a form
+ * which may be used as the contents of a JSON string.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  rods_path   An iRODS data object path.
+ * @param[in]  out         A file to write to.
+ * @param[in]  flags       BASE64_ENCODING to encode the contents as
+ *                         base64, otherwise they are validated as UTF-8
+ *                         and escaped.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[out] error       An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int get_data_obj_json_stream(rcComm_t *conn, rodsPath_t *rods_path,
+                             FILE *out, option_flags flags,
+                             size_t buffer_size, baton_error_t *error);
+
+int get_data_obj_range_file(rcComm_t *conn, rodsPath_t *rods_path,
+                            const char *local_path, size_t offset,
+                            size_t length, size_t buffer_size,
+                            baton_error_t *error);
+
+int get_data_obj_range_stream(rcComm_t *conn, rodsPath_t *rods_path,
+                              FILE *out, size_t offset, size_t length,
+                              size_t buffer_size, baton_error_t *error);
+
+/**
+ * Write a data object, or a byte range of it, to a stream as a frame:
+ * a single line JSON header, followed by exactly the number of bytes
+ * given in the header. The header is a JSON object with the property
+ * "frame" whose value has the properties "path", "offset", "length"
+ * and, for a whole data object, "checksum" (if there is one in the
+ * catalog). If the contents cannot be read completely once the header
+ * has been written, the frame is padded with NUL bytes and an error is
+ * reported. If an error occurs before then, no frame is written.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  rods_path   An iRODS data object path.
+ * @param[in]  out         A file to write to.
+ * @param[in]  offset      The offset of the first byte.
+ * @param[in]  length      The maximum number of bytes.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[out] error       An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int get_data_obj_framed_stream(rcComm_t *conn, rodsPath_t *rods_path,
+                               FILE *out, size_t offset, size_t length,
+                               size_t buffer_size, baton_error_t *error);
+
+/**
+ * Read a data object to a local file, resuming any previous attempt
+ * recorded in the file's journal (see open_transfer_journal). Each
+ * chunk is journalled once written to the local file. The journal is
+ * removed once the whole local file has been verified against the
+ * checksum of the data object.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  rods_path   An iRODS data object path.
+ * @param[in]  local_path  A local file path.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[out] error       An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int get_data_obj_file_resumable(rcComm_t *conn, rodsPath_t *rods_path,
+                                const char *local_path, size_t buffer_size,
+                                baton_error_t *error);
+
 char *checksum_data_obj(rcComm_t *conn, rodsPath_t *rods_path,
                         option_flags flags, baton_error_t *error);
 
@@ -130,4 +272,24 @@ void set_md5_last_read(data_obj_file_t *obj_file, unsigned char digest[16]);
 
 int validate_md5_last_read(rcComm_t *conn, data_obj_file_t *obj_file);
 
+/**
+ * Verify a local file against the checksum of a data object. If the
+ * server uses SHA256 checksums, the local file is checksummed,
+ * otherwise the supplied MD5 of its contents is used. A mismatch is an
+ * error.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  obj_path    An iRODS data object path.
+ * @param[in]  local_path  A local file path.
+ * @param[in]  md5         The MD5 of the local file.
+ * @param[in]  force       If true, make the server calculate the checksum
+ *                         afresh rather than use the catalog value.
+ * @param[out] error       An error report struct.
+ *
+ * @return 0 on success, or an error code.
+ */
+int verify_data_obj_checksum(rcComm_t *conn, const char *obj_path,
+                             const char *local_path, const char *md5,
+                             int force, baton_error_t *error);
+
 #endif // _BATON_READ_H
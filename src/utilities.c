@@ -25,6 +25,7 @@
 #include <errno.h>
 #include <limits.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,6 +34,10 @@
 #include "log.h"
 #include "utilities.h"
 
+#ifdef BATON_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 char *copy_str(const char *str, size_t max_len) {
     size_t term_len = strnlen(str, max_len) + 1; // +1 for NUL
     char *copy = NULL;
@@ -272,108 +277,708 @@ error:
     return NULL;
 }
 
+#ifdef BATON_X86_KERNELS
+// The kernel in use, or -1 until one is chosen; accessed atomically
+// because it is shared by worker threads
+static int text_kernel_selected = -1;
+#endif
+
+text_kernel best_text_kernel(void) {
+#ifdef BATON_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))   return TEXT_KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return TEXT_KERNEL_SSE42;
+#endif
+
+    return TEXT_KERNEL_SCALAR;
+}
+
+text_kernel select_text_kernel(text_kernel kernel) {
+    text_kernel best = best_text_kernel();
+    if (kernel > best) kernel = best;
+
+#ifdef BATON_X86_KERNELS
+    __atomic_store_n(&text_kernel_selected, (int) kernel, __ATOMIC_RELAXED);
+#endif
+
+    return kernel;
+}
+
+static text_kernel current_text_kernel(void) {
+#ifdef BATON_X86_KERNELS
+    int kernel = __atomic_load_n(&text_kernel_selected, __ATOMIC_RELAXED);
+    if (kernel < 0) {
+        kernel = best_text_kernel();
+        __atomic_store_n(&text_kernel_selected, kernel, __ATOMIC_RELAXED);
+    }
+
+    return (text_kernel) kernel;
+#else
+    return TEXT_KERNEL_SCALAR;
+#endif
+}
+
+static size_t ascii_prefix_len_scalar(const char *str, size_t len) {
+    const uint64_t high_bits = 0x8080808080808080ULL;
+    size_t i = 0;
+
+    // Test 8 bytes at a time for any with the high bit set. The memcpy
+    // is an unaligned load, which compilers emit as a single move.
+    for (; i + sizeof (uint64_t) <= len; i += sizeof (uint64_t)) {
+        uint64_t word;
+        memcpy(&word, str + i, sizeof word);
+        if (word & high_bits) break;
+    }
+
+    const unsigned char *bytes = (const unsigned char *) str;
+    while (i < len && bytes[i] <= 0x7f) i++;
+
+    return i;
+}
+
+#ifdef BATON_X86_KERNELS
+// The UTF-8 validation kernels use the lookup algorithm of Keiser and
+// Lemire, "Validating UTF-8 in less than one instruction per byte"
+// (Software: Practice and Experience, 2021). Each byte is paired with
+// the one before it, and three table lookups, by the high and low
+// nibbles of the first byte and the high nibble of the second, give
+// flags for the errors the pair may be part of. A pair is invalid if
+// all three lookups share a flag. Sequences of three and four bytes
+// are checked by comparing the bytes two and three back.
+#define UTF8_TOO_SHORT      (1 << 0)
+#define UTF8_TOO_LONG       (1 << 1)
+#define UTF8_OVERLONG_3     (1 << 2)
+#define UTF8_TOO_LARGE      (1 << 3)
+#define UTF8_SURROGATE      (1 << 4)
+#define UTF8_OVERLONG_2     (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4     (1 << 6)
+#define UTF8_TWO_CONTS      (1 << 7)
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+static const unsigned char UTF8_BYTE_1_HIGH[16] = {
+    // 0_______ ASCII
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    // 10______ continuation
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    // 1100____ two byte lead
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    // 1101____ two byte lead
+    UTF8_TOO_SHORT,
+    // 1110____ three byte lead
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    // 1111____ four byte lead
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+};
+
+static const unsigned char UTF8_BYTE_1_LOW[16] = {
+    // ____0000
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    // ____0001
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    // ____001_
+    UTF8_CARRY,
+    UTF8_CARRY,
+    // ____0100
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    // ____0101 to ____1100
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____1101
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    // ____111_
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+};
+
+static const unsigned char UTF8_BYTE_2_HIGH[16] = {
+    // 0_______ ASCII
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    // 1000____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+    UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    // 1001____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+    UTF8_TOO_LARGE,
+    // 101_____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+    UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+    UTF8_TOO_LARGE,
+    // 11______ lead
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+};
+
+__attribute__((target("sse4.2")))
+static size_t ascii_prefix_len_sse42(const char *str, size_t len) {
+    const __m128i high_bits = _mm_set1_epi8((char) 0x80);
+    size_t i = 0;
+
+    // 64 bytes at a time while all are ASCII, then 16 to find the first
+    // which is not
+    for (; i + 64 <= len; i += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *) (str + i));
+        __m128i b = _mm_loadu_si128((const __m128i *) (str + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *) (str + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *) (str + i + 48));
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (!_mm_testz_si128(any, high_bits)) break;
+    }
+
+    for (; i + 16 <= len; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)
+                                                     (str + i)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    return i + ascii_prefix_len_scalar(str + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t ascii_prefix_len_avx2(const char *str, size_t len) {
+    size_t i = 0;
+
+    // 128 bytes at a time while all are ASCII, then 32 to find the
+    // first which is not
+    for (; i + 128 <= len; i += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i *) (str + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *) (str + i + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *) (str + i + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *) (str + i + 96));
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b),
+                                      _mm256_or_si256(c, d));
+        if (_mm256_movemask_epi8(any)) break;
+    }
+
+    for (; i + 32 <= len; i += 32) {
+        unsigned int mask = (unsigned int)
+            _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)
+                                                    (str + i)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+
+    return i + ascii_prefix_len_scalar(str + i, len - i);
+}
+
+// Return 1 if the bytes are valid UTF-8 ending with a complete
+// character, or 0 otherwise
+__attribute__((target("sse4.2")))
+static int utf8_valid_sse42(const unsigned char *bytes, size_t len) {
+    const __m128i byte_1_high_table =
+        _mm_loadu_si128((const __m128i *) UTF8_BYTE_1_HIGH);
+    const __m128i byte_1_low_table =
+        _mm_loadu_si128((const __m128i *) UTF8_BYTE_1_LOW);
+    const __m128i byte_2_high_table =
+        _mm_loadu_si128((const __m128i *) UTF8_BYTE_2_HIGH);
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    const __m128i high_bit   = _mm_set1_epi8((char) 0x80);
+    // The largest final bytes which do not begin an incomplete character
+    const __m128i max_final  =
+        _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                      -1, -1, -1, -1, -1, (char) 0xef, (char) 0xdf,
+                      (char) 0xbf);
+
+    __m128i error           = _mm_setzero_si128();
+    __m128i prev_input      = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+
+    for (size_t i = 0; i < len; i += 16) {
+        __m128i input;
+        if (i + 16 <= len) {
+            input = _mm_loadu_si128((const __m128i *) (bytes + i));
+        }
+        else {
+            // The final block is padded with NUL, which is ASCII
+            unsigned char block[16] = { 0 };
+            memcpy(block, bytes + i, len - i);
+            input = _mm_loadu_si128((const __m128i *) block);
+        }
+
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, prev_incomplete);
+        }
+        else {
+            __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+            __m128i byte_1_high =
+                _mm_shuffle_epi8(byte_1_high_table,
+                                 _mm_and_si128(_mm_srli_epi16(prev1, 4),
+                                               low_nibble));
+            __m128i byte_1_low =
+                _mm_shuffle_epi8(byte_1_low_table,
+                                 _mm_and_si128(prev1, low_nibble));
+            __m128i byte_2_high =
+                _mm_shuffle_epi8(byte_2_high_table,
+                                 _mm_and_si128(_mm_srli_epi16(input, 4),
+                                               low_nibble));
+            __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high,
+                                                          byte_1_low),
+                                            byte_2_high);
+
+            // Only bytes following a three or four byte lead by two, or
+            // a four byte lead by three, must be continuations
+            __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+            __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+            __m128i must_continue =
+                _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xe0 - 0x80)),
+                             _mm_subs_epu8(prev3, _mm_set1_epi8(0xf0 - 0x80)));
+            must_continue = _mm_and_si128(must_continue, high_bit);
+
+            error = _mm_or_si128(error, _mm_xor_si128(must_continue, special));
+            prev_incomplete = _mm_subs_epu8(input, max_final);
+        }
+
+        prev_input = input;
+    }
+
+    error = _mm_or_si128(error, prev_incomplete);
+
+    return _mm_testz_si128(error, error);
+}
+
+// As utf8_valid_sse42, 32 bytes at a time
+__attribute__((target("avx2")))
+static int utf8_valid_avx2(const unsigned char *bytes, size_t len) {
+    const __m256i byte_1_high_table = _mm256_broadcastsi128_si256
+        (_mm_loadu_si128((const __m128i *) UTF8_BYTE_1_HIGH));
+    const __m256i byte_1_low_table = _mm256_broadcastsi128_si256
+        (_mm_loadu_si128((const __m128i *) UTF8_BYTE_1_LOW));
+    const __m256i byte_2_high_table = _mm256_broadcastsi128_si256
+        (_mm_loadu_si128((const __m128i *) UTF8_BYTE_2_HIGH));
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    const __m256i high_bit   = _mm256_set1_epi8((char) 0x80);
+    const __m256i max_final  =
+        _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                         -1, -1, -1, -1, -1, -1, -1, -1,
+                         -1, -1, -1, -1, -1, -1, -1, -1,
+                         -1, -1, -1, -1, -1, (char) 0xef, (char) 0xdf,
+                         (char) 0xbf);
+
+    __m256i error           = _mm256_setzero_si256();
+    __m256i prev_input      = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+
+    for (size_t i = 0; i < len; i += 32) {
+        __m256i input;
+        if (i + 32 <= len) {
+            input = _mm256_loadu_si256((const __m256i *) (bytes + i));
+        }
+        else {
+            unsigned char block[32] = { 0 };
+            memcpy(block, bytes + i, len - i);
+            input = _mm256_loadu_si256((const __m256i *) block);
+        }
+
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, prev_incomplete);
+        }
+        else {
+            // The bytes before each byte of the input span the two
+            // lanes and the previous input
+            __m256i prev_lanes = _mm256_permute2x128_si256(prev_input, input,
+                                                           0x21);
+            __m256i prev1 = _mm256_alignr_epi8(input, prev_lanes, 15);
+            __m256i prev2 = _mm256_alignr_epi8(input, prev_lanes, 14);
+            __m256i prev3 = _mm256_alignr_epi8(input, prev_lanes, 13);
+
+            __m256i byte_1_high =
+                _mm256_shuffle_epi8(byte_1_high_table,
+                                    _mm256_and_si256(_mm256_srli_epi16(prev1,
+                                                                       4),
+                                                     low_nibble));
+            __m256i byte_1_low =
+                _mm256_shuffle_epi8(byte_1_low_table,
+                                    _mm256_and_si256(prev1, low_nibble));
+            __m256i byte_2_high =
+                _mm256_shuffle_epi8(byte_2_high_table,
+                                    _mm256_and_si256(_mm256_srli_epi16(input,
+                                                                       4),
+                                                     low_nibble));
+            __m256i special =
+                _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low),
+                                 byte_2_high);
+
+            __m256i must_continue =
+                _mm256_or_si256(_mm256_subs_epu8(prev2,
+                                                 _mm256_set1_epi8(0xe0 - 0x80)),
+                                _mm256_subs_epu8(prev3,
+                                                 _mm256_set1_epi8(0xf0 - 0x80)));
+            must_continue = _mm256_and_si256(must_continue, high_bit);
+
+            error = _mm256_or_si256(error, _mm256_xor_si256(must_continue,
+                                                            special));
+            prev_incomplete = _mm256_subs_epu8(input, max_final);
+        }
+
+        prev_input = input;
+    }
+
+    error = _mm256_or_si256(error, prev_incomplete);
+
+    return _mm256_testz_si256(error, error);
+}
+
+// For each group of four Latin-1 characters, expanded to two bytes
+// each, the shuffle which keeps the first byte of each ASCII character
+// and both bytes of the others, indexed by a mask of the non-ASCII
+// characters
+static const unsigned char LATIN1_COMPACT[16][16] = {
+    { 0, 2, 4, 6, 0x80, 0x80, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 4, 6, 0x80, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 2, 3, 4, 6, 0x80, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 3, 4, 6, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 2, 4, 5, 6, 0x80, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 4, 5, 6, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 2, 3, 4, 5, 6, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 3, 4, 5, 6, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 2, 4, 6, 7, 0x80, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 4, 6, 7, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 2, 3, 4, 6, 7, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 3, 4, 6, 7, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 2, 4, 5, 6, 7, 0x80, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 4, 5, 6, 7, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 2, 3, 4, 5, 6, 7, 0x80,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 3, 4, 5, 6, 7,
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 }
+};
+
+// Transcode whole blocks of 16 Latin-1 characters to UTF-8, stopping
+// before the input or the output would run out, and return the number
+// of characters transcoded. Each group of four characters is written
+// with one 8 byte store, so up to 32 bytes of output space are needed
+// for each block.
+__attribute__((target("sse4.2")))
+static size_t latin1_to_utf8_sse42(const unsigned char *input, size_t len,
+                                   unsigned char *output, size_t max_len,
+                                   size_t *num_written) {
+    const __m128i low_six  = _mm_set1_epi16(0x3f);
+    const __m128i lead     = _mm_set1_epi16(0xc0);
+    const __m128i cont     = _mm_set1_epi16(0x80);
+    const __m128i max_char = _mm_set1_epi16(0x7f);
+
+    size_t i = 0;
+    size_t j = 0;
+
+    for (; i + 16 <= len && j + 32 <= max_len; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *) (input + i));
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(in);
+
+        if (mask == 0) {
+            _mm_storeu_si128((__m128i *) (output + j), in);
+            j += 16;
+            continue;
+        }
+
+        for (int half = 0; half < 2; half++) {
+            __m128i chars = _mm_cvtepu8_epi16(half ? _mm_srli_si128(in, 8) :
+                                              in);
+            // Each character as its two UTF-8 bytes, or as itself and a
+            // NUL if it is ASCII
+            __m128i pair =
+                _mm_or_si128(_mm_or_si128(_mm_srli_epi16(chars, 6), lead),
+                             _mm_slli_epi16(_mm_or_si128(_mm_and_si128(chars,
+                                                                       low_six),
+                                                         cont), 8));
+            __m128i wide = _mm_cmpgt_epi16(chars, max_char);
+            __m128i utf8 = _mm_blendv_epi8(chars, pair, wide);
+
+            for (int group = 0; group < 2; group++) {
+                unsigned int m = (mask >> (half * 8 + group * 4)) & 0xf;
+                __m128i bytes = group ? _mm_srli_si128(utf8, 8) : utf8;
+                __m128i shuffle =
+                    _mm_loadu_si128((const __m128i *) LATIN1_COMPACT[m]);
+
+                _mm_storel_epi64((__m128i *) (output + j),
+                                 _mm_shuffle_epi8(bytes, shuffle));
+                j += 4 + __builtin_popcount(m);
+            }
+        }
+    }
+
+    *num_written = j;
+
+    return i;
+}
+#endif // BATON_X86_KERNELS
+
 size_t to_utf8(const char *input, char *output, size_t max_len) {
     size_t len = strnlen(input, max_len);
+    size_t j   = 0;
 
     const unsigned char *bytes = (const unsigned char *) input;
-    char *op = output;
+
+    if (max_len == 0) return 0;
 
     // In Latin-1, the numeric values of the encoding are equal to the
     // first 256 Unicode codepoints
 
     // http://www.ietf.org/rfc/rfc3629.txt, Section 3. for encoding.
 
-    for (size_t i = 0; i < len; i++) {
-        if (bytes[i] < 0x80) {
-            *op++ = bytes[i];
-        }
-        else {
-            *op++ = 0xc0 | (bytes[i] & 0xc0) >> 6;
-            *op++ = 0x80 | (bytes[i] & 0x3f);
+    size_t i = 0;
+    while (i < len) {
+        // Copy runs of ASCII whole
+        size_t run = ascii_prefix_len(input + i, len - i);
+        if (run > max_len - 1 - j) run = max_len - 1 - j;
+        memcpy(output + j, input + i, run);
+        i += run;
+        j += run;
+
+        if (i == len || j + 2 > max_len - 1) break;
+
+#ifdef BATON_X86_KERNELS
+        // Text having many non-ASCII characters is transcoded 16 at a
+        // time, while there is room for the widest output
+        if (current_text_kernel() != TEXT_KERNEL_SCALAR) {
+            size_t nw = 0;
+            size_t nr = latin1_to_utf8_sse42(bytes + i, len - i,
+                                             (unsigned char *) output + j,
+                                             max_len - 1 - j, &nw);
+            i += nr;
+            j += nw;
+            if (nr > 0) continue;
         }
+#endif
+
+        output[j++] = 0xc0 | (bytes[i] & 0xc0) >> 6;
+        output[j++] = 0x80 | (bytes[i] & 0x3f);
+        i++;
     }
 
-    return len;
+    output[j] = '\0';
+
+    return j;
+}
+
+
+size_t ascii_prefix_len(const char *str, size_t len) {
+#ifdef BATON_X86_KERNELS
+    switch (current_text_kernel()) {
+        case TEXT_KERNEL_AVX2:
+            return ascii_prefix_len_avx2(str, len);
+
+        case TEXT_KERNEL_SSE42:
+            return ascii_prefix_len_sse42(str, len);
+
+        default:
+            break;
+    }
+#endif
+
+    return ascii_prefix_len_scalar(str, len);
 }
 
 int maybe_utf8 (const char *str, size_t max_len) {
-    // http://www.rfc-editor.org/rfc/rfc3629.txt, Section 4. for the syntax
-    // of UTF-8 byte sequences.
-    //
-    // UTF8-octets = *( UTF8-char )
-    // UTF8-char   = UTF8-1 / UTF8-2 / UTF8-3 / UTF8-4
-    // UTF8-tail   = %x80-BF
+    return utf8_valid(str, strnlen(str, max_len));
+}
+
+int utf8_valid(const char *str, size_t len) {
+    size_t complete;
 
-    size_t len = strnlen(str, max_len);
-    size_t i   = 0;
+    return utf8_chunk_valid(str, len, &complete) && complete == len;
+}
 
+// Validate bytes from a character boundary, finding the exact position
+// of the first invalid or incomplete character
+static int utf8_chunk_valid_scalar(const char *str, size_t len, size_t i,
+                                   size_t *complete) {
+    // http://www.rfc-editor.org/rfc/rfc3629.txt, Section 4. for the syntax
+    // of UTF-8 byte sequences.
     const unsigned char *bytes = (const unsigned char *) str;
 
     while (i < len) {
         // UTF8-1 = %x00-7F
-        // Includes 0x7f DEL and other control characters
-        if (bytes[i + 0] <= 0x7F) {
-            i += 1;
+        if (bytes[i] <= 0x7f) {
+            i += ascii_prefix_len(str + i, len - i);
             continue;
         }
 
-        // UTF8-2 = %xC2-DF UTF8-tail
-        if ((bytes[i + 0] >= 0xc2) && (bytes[i + 0] <= 0xdf) &&
-            (bytes[i + 1] >= 0x80) && (bytes[i + 1] <= 0xbf)) {
-            i += 2;
-            continue;
+        // The number of bytes in the character and the range of its
+        // second byte
+        size_t n;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xbf;
+
+        if (bytes[i] >= 0xc2 && bytes[i] <= 0xdf) {
+            n = 2;
+        }
+        else if (bytes[i] >= 0xe0 && bytes[i] <= 0xef) {
+            n = 3;
+            if (bytes[i] == 0xe0) lo = 0xa0;
+            if (bytes[i] == 0xed) hi = 0x9f;
+        }
+        else if (bytes[i] >= 0xf0 && bytes[i] <= 0xf4) {
+            n = 4;
+            if (bytes[i] == 0xf0) lo = 0x90;
+            if (bytes[i] == 0xf4) hi = 0x8f;
+        }
+        else {
+            goto invalid;
         }
 
-        // UTF8-3 = %xE0 %xA0-BF UTF8-tail / %xE1-EC 2( UTF8-tail ) /
-        //          %xED %x80-9F UTF8-tail / %xEE-EF 2( UTF8-tail )
-        if (// %xE0 %xA0-BF UTF8-tail
-            ((bytes[i + 0] == 0xe0)                             &&
-             ((bytes[i + 1] >= 0xa0) && (bytes[i + 1] <= 0xbf)) &&
-             ((bytes[i + 2] >= 0x80) && (bytes[i + 2] <= 0xbf)))
-            ||
-            // %xE1-EC 2( UTF8-tail )
-            (((bytes[i + 0] >= 0xe1) && (bytes[i + 0] <= 0xec)) &&
-             ((bytes[i + 1] >= 0x80) && (bytes[i + 1] <= 0xbf)) &&
-             ((bytes[i + 2] >= 0x80) && (bytes[i + 2] <= 0xbf)))
-            ||
-            // %xED %x80-9F UTF8-tail
-            ((bytes[i + 0] == 0xed)                             &&
-             ((bytes[i + 1] >= 0x80) && (bytes[i + 1] <= 0x9f)) &&
-             ((bytes[i + 2] >= 0x80) && (bytes[i + 2] <= 0xbf)))
-            ||
-            // %xEE-EF 2( UTF8-tail )
-            (((bytes[i + 0] >= 0xee) && (bytes[i + 0] <= 0xef)) &&
-             ((bytes[i + 1] >= 0x80) && (bytes[i + 1] <= 0xbf)) &&
-             ((bytes[i + 2] >= 0x80) && (bytes[i + 2] <= 0xbf)))) {
-            i += 3;
-            continue;
-         }
-
-        // UTF8-4 = %xF0 %x90-BF 2( UTF8-tail ) / %xF1-F3 3( UTF8-tail ) /
-        //          %xF4 %x80-8F 2( UTF8-tail )
-        if (// %xF0 %x90-BF 2( UTF8-tail )
-            ((bytes[i + 0] == 0xf0)                             &&
-             ((bytes[i + 1] >= 0x90) && (bytes[i + 1] <= 0xbf)) &&
-             ((bytes[i + 2] >= 0x80) && (bytes[i + 2] <= 0xbf)) &&
-             ((bytes[i + 3] >= 0x80) && (bytes[i + 3] <= 0xbf)))
-            ||
-            // %xF1-F3 3( UTF8-tail )
-            (((bytes[i + 0] >= 0xf1) && (bytes[i + 0] <= 0xf3)) &&
-             ((bytes[i + 1] >= 0x80) && (bytes[i + 1] <= 0xbf)) &&
-             ((bytes[i + 2] >= 0x80) && (bytes[i + 2] <= 0xbf)) &&
-             ((bytes[i + 3] >= 0x80) && (bytes[i + 3] <= 0xbf)))
-            ||
-            // %xF4 %x80-8F 2( UTF8-tail )
-            ((bytes[i + 0] == 0xf4)                             &&
-             ((bytes[i + 1] >= 0x80) && (bytes[i + 1] <= 0x8f)) &&
-             ((bytes[i + 2] >= 0x80) && (bytes[i + 2] <= 0xbf)) &&
-             ((bytes[i + 3] >= 0x80) && (bytes[i + 3] <= 0xbf)))) {
-            i += 4;
-            continue;
+        for (size_t j = 1; j < n; j++) {
+            if (i + j >= len) goto incomplete;
+
+            unsigned char tail = bytes[i + j];
+            if (j == 1 && (tail < lo || tail > hi)) goto invalid;
+            if (tail < 0x80 || tail > 0xbf)         goto invalid;
         }
 
-        return 0;
+        i += n;
     }
 
+incomplete:
+    *complete = i;
     return 1;
+
+invalid:
+    *complete = i;
+    return 0;
+}
+
+int utf8_chunk_valid(const char *str, size_t len, size_t *complete) {
+    // The final character is allowed to be incomplete so that a stream
+    // may be validated in chunks.
+    size_t start = 0;
+
+#ifdef BATON_X86_KERNELS
+    text_kernel kernel = current_text_kernel();
+
+    // The vector kernels validate the chunk up to the start of its last
+    // character, which may be incomplete. The rest is validated one
+    // character at a time, as is the whole chunk if the kernel finds
+    // it invalid, to give the exact position of the error.
+    if (kernel != TEXT_KERNEL_SCALAR && len >= UTF8_KERNEL_MIN_LEN) {
+        const unsigned char *bytes = (const unsigned char *) str;
+
+        // A leading ASCII run, often the whole chunk, is skipped by the
+        // faster ASCII kernel
+        start = ascii_prefix_len(str, len);
+
+        size_t last = len - 1;
+        while (last > len - 4 && (bytes[last] & 0xc0) == 0x80) last--;
+
+        if (start < last) {
+            int valid = kernel == TEXT_KERNEL_AVX2 ?
+                utf8_valid_avx2(bytes + start, last - start) :
+                utf8_valid_sse42(bytes + start, last - start);
+            if (valid) start = last;
+        }
+    }
+#endif
+
+    return utf8_chunk_valid_scalar(str, len, start, complete);
+}
+
+static const char BASE64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t base64_encode(const char *input, size_t len, char *output) {
+    const unsigned char *in = (const unsigned char *) input;
+    size_t i = 0;
+    size_t j = 0;
+
+    // Whole 3-byte groups, in a branch-free loop which the compiler may
+    // vectorise
+    for (; i + 3 <= len; i += 3, j += 4) {
+        unsigned int group = in[i] << 16 | in[i + 1] << 8 | in[i + 2];
+        output[j]     = BASE64_ALPHABET[(group >> 18) & 0x3f];
+        output[j + 1] = BASE64_ALPHABET[(group >> 12) & 0x3f];
+        output[j + 2] = BASE64_ALPHABET[(group >> 6)  & 0x3f];
+        output[j + 3] = BASE64_ALPHABET[group         & 0x3f];
+    }
+
+    // A final, padded partial group
+    if (i < len) {
+        unsigned int group = in[i] << 16;
+        if (i + 1 < len) group |= in[i + 1] << 8;
+
+        output[j]     = BASE64_ALPHABET[(group >> 18) & 0x3f];
+        output[j + 1] = BASE64_ALPHABET[(group >> 12) & 0x3f];
+        output[j + 2] = i + 1 < len ?
+            BASE64_ALPHABET[(group >> 6) & 0x3f] : '=';
+        output[j + 3] = '=';
+        j += 4;
+    }
+
+    output[j] = '\0';
+
+    return j;
+}
+
+static int base64_value(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+
+    return -1;
+}
+
+size_t base64_decode(const char *input, size_t len, char *output,
+                     int *valid) {
+    unsigned int group = 0;
+    size_t num_chars   = 0;
+    size_t num_pad     = 0;
+    size_t j           = 0;
+
+    *valid = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = input[i];
+
+        // Line breaks are permitted, as in MIME
+        if (c == '\n' || c == '\r') continue;
+
+        if (c == '=') {
+            num_pad++;
+            c = 'A'; // Decodes as zero bits
+        }
+        else if (num_pad > 0) {
+            goto finally; // Data after padding
+        }
+
+        int value = base64_value(c);
+        if (value < 0) goto finally;
+
+        group = group << 6 | value;
+        num_chars++;
+
+        if (num_chars % 4 == 0) {
+            output[j++] = (group >> 16) & 0xff;
+            output[j++] = (group >> 8)  & 0xff;
+            output[j++] = group         & 0xff;
+            group = 0;
+        }
+    }
+
+    if (num_chars % 4 != 0 || num_pad > 2) goto finally;
+
+    j -= num_pad;
+    *valid = 1;
+
+finally:
+    return j;
 }
@@ -29,6 +29,9 @@
 #define ISO8601_FORMAT "%Y-%m-%dT%H:%M:%S"
 #define RFC3339_FORMAT "%Y-%m-%dT%H:%M:%SZ"
 
+#define BASE64_ENCODED_LEN(n)     ((((n) + 2) / 3) * 4 + 1)
+#define BASE64_DECODED_MAX_LEN(n) ((((n) + 3) / 4) * 3)
+
 int str_starts_with(const char *str, const char *prefix, size_t max_len);
 
 int str_ends_with(const char *str, const char *suffix, size_t max_len);
@@ -52,8 +55,127 @@ char *format_timestamp(const char *timestamp, const char *format);
 
 char *parse_timestamp(const char *timestamp, const char *format);
 
+// The SSE4.2 and AVX2 text kernels are compiled where the compiler
+// allows functions to target them, and chosen at run time by the CPU
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATON_X86_KERNELS 1
+#endif
+
+// The length below which strings are validated as UTF-8 one character
+// at a time, rather than by a vector kernel
+#define UTF8_KERNEL_MIN_LEN 64
+
+/**
+ * The instruction set extensions used by the text kernels (UTF-8
+ * validation and ASCII detection), in increasing order of preference.
+ */
+typedef enum {
+    TEXT_KERNEL_SCALAR = 0,
+    TEXT_KERNEL_SSE42  = 1,
+    TEXT_KERNEL_AVX2   = 2
+} text_kernel;
+
+/**
+ * Return the best text kernel supported by the CPU, which is used
+ * unless another is selected.
+ *
+ * @return The text kernel.
+ */
+text_kernel best_text_kernel(void);
+
+/**
+ * Select the text kernel to use, for example to compare kernels. A
+ * kernel not supported by the CPU is replaced by the best which is.
+ *
+ * @param[in]  kernel  The text kernel.
+ *
+ * @return The text kernel selected.
+ */
+text_kernel select_text_kernel(text_kernel kernel);
+
 int maybe_utf8 (const char *str, size_t max_len);
 
+/**
+ * Return 1 if a byte string is valid UTF-8, or 0 otherwise. Unlike
+ * maybe_utf8, the string is bounded by len and may contain NUL bytes.
+ *
+ * @param[in]  str  The string.
+ * @param[in]  len  The string length in bytes.
+ *
+ * @return 1 if the string is valid UTF-8, or 0 otherwise.
+ */
+int utf8_valid(const char *str, size_t len);
+
+/**
+ * Return the number of bytes at the start of a byte string which are
+ * ASCII. Bytes are tested a vector register at a time with the text
+ * kernel in use, or a machine word at a time without one.
+ *
+ * @param[in]  str  The string.
+ * @param[in]  len  The string length in bytes.
+ *
+ * @return The length of the ASCII prefix.
+ */
+size_t ascii_prefix_len(const char *str, size_t len);
+
+/**
+ * Validate a chunk of a UTF-8 byte stream. The chunk may end part way
+ * through a character, in which case the incomplete character should
+ * be prepended to the next chunk.
+ *
+ * @param[in]  str       The chunk.
+ * @param[in]  len       The chunk length in bytes.
+ * @param[out] complete  The number of bytes of complete, valid
+ *                       characters at the start of the chunk.
+ *
+ * @return 1 if the chunk is valid, or 0 otherwise.
+ */
+int utf8_chunk_valid(const char *str, size_t len, size_t *complete);
+
+/**
+ * Encode bytes as base64 (RFC 4648), padding the final group. A stream
+ * may be encoded in chunks whose lengths, apart from the last, are
+ * multiples of 3.
+ *
+ * @param[in]  input   The bytes to encode.
+ * @param[in]  len     The number of bytes.
+ * @param[out] output  A buffer of at least BASE64_ENCODED_LEN(len) bytes,
+ *                     which will be NUL-terminated.
+ *
+ * @return The length of the encoded string.
+ */
+size_t base64_encode(const char *input, size_t len, char *output);
+
+/**
+ * Decode base64 (RFC 4648). Line breaks are ignored.
+ *
+ * @param[in]  input   The base64 string.
+ * @param[in]  len     The length of the string.
+ * @param[out] output  A buffer of at least BASE64_DECODED_MAX_LEN(len)
+ *                     bytes.
+ * @param[out] valid   Set to 1 if the string was valid base64, or 0
+ *                     otherwise.
+ *
+ * @return The number of bytes decoded.
+ */
+size_t base64_decode(const char *input, size_t len, char *output,
+                     int *valid);
+
+/**
+ * Transcode an ISO-8859-1 (Latin-1) string to UTF-8. Each byte above
+ * 0x7f becomes two bytes, so an output buffer of twice the input length
+ * plus one is always large enough. Otherwise, the output is truncated
+ * at the last whole character that fits. Text with many non-ASCII
+ * characters is transcoded by the text kernel in use, which may write
+ * to the buffer beyond the terminating NUL.
+ *
+ * @param[in]  input    A NUL-terminated string.
+ * @param[out] output   A buffer to receive the NUL-terminated result.
+ * @param[in]  max_len  The length of the output buffer, including the
+ *                      terminating NUL. Also bounds the input length.
+ *
+ * @return The length of the output, excluding the terminating NUL.
+ */
 size_t to_utf8(const char *input, char *output, size_t max_len);
 
 #endif // _BATON_UTILITIES_H
@@ -0,0 +1,246 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file workers.c
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "baton.h"
+#include "log.h"
+#include "workers.h"
+
+/**
+ *  @struct worker_pool
+ *  @brief The tasks shared by the workers of a pool.
+ */
+typedef struct worker_pool {
+    worker_task_fn task_fn;
+    void *state;
+    size_t num_tasks;
+    /** The next task to be taken by a worker */
+    size_t next_task;
+    /** Guards the next task */
+    pthread_mutex_t lock;
+} worker_pool_t;
+
+/**
+ *  @struct worker
+ *  @brief A worker running tasks with its own connection.
+ */
+typedef struct worker {
+    worker_pool_t *pool;
+    rcComm_t *conn;
+} worker_t;
+
+static void *run_tasks(void *arg) {
+    worker_t *worker    = arg;
+    worker_pool_t *pool = worker->pool;
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        if (pool->next_task == pool->num_tasks) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        size_t index = pool->next_task++;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool->task_fn(worker->conn, index, pool->state);
+    }
+
+    return NULL;
+}
+
+// Run the tasks on the given connections, the first in the caller's
+// thread and the others each in a thread of its own
+static size_t run_pool(rcComm_t **conns, size_t num_conns, size_t num_tasks,
+                       worker_task_fn task_fn, void *state,
+                       baton_error_t *error) {
+    worker_t *workers  = NULL;
+    pthread_t *threads = NULL;
+    size_t num_started = 0;
+    int locked         = 0;
+
+    worker_pool_t pool = { .task_fn   = task_fn,
+                           .state     = state,
+                           .num_tasks = num_tasks,
+                           .next_task = 0 };
+
+    init_baton_error(error);
+
+    if (num_conns > num_tasks) num_conns = num_tasks;
+    if (num_conns == 0) num_conns = 1;
+
+    int status = pthread_mutex_init(&pool.lock, NULL);
+    if (status != 0) {
+        set_baton_error(error, status, "Failed to initialise a lock: "
+                        "error %d %s", status, strerror(status));
+        goto finally;
+    }
+    locked = 1;
+
+    workers = calloc(num_conns, sizeof (worker_t));
+    threads = calloc(num_conns, sizeof (pthread_t));
+    if (!workers || !threads) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    for (size_t i = 0; i < num_conns; i++) {
+        workers[i].pool = &pool;
+        workers[i].conn = conns[i];
+    }
+
+    for (size_t i = 1; i < num_conns; i++) {
+        status = pthread_create(&threads[i], NULL, run_tasks, &workers[i]);
+        if (status != 0) {
+            logmsg(WARN, "Failed to start worker %zu: error %d %s; "
+                   "continuing with %zu workers", i, status,
+                   strerror(status), i);
+            break;
+        }
+        num_started++;
+    }
+
+    logmsg(DEBUG, "Running %zu tasks using %zu workers", num_tasks,
+           num_started + 1);
+
+    run_tasks(&workers[0]);
+
+    for (size_t i = 1; i <= num_started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+finally:
+    if (locked)  pthread_mutex_destroy(&pool.lock);
+    if (workers) free(workers);
+    if (threads) free(threads);
+
+    return error->code == 0 ? num_started + 1 : 0;
+}
+
+// Log in up to the given number of connections, stopping at the first
+// that fails, and return the number opened
+static size_t login_conns(rcComm_t **conns, size_t num_conns) {
+    size_t num_opened = 0;
+
+    for (size_t i = 0; i < num_conns; i++) {
+        // rods_login loads the environment into its argument
+        rodsEnv worker_env;
+        conns[i] = rods_login(&worker_env);
+        if (!conns[i]) {
+            logmsg(WARN, "Failed to connect worker %zu; continuing "
+                   "with %zu workers", i, i);
+            break;
+        }
+        num_opened++;
+    }
+
+    return num_opened;
+}
+
+size_t run_worker_pool(rcComm_t *conn, size_t num_workers, size_t num_tasks,
+                       worker_task_fn task_fn, void *state,
+                       baton_error_t *error) {
+    rcComm_t **conns = NULL;
+    size_t num_conns = 0;
+    size_t num_used  = 0;
+
+    init_baton_error(error);
+
+    if (num_workers > num_tasks) num_workers = num_tasks;
+    if (num_workers == 0) num_workers = 1;
+
+    conns = calloc(num_workers, sizeof (rcComm_t *));
+    if (!conns) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    conns[0]  = conn;
+    num_conns = 1 + login_conns(conns + 1, num_workers - 1);
+
+    num_used = run_pool(conns, num_conns, num_tasks, task_fn, state, error);
+
+finally:
+    if (conns) {
+        for (size_t i = 1; i < num_conns; i++) rcDisconnect(conns[i]);
+        free(conns);
+    }
+
+    return num_used;
+}
+
+int open_worker_conns(worker_conns_t *conns, size_t num_conns,
+                      baton_error_t *error) {
+    init_baton_error(error);
+
+    conns->num_conns = 0;
+    if (num_conns == 0) num_conns = 1;
+
+    conns->conns = calloc(num_conns, sizeof (rcComm_t *));
+    if (!conns->conns) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    conns->num_conns = login_conns(conns->conns, num_conns);
+    if (conns->num_conns == 0) {
+        set_baton_error(error, -1,
+                        "Failed to connect any of %zu workers", num_conns);
+        goto finally;
+    }
+
+    logmsg(DEBUG, "Connected %zu workers", conns->num_conns);
+
+finally:
+    return error->code;
+}
+
+void close_worker_conns(worker_conns_t *conns) {
+    if (!conns->conns) return;
+
+    for (size_t i = 0; i < conns->num_conns; i++) {
+        rcDisconnect(conns->conns[i]);
+    }
+    free(conns->conns);
+
+    conns->conns     = NULL;
+    conns->num_conns = 0;
+}
+
+size_t run_worker_conns(worker_conns_t *conns, size_t num_tasks,
+                        worker_task_fn task_fn, void *state,
+                        baton_error_t *error) {
+    init_baton_error(error);
+
+    if (conns->num_conns == 0) {
+        set_baton_error(error, -1, "Internal error: no worker connections");
+        return 0;
+    }
+
+    return run_pool(conns->conns, conns->num_conns, num_tasks, task_fn, state,
+                    error);
+}
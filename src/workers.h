@@ -0,0 +1,110 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file workers.h
+ * @author Keith James <kdj@sanger.ac.uk>
+ */
+
+#ifndef _BATON_WORKERS_H
+#define _BATON_WORKERS_H
+
+#include <rodsClient.h>
+
+#include "config.h"
+#include "error.h"
+
+/**
+ * A task run by a worker. Tasks may run concurrently, so any state
+ * they share must be guarded by the caller.
+ *
+ * @param[in]  conn   The iRODS connection of the worker.
+ * @param[in]  index  The index of the task.
+ * @param[in]  state  The caller's state.
+ */
+typedef void (*worker_task_fn)(rcComm_t *conn, size_t index, void *state);
+
+/**
+ * Run a number of tasks across a pool of workers, each taking the next
+ * task as it finishes the last. The first worker uses the caller's
+ * connection and thread, the others their own, which are opened and
+ * closed here. If a worker cannot be connected or started, the tasks
+ * are run by the workers which were.
+ *
+ * @param[in]  conn         An open iRODS connection.
+ * @param[in]  num_workers  The maximum number of workers.
+ * @param[in]  num_tasks    The number of tasks.
+ * @param[in]  task_fn      The function run for each task.
+ * @param[in]  state        The caller's state, passed to each task.
+ * @param[out] error        An error report struct.
+ *
+ * @return The number of workers used.
+ */
+size_t run_worker_pool(rcComm_t *conn, size_t num_workers, size_t num_tasks,
+                       worker_task_fn task_fn, void *state,
+                       baton_error_t *error);
+
+/**
+ *  @struct worker_conns
+ *  @brief Connections opened once for the workers of many pools, so
+ *  that a long operation running pools in turn does not log in for
+ *  each of them.
+ */
+typedef struct worker_conns {
+    rcComm_t **conns;
+    size_t num_conns;
+} worker_conns_t;
+
+/**
+ * Open connections for a number of workers. If a connection cannot be
+ * opened, those which were are kept, so that fewer workers may be
+ * used. It is an error if none can be opened.
+ *
+ * @param[out] conns      The connections, which must be closed with
+ *                        close_worker_conns.
+ * @param[in]  num_conns  The maximum number of connections.
+ * @param[out] error      An error report struct.
+ *
+ * @return 0 on success, error code on failure.
+ */
+int open_worker_conns(worker_conns_t *conns, size_t num_conns,
+                      baton_error_t *error);
+
+/**
+ * Close connections opened by open_worker_conns.
+ *
+ * @param[in] conns  The connections.
+ */
+void close_worker_conns(worker_conns_t *conns);
+
+/**
+ * Run a number of tasks across a pool of workers, as run_worker_pool,
+ * each worker using one of the given connections. The caller's
+ * connection is not used, so the caller may keep a query open on it
+ * while the tasks run.
+ *
+ * @param[in]  conns        Connections opened by open_worker_conns.
+ * @param[in]  num_tasks    The number of tasks.
+ * @param[in]  task_fn      The function run for each task.
+ * @param[in]  state        The caller's state, passed to each task.
+ * @param[out] error        An error report struct.
+ *
+ * @return The number of workers used.
+ */
+size_t run_worker_conns(worker_conns_t *conns, size_t num_tasks,
+                        worker_task_fn task_fn, void *state,
+                        baton_error_t *error);
+
+#endif // _BATON_WORKERS_H
@@ -19,19 +19,23 @@
  * @author Keith James <kdj@sanger.ac.uk>
  */
 
-// Workaround for the accidental removal of client-side checksum API
-// from iRODS in iRODS 4.1.x https://github.com/irods/irods/issues/5731
-
-#if IRODS_VERSION_INTEGER <= (4*1000000 + 2*1000 + 9)
-int chksumLocFile( const char *fileName, char *chksumStr, const char* );
-#else
-#include <checksum.h>
-#endif
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include "config.h"
+#include "baton.h"
+#include "checksum_cache.h"
 #include "compat_checksum.h"
+#include "journal.h"
 #include "write.h"
 
+// Replica tokens, which allow several connections to write to one
+// replica, were introduced in iRODS 4.2.9
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+#include <get_file_descriptor_info.h>
+#include <replica_close.h>
+#endif
+
 int put_data_obj(rcComm_t *conn, const char *local_path, rodsPath_t *rods_path,
                  char *default_resource, char *checksum, int flags,
                  baton_error_t *error) {
@@ -72,22 +76,12 @@ int put_data_obj(rcComm_t *conn, const char *local_path, rodsPath_t *rods_path,
 		   chksum, rods_path->outPath);
 	}
 	else {
-	    // The hash scheme must be defined for rcChksumLocFile, but if
-	    // it is zero length, rcChksumLocFile falls back to the value
-	    // in the client environment. There's no advantage in our
-	    // passing in a value that we have read from the client
-	    // environment.
-	    char* default_scheme = "";
-	    status = chksumLocFile(tmpname, chksum, default_scheme);
-	    if (status != 0) {
-		char *err_subname;
-		const char *err_name = rodsErrorName(status, &err_subname);
-		set_baton_error(error, status,
-				"Failed to calculate a local checksum for: '%s' "
-				"error %d %s", rods_path->outPath, status,
-				err_name);
-		goto error;
-	    }
+	    // The hash scheme must be defined for chksumLocFile, but if
+	    // it is zero length, chksumLocFile falls back to the value
+	    // in the client environment.
+	    checksum_local_file(tmpname, "", chksum, error);
+	    if (error->code != 0) goto error;
+
 	    logmsg(DEBUG, "Calculated a local checksum '%s' for '%s'",
 		   chksum, rods_path->outPath);
 	}
@@ -137,6 +131,127 @@ error:
     return error->code;
 }
 
+int register_data_obj(rcComm_t *conn, const char *phys_path,
+                      rodsPath_t *rods_path, const char *resource, int flags,
+                      baton_error_t *error) {
+    dataObjInp_t obj_reg_in;
+    int status;
+
+    init_baton_error(error);
+
+    memset(&obj_reg_in, 0, sizeof obj_reg_in);
+
+    if (phys_path[0] != '/') {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot register '%s' as '%s': the physical path "
+                        "is not absolute", phys_path, rods_path->outPath);
+        goto finally;
+    }
+
+    if ((flags & VERIFY_CHECKSUM) && (flags & CALCULATE_CHECKSUM)) {
+        set_baton_error(error, USER_INPUT_OPTION_ERR,
+                        "Cannot both verify and update the checksum "
+                        "when registering data object '%s'",
+                        rods_path->outPath);
+        goto finally;
+    }
+
+    snprintf(obj_reg_in.objPath, MAX_NAME_LEN, "%s", rods_path->outPath);
+    addKeyVal(&obj_reg_in.condInput, FILE_PATH_KW, phys_path);
+
+    if (resource) {
+        logmsg(DEBUG, "Registering '%s' on resource '%s'", phys_path,
+               resource);
+        addKeyVal(&obj_reg_in.condInput, DEST_RESC_NAME_KW, resource);
+    }
+
+    if (flags & VERIFY_CHECKSUM) {
+        logmsg(DEBUG, "Server will verify '%s' on registration",
+               rods_path->outPath);
+        addKeyVal(&obj_reg_in.condInput, VERIFY_CHKSUM_KW, "");
+    }
+    else if (flags & CALCULATE_CHECKSUM) {
+        logmsg(DEBUG, "Server will calculate checksum for '%s'",
+               rods_path->outPath);
+        addKeyVal(&obj_reg_in.condInput, REG_CHKSUM_KW, "");
+    }
+
+    if (flags & FORCE) {
+        addKeyVal(&obj_reg_in.condInput, FORCE_FLAG_KW, "");
+    }
+
+    status = rcPhyPathReg(conn, &obj_reg_in);
+    clearKeyVal(&obj_reg_in.condInput);
+
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to register '%s' as '%s': error %d %s",
+                        phys_path, rods_path->outPath, status, err_name);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Registered '%s' as '%s'", phys_path, rods_path->outPath);
+
+finally:
+    return error->code;
+}
+
+int replicate_data_obj(rcComm_t *conn, const char *obj_path,
+                       const char *resource, int flags,
+                       baton_error_t *error) {
+    dataObjInp_t obj_repl_in;
+    int status;
+
+    init_baton_error(error);
+
+    memset(&obj_repl_in, 0, sizeof obj_repl_in);
+
+    if (strnlen(obj_path, MAX_NAME_LEN) == MAX_NAME_LEN) {
+        set_baton_error(error, USER_PATH_EXCEEDS_MAX,
+                        "iRODS path '%s' is too long (exceeds %d)",
+                        obj_path, MAX_NAME_LEN);
+        goto finally;
+    }
+    snprintf(obj_repl_in.objPath, MAX_NAME_LEN, "%s", obj_path);
+
+    if (resource) {
+        addKeyVal(&obj_repl_in.condInput, DEST_RESC_NAME_KW, resource);
+    }
+    if (flags & ADMIN_MODE) {
+        addKeyVal(&obj_repl_in.condInput, ADMIN_KW, "");
+    }
+    if (flags & VERIFY_CHECKSUM) {
+        logmsg(DEBUG, "Server will verify '%s' after replication",
+               obj_path);
+        addKeyVal(&obj_repl_in.condInput, VERIFY_CHKSUM_KW, "");
+    }
+    if (flags & UPDATE_STALE) {
+        logmsg(DEBUG, "Updating stale replicas of '%s'", obj_path);
+        addKeyVal(&obj_repl_in.condInput, UPDATE_REPL_KW, "");
+    }
+
+    status = rcDataObjRepl(conn, &obj_repl_in);
+    clearKeyVal(&obj_repl_in.condInput);
+
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to replicate '%s'%s%s: error %d %s",
+                        obj_path, resource ? " to " : "",
+                        resource ? resource : "", status, err_name);
+        goto finally;
+    }
+
+    logmsg(NOTICE, "Replicated '%s'%s%s", obj_path, resource ? " to " : "",
+           resource ? resource : "");
+
+finally:
+    return error->code;
+}
+
 size_t write_data_obj(rcComm_t *conn, FILE *in, rodsPath_t *rods_path,
                       size_t buffer_size, int flags, baton_error_t *error) {
     data_obj_file_t *obj = NULL;
@@ -162,6 +277,12 @@ size_t write_data_obj(rcComm_t *conn, FILE *in, rodsPath_t *rods_path,
     obj = open_data_obj(conn, rods_path, O_WRONLY, flags, error);
     if (error->code != 0) goto finally;
 
+    // When writing from a regular file, the MD5 calculated here may
+    // be cached to save re-reading the file to verify it later
+    struct stat st_before;
+    int cacheable = get_checksum_cache_dir() && ftell(in) == 0 &&
+        fstat(fileno(in), &st_before) == 0 && S_ISREG(st_before.st_mode);
+
     unsigned char digest[16];
     EVP_MD_CTX *context = compat_MD5Init(error);
     if (error->code != 0) {
@@ -197,6 +318,18 @@ size_t write_data_obj(rcComm_t *conn, FILE *in, rodsPath_t *rods_path,
     }
     set_md5_last_read(obj, digest);
 
+    struct stat st_after;
+    if (cacheable && !ferror(in) && fstat(fileno(in), &st_after) == 0 &&
+        same_file_state(&st_before, &st_after)) {
+        baton_error_t cache_error;
+        set_cached_checksum(&st_after, CHECKSUM_ALGORITHM_MD5,
+                            obj->md5_last_read, &cache_error);
+        if (cache_error.code != 0) {
+            logmsg(WARN, "Failed to cache the checksum of '%s': %s",
+                   obj->path, cache_error.message);
+        }
+    }
+
     int status = close_data_obj(conn, obj);
     if (status < 0) {
         char *err_subname;
@@ -228,6 +361,704 @@ finally:
     return num_written;
 }
 
+size_t write_data_obj_content(rcComm_t *conn, const char *content,
+                              size_t len, rodsPath_t *rods_path,
+                              size_t buffer_size, int flags,
+                              baton_error_t *error) {
+    char *decoded   = NULL;
+    FILE *in        = NULL;
+    size_t num_written = 0;
+
+    init_baton_error(error);
+
+    if (flags & BASE64_ENCODING) {
+        decoded = calloc(BASE64_DECODED_MAX_LEN(len) + 1, sizeof (char));
+        if (!decoded) {
+            set_baton_error(error, errno, "Failed to allocate memory: "
+                            "error %d %s", errno, strerror(errno));
+            goto finally;
+        }
+
+        int valid;
+        len = base64_decode(content, len, decoded, &valid);
+        if (!valid) {
+            set_baton_error(error, CAT_INVALID_ARGUMENT,
+                            "Invalid base64 data for '%s'",
+                            rods_path->outPath);
+            goto finally;
+        }
+        content = decoded;
+    }
+
+    // POSIX permits fmemopen to reject a zero-length buffer
+    if (len > 0) {
+        in = fmemopen((void *) content, len, "r");
+    }
+    else {
+        in = fopen("/dev/null", "r");
+    }
+    if (!in) {
+        set_baton_error(error, errno, "Failed to open a memory stream: "
+                        "error %d %s", errno, strerror(errno));
+        goto finally;
+    }
+
+    num_written = write_data_obj(conn, in, rods_path, buffer_size, flags,
+                                 error);
+
+finally:
+    if (in)      fclose(in);
+    if (decoded) free(decoded);
+
+    return num_written;
+}
+
+size_t write_data_obj_resumable(rcComm_t *conn, const char *local_path,
+                                rodsPath_t *rods_path, size_t buffer_size,
+                                int flags, baton_error_t *error) {
+    transfer_journal_t *journal = NULL;
+    data_obj_file_t *obj        = NULL;
+    EVP_MD_CTX *context         = NULL;
+    char *buffer                = NULL;
+    char *identity              = NULL;
+    FILE *in                    = NULL;
+    size_t offset               = 0;
+
+    init_baton_error(error);
+
+    if (buffer_size == 0) {
+        set_baton_error(error, -1, "Invalid buffer_size argument %zu",
+                        buffer_size);
+        goto finally;
+    }
+
+    in = fopen(local_path, "r");
+    if (!in) {
+        set_baton_error(error, errno,
+                        "Failed to open '%s' for reading: error %d %s",
+                        local_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    struct stat st;
+    if (fstat(fileno(in), &st) != 0 || !S_ISREG(st.st_mode)) {
+        set_baton_error(error, USER_INPUT_PATH_ERR,
+                        "Cannot resume writing from '%s' because it is not "
+                        "a regular file", local_path);
+        goto finally;
+    }
+
+    // The journal is valid only while the local file is unchanged
+    const char *format = "put %lld %lld %s";
+    long long size  = st.st_size;
+    long long mtime = (long long) st.st_mtim.tv_sec * 1000000000LL +
+        st.st_mtim.tv_nsec;
+    int len = snprintf(NULL, 0, format, size, mtime, rods_path->outPath);
+    identity = calloc(len + 1, sizeof (char));
+    if (!identity) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+    snprintf(identity, len + 1, format, size, mtime, rods_path->outPath);
+
+    // The directory of the local file may not be writable, so the
+    // journal is kept elsewhere
+    journal = open_put_journal(&st, identity, error);
+    if (error->code != 0) goto finally;
+
+    unsigned char digest[16];
+    context = compat_MD5Init(error);
+    if (error->code != 0) goto finally;
+
+    offset = validate_transfer_journal(journal, in, context, buffer_size,
+                                       error);
+    if (error->code != 0) goto finally;
+
+    if (offset > 0 && rods_path->objState == EXIST_ST) {
+        logmsg(NOTICE, "Resuming write of '%s' to '%s' at offset %zu",
+               local_path, rods_path->outPath, offset);
+
+        baton_error_t resume_error;
+        obj = open_data_obj(conn, rods_path, O_WRONLY, flags | RESUME,
+                            &resume_error);
+        if (resume_error.code == 0) {
+            seek_data_obj(conn, obj, offset, &resume_error);
+        }
+
+        if (resume_error.code != 0) {
+            logmsg(WARN, "Failed to resume writing '%s', restarting: %s",
+                   rods_path->outPath, resume_error.message);
+            if (obj) {
+                close_data_obj(conn, obj);
+                free_data_obj(obj);
+                obj = NULL;
+            }
+            offset = 0;
+        }
+    }
+    else {
+        offset = 0;
+    }
+
+    if (offset == 0) {
+        // Nothing to resume, so start afresh with a new MD5 context
+        if (journal->num_chunks > 0) {
+            reset_transfer_journal(journal, error);
+            if (error->code != 0) goto finally;
+        }
+
+        MD5_FREE(context);
+        context = compat_MD5Init(error);
+        if (error->code != 0) goto finally;
+
+        if (fseeko(in, 0, SEEK_SET) != 0) {
+            set_baton_error(error, errno,
+                            "Failed to seek in '%s': error %d %s",
+                            local_path, errno, strerror(errno));
+            goto finally;
+        }
+
+        obj = open_data_obj(conn, rods_path, O_WRONLY, flags & ~RESUME,
+                            error);
+        if (error->code != 0) goto finally;
+    }
+
+    buffer = calloc(buffer_size + 1, sizeof (char));
+    if (!buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    size_t nr;
+    while ((nr = fread(buffer, 1, buffer_size, in)) > 0) {
+        logmsg(DEBUG, "Writing %zu bytes from '%s' to '%s'", nr,
+               local_path, obj->path);
+
+        size_t nw = write_chunk(conn, buffer, obj, nr, error);
+        if (error->code != 0) goto finally;
+        if (nw != nr) {
+            set_baton_error(error, -1, "Wrote %zu of %zu bytes to '%s'",
+                            nw, nr, obj->path);
+            goto finally;
+        }
+
+        compat_MD5Update(context, (unsigned char *) buffer, nr, error);
+        if (error->code != 0) {
+            context = NULL;
+            goto finally;
+        }
+
+        journal_chunk(journal, offset, buffer, nr, error);
+        if (error->code != 0) goto finally;
+
+        offset += nr;
+    }
+
+    if (ferror(in)) {
+        set_baton_error(error, -1, "Failed to read from '%s'", local_path);
+        goto finally;
+    }
+
+    compat_MD5Final(digest, context, error);
+    if (error->code != 0) {
+        context = NULL;
+        goto finally;
+    }
+    set_md5_last_read(obj, digest);
+
+    char md5[33];
+    snprintf(md5, sizeof md5, "%s", obj->md5_last_read);
+
+    int status = close_data_obj(conn, obj);
+    free_data_obj(obj);
+    obj = NULL;
+
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to close data object: '%s' error %d %s",
+                        rods_path->outPath, status, err_name);
+        goto finally;
+    }
+
+    // Bytes written before the resume are not re-read from the
+    // server, so the server must calculate the checksum afresh
+    verify_data_obj_checksum(conn, rods_path->outPath, local_path, md5, 1,
+                             error);
+    if (error->code != 0) goto finally;
+
+    logmsg(NOTICE, "Wrote %zu bytes to '%s' having MD5 %s",
+           offset, rods_path->outPath, md5);
+
+finally:
+    if (obj) {
+        close_data_obj(conn, obj);
+        free_data_obj(obj);
+    }
+    if (in)       fclose(in);
+    if (context)  MD5_FREE(context);
+    if (journal)  close_transfer_journal(journal, error->code == 0);
+    if (identity) free(identity);
+    if (buffer)   free(buffer);
+
+    return offset;
+}
+
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+
+/**
+ *  @struct write_range
+ *  @brief A byte range of a local file to be written to a data object
+ *  by one stream.
+ */
+typedef struct write_range {
+    /** The connection of the stream */
+    rcComm_t *conn;
+    /** The data object handle of the stream */
+    data_obj_file_t *obj;
+    /** The local file path */
+    const char *local_path;
+    /** The offset of the first byte */
+    size_t offset;
+    /** The number of bytes */
+    size_t length;
+    /** The number of bytes to copy at one time */
+    size_t buffer_size;
+    /** The number of bytes written */
+    size_t num_written;
+    /** An error report for the stream */
+    baton_error_t error;
+} write_range_t;
+
+static void *write_range_stream(void *arg) {
+    write_range_t *range = arg;
+    baton_error_t *error = &range->error;
+    char *buffer = NULL;
+    FILE *in     = NULL;
+
+    init_baton_error(error);
+
+    in = fopen(range->local_path, "r");
+    if (!in) {
+        set_baton_error(error, errno,
+                        "Failed to open '%s' for reading: error %d %s",
+                        range->local_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    if (fseeko(in, range->offset, SEEK_SET) != 0) {
+        set_baton_error(error, errno,
+                        "Failed to seek to offset %zu in '%s': error %d %s",
+                        range->offset, range->local_path, errno,
+                        strerror(errno));
+        goto finally;
+    }
+
+    buffer = calloc(range->buffer_size + 1, sizeof (char));
+    if (!buffer) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    seek_data_obj(range->conn, range->obj, range->offset, error);
+    if (error->code != 0) goto finally;
+
+    while (range->num_written < range->length) {
+        size_t remaining = range->length - range->num_written;
+        size_t len = remaining < range->buffer_size ? remaining :
+            range->buffer_size;
+
+        size_t nr = fread(buffer, 1, len, in);
+        if (nr == 0) {
+            set_baton_error(error, -1, "Failed to read from '%s' at "
+                            "offset %zu", range->local_path,
+                            range->offset + range->num_written);
+            goto finally;
+        }
+
+        size_t nw = write_chunk(range->conn, buffer, range->obj, nr, error);
+        if (error->code != 0) goto finally;
+        if (nw != nr) {
+            set_baton_error(error, -1, "Wrote %zu of %zu bytes to '%s'",
+                            nw, nr, range->obj->path);
+            goto finally;
+        }
+
+        range->num_written += nw;
+    }
+
+    logmsg(DEBUG, "Wrote range %zu-%zu of '%s' to '%s'", range->offset,
+           range->offset + range->length, range->local_path,
+           range->obj->path);
+
+finally:
+    if (in)     fclose(in);
+    if (buffer) free(buffer);
+
+    return NULL;
+}
+
+static int get_replica_token(rcComm_t *conn, data_obj_file_t *obj,
+                             char **replica_token, char **resc_hier,
+                             baton_error_t *error) {
+    char *output = NULL;
+    json_t *info = NULL;
+
+    init_baton_error(error);
+
+    char input[64];
+    snprintf(input, sizeof input, "{\"fd\": %d}", obj->open_obj->l1descInx);
+
+    int status = rc_get_file_descriptor_info(conn, input, &output);
+    if (status < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to get the replica token of '%s': "
+                        "error %d %s", obj->path, status, err_name);
+        goto finally;
+    }
+
+    json_error_t load_error;
+    info = json_loads(output, 0, &load_error);
+    if (!info) {
+        set_baton_error(error, -1, "Failed to parse the file descriptor "
+                        "info of '%s': %s", obj->path, load_error.text);
+        goto finally;
+    }
+
+    json_t *obj_info = json_object_get(info, "data_object_info");
+    const char *token =
+        json_string_value(json_object_get(info, "replica_token"));
+    const char *hier =
+        json_string_value(json_object_get(obj_info, "resource_hierarchy"));
+
+    if (!token || !hier) {
+        set_baton_error(error, -1, "The server did not report a replica "
+                        "token for '%s'", obj->path);
+        goto finally;
+    }
+
+    *replica_token = copy_str(token, MAX_STR_LEN);
+    *resc_hier     = copy_str(hier, MAX_STR_LEN);
+
+finally:
+    if (info)   json_decref(info);
+    if (output) free(output);
+
+    return error->code;
+}
+
+static data_obj_file_t *open_replica_stream(rcComm_t *conn,
+                                            const char *obj_path,
+                                            const char *replica_token,
+                                            const char *resc_hier,
+                                            baton_error_t *error) {
+    data_obj_file_t *data_obj = NULL;
+    dataObjInp_t obj_open_in;
+
+    init_baton_error(error);
+
+    memset(&obj_open_in, 0, sizeof obj_open_in);
+    snprintf(obj_open_in.objPath, MAX_NAME_LEN, "%s", obj_path);
+    obj_open_in.openFlags = O_WRONLY;
+
+    // Opening with the token of the replica being written joins that
+    // write, rather than waiting for it to finish
+    addKeyVal(&obj_open_in.condInput, REPLICA_TOKEN_KW, replica_token);
+    addKeyVal(&obj_open_in.condInput, RESC_HIER_STR_KW, resc_hier);
+
+    int descriptor = rcDataObjOpen(conn, &obj_open_in);
+    clearKeyVal(&obj_open_in.condInput);
+
+    if (descriptor < 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(descriptor, &err_subname);
+        set_baton_error(error, descriptor,
+                        "Failed to open a stream to '%s': error %d %s",
+                        obj_path, descriptor, err_name);
+        goto finally;
+    }
+
+    data_obj = calloc(1, sizeof (data_obj_file_t));
+    if (!data_obj) goto error_alloc;
+
+    data_obj->path     = obj_path;
+    data_obj->flags    = obj_open_in.openFlags;
+    data_obj->open_obj = calloc(1, sizeof (openedDataObjInp_t));
+    if (!data_obj->open_obj) goto error_alloc;
+
+    data_obj->open_obj->l1descInx = descriptor;
+
+    return data_obj;
+
+error_alloc:
+    set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                    errno, strerror(errno));
+    if (data_obj) free_data_obj(data_obj);
+
+    openedDataObjInp_t obj_close_in;
+    memset(&obj_close_in, 0, sizeof obj_close_in);
+    obj_close_in.l1descInx = descriptor;
+    rcDataObjClose(conn, &obj_close_in);
+
+finally:
+    return NULL;
+}
+
+static void close_secondary_streams(write_range_t *ranges, size_t num_streams,
+                                    baton_error_t *error) {
+    // The first range is written through the primary handle, which
+    // must be closed last to finalize the replica
+    for (size_t i = 1; i < num_streams; i++) {
+        write_range_t *range = &ranges[i];
+
+        if (range->obj) {
+            // Leave the size, status and checksum of the replica to be
+            // updated when the primary handle is closed
+            char input[256];
+            snprintf(input, sizeof input,
+                     "{\"fd\": %d, \"update_size\": false, "
+                     "\"update_status\": false, \"compute_checksum\": false, "
+                     "\"send_notifications\": false}",
+                     range->obj->open_obj->l1descInx);
+
+            int status = rc_replica_close(range->conn, input);
+            if (status < 0 && error->code == 0) {
+                char *err_subname;
+                const char *err_name = rodsErrorName(status, &err_subname);
+                set_baton_error(error, status,
+                                "Failed to close a stream to '%s': "
+                                "error %d %s", range->obj->path, status,
+                                err_name);
+            }
+
+            free_data_obj(range->obj);
+            range->obj = NULL;
+        }
+
+        if (range->conn) {
+            rcDisconnect(range->conn);
+            range->conn = NULL;
+        }
+    }
+}
+
+static size_t write_data_obj_ranges(rcComm_t *conn, const char *local_path,
+                                    rodsPath_t *rods_path, size_t size,
+                                    size_t buffer_size, size_t num_streams,
+                                    int flags, baton_error_t *error) {
+    data_obj_file_t *obj  = NULL;
+    write_range_t *ranges = NULL;
+    pthread_t *threads    = NULL;
+    char *replica_token   = NULL;
+    char *resc_hier       = NULL;
+    size_t num_started    = 0;
+    size_t num_written    = 0;
+
+    init_baton_error(error);
+
+    ranges  = calloc(num_streams, sizeof (write_range_t));
+    threads = calloc(num_streams, sizeof (pthread_t));
+    if (!ranges || !threads) {
+        set_baton_error(error, errno, "Failed to allocate memory: error %d %s",
+                        errno, strerror(errno));
+        goto finally;
+    }
+
+    obj = open_data_obj(conn, rods_path, O_WRONLY, flags, error);
+    if (error->code != 0) goto finally;
+
+    get_replica_token(conn, obj, &replica_token, &resc_hier, error);
+    if (error->code != 0) goto finally;
+
+    // Each stream writes one contiguous range, the last taking any
+    // remainder
+    size_t stride = size / num_streams;
+    for (size_t i = 0; i < num_streams; i++) {
+        write_range_t *range = &ranges[i];
+        range->local_path  = local_path;
+        range->offset      = i * stride;
+        range->length      = (i == num_streams - 1) ?
+            size - range->offset : stride;
+        range->buffer_size = buffer_size;
+
+        if (i == 0) {
+            range->conn = conn;
+            range->obj  = obj;
+            continue;
+        }
+
+        // rods_login loads the environment into its argument
+        rodsEnv stream_env;
+        range->conn = rods_login(&stream_env);
+        if (!range->conn) {
+            set_baton_error(error, -1, "Failed to connect stream %zu "
+                            "to write '%s'", i, rods_path->outPath);
+            goto finally;
+        }
+
+        range->obj = open_replica_stream(range->conn, rods_path->outPath,
+                                         replica_token, resc_hier, error);
+        if (error->code != 0) goto finally;
+    }
+
+    logmsg(NOTICE, "Writing '%s' to '%s' using %zu streams", local_path,
+           rods_path->outPath, num_streams);
+
+    for (size_t i = 0; i < num_streams; i++) {
+        int status = pthread_create(&threads[i], NULL, write_range_stream,
+                                    &ranges[i]);
+        if (status != 0) {
+            set_baton_error(error, status, "Failed to start stream %zu "
+                            "to write '%s': error %d %s", i,
+                            rods_path->outPath, status, strerror(status));
+            break;
+        }
+        num_started++;
+    }
+
+    // The local checksum is calculated while the streams are writing
+    char md5[NAME_LEN];
+    memset(md5, 0, sizeof md5);
+    baton_error_t md5_error;
+    init_baton_error(&md5_error);
+    if (num_started == num_streams) {
+        checksum_local_file(local_path, CHECKSUM_ALGORITHM_MD5, md5,
+                            &md5_error);
+    }
+
+    for (size_t i = 0; i < num_started; i++) {
+        pthread_join(threads[i], NULL);
+
+        write_range_t *range = &ranges[i];
+        num_written += range->num_written;
+        if (range->error.code != 0 && error->code == 0) {
+            *error = range->error;
+        }
+    }
+    if (error->code == 0 && md5_error.code != 0) {
+        *error = md5_error;
+    }
+
+    close_secondary_streams(ranges, num_streams, error);
+
+    int status = close_data_obj(conn, obj);
+    free_data_obj(obj);
+    obj = NULL;
+
+    if (status < 0 && error->code == 0) {
+        char *err_subname;
+        const char *err_name = rodsErrorName(status, &err_subname);
+        set_baton_error(error, status,
+                        "Failed to close data object: '%s' error %d %s",
+                        rods_path->outPath, status, err_name);
+    }
+    if (error->code != 0) goto finally;
+
+    if (num_written != size) {
+        set_baton_error(error, -1, "Read %zu bytes but wrote %zu bytes "
+                        "to '%s'", size, num_written, rods_path->outPath);
+        goto finally;
+    }
+
+    // No single stream saw all the data, so the server must calculate
+    // the checksum afresh
+    verify_data_obj_checksum(conn, rods_path->outPath, local_path, md5, 1,
+                             error);
+    if (error->code != 0) goto finally;
+
+    logmsg(NOTICE, "Wrote %zu bytes to '%s' having MD5 %s using %zu "
+           "streams", num_written, rods_path->outPath, md5, num_streams);
+
+finally:
+    if (ranges) close_secondary_streams(ranges, num_streams, error);
+    if (obj) {
+        close_data_obj(conn, obj);
+        free_data_obj(obj);
+    }
+    if (replica_token) free(replica_token);
+    if (resc_hier)     free(resc_hier);
+    if (threads)       free(threads);
+    if (ranges)        free(ranges);
+
+    return num_written;
+}
+
+#endif
+
+size_t write_data_obj_parallel(rcComm_t *conn, const char *local_path,
+                               rodsPath_t *rods_path, size_t buffer_size,
+                               size_t num_streams, int flags,
+                               baton_error_t *error) {
+    size_t num_written = 0;
+
+    init_baton_error(error);
+
+    if (buffer_size == 0) {
+        set_baton_error(error, -1, "Invalid buffer_size argument %zu",
+                        buffer_size);
+        goto finally;
+    }
+
+    struct stat st;
+    if (stat(local_path, &st) != 0) {
+        set_baton_error(error, errno, "Failed to stat '%s': error %d %s",
+                        local_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    // Small files are not worth the cost of the extra connections
+    size_t size = st.st_size;
+    if (!S_ISREG(st.st_mode)) {
+        num_streams = 1;
+    }
+    if (num_streams > PARALLEL_WRITE_MAX_STREAMS) {
+        num_streams = PARALLEL_WRITE_MAX_STREAMS;
+    }
+    if (num_streams > size / PARALLEL_WRITE_MIN_RANGE) {
+        num_streams = size / PARALLEL_WRITE_MIN_RANGE;
+    }
+
+#if IRODS_VERSION_INTEGER && IRODS_VERSION_INTEGER >= (4*1000000 + 2*1000 + 9)
+    if (num_streams > 1) {
+        num_written = write_data_obj_ranges(conn, local_path, rods_path, size,
+                                            buffer_size, num_streams, flags,
+                                            error);
+        goto finally;
+    }
+#else
+    if (num_streams > 1) {
+        logmsg(NOTICE, "Parallel writes require iRODS 4.2.9 or later; "
+               "writing '%s' using one stream", rods_path->outPath);
+    }
+#endif
+
+    FILE *in = fopen(local_path, "r");
+    if (!in) {
+        set_baton_error(error, errno,
+                        "Failed to open '%s' for reading: error %d %s",
+                        local_path, errno, strerror(errno));
+        goto finally;
+    }
+
+    num_written = write_data_obj(conn, in, rods_path, buffer_size, flags,
+                                 error);
+    int status = fclose(in);
+
+    if (error->code == 0 && status != 0) {
+        set_baton_error(error, errno, "Failed to close '%s': error %d %s",
+                        local_path, errno, strerror(errno));
+    }
+
+finally:
+    return num_written;
+}
+
 size_t write_chunk(rcComm_t *conn, char *buffer, data_obj_file_t *data_obj,
                    size_t len, baton_error_t *error) {
     init_baton_error(error);
@@ -27,6 +27,12 @@
 #include "config.h"
 #include "read.h"
 
+// The largest number of streams used to write one data object
+#define PARALLEL_WRITE_MAX_STREAMS 16
+
+// The smallest range of a data object written by one stream
+#define PARALLEL_WRITE_MIN_RANGE (32 * 1024 * 1024)
+
 /**
  * Write to a data object from a local file using the put protocol.
  *
@@ -52,6 +58,49 @@ int put_data_obj(rcComm_t *conn, const char *local_path, rodsPath_t *rods_path,
                  char *default_resource, char *checksum, int flags,
 		 baton_error_t *error);
 
+/**
+ * Register a file on storage visible to an iRODS resource server as a
+ * data object, without copying it.
+ *
+ * @param[in]  conn       An open iRODS connection.
+ * @param[in]  phys_path  An absolute path to the file on the resource
+ *                        server.
+ * @param[in]  rods_path  An iRODS data object path.
+ * @param[in]  resource   The resource whose storage holds the file.
+ *                        Optional, may be NULL to use the default
+ *                        resource.
+ * @param[in]  flags      CALCULATE_CHECKSUM to calculate and register a
+ *                        checksum on the server side, VERIFY_CHECKSUM
+ *                        to calculate, register and verify a checksum
+ *                        on the server side, FORCE to re-register an
+ *                        existing data object. Optional.
+ * @param[out] error      An error report struct.
+ *
+ * @return 0 on success, iRODS error code on failure.
+ */
+int register_data_obj(rcComm_t *conn, const char *phys_path,
+                      rodsPath_t *rods_path, const char *resource, int flags,
+                      baton_error_t *error);
+
+/**
+ * Replicate a data object on the server side.
+ *
+ * @param[in]  conn      An open iRODS connection.
+ * @param[in]  obj_path  An iRODS data object path.
+ * @param[in]  resource  The resource of the new replica. Optional, may
+ *                       be NULL to use the default resource.
+ * @param[in]  flags     ADMIN_MODE to replicate as an administrator,
+ *                       VERIFY_CHECKSUM to verify the new replica's
+ *                       checksum, UPDATE_STALE to update stale replicas
+ *                       only, rather than create a new one. Optional.
+ * @param[out] error     An error report struct.
+ *
+ * @return 0 on success, iRODS error code on failure.
+ */
+int replicate_data_obj(rcComm_t *conn, const char *obj_path,
+                       const char *resource, int flags,
+                       baton_error_t *error);
+
 /**
  * Write bytes from a buffer into a data object.
  *
@@ -82,6 +131,76 @@ size_t write_chunk(rcComm_t *conn, char *buffer, data_obj_file_t *obj_file,
 size_t write_data_obj(rcComm_t *conn, FILE *in, rodsPath_t *rods_path,
                       size_t buffer_size, int flags, baton_error_t *error);
 
+/**
+ * Write to a data object from a buffer.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  content     The contents to write.
+ * @param[in]  len         The length of the contents in bytes.
+ * @param[in]  rods_path   An iRODS data object path.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[in]  flags       BASE64_ENCODING if the contents are base64
+ *                         which is to be decoded, WRITE_LOCK to use an
+ *                         advisory lock server-side. Optional.
+ * @param[out] error       An error report struct.
+ *
+ * @return The number of bytes written in total.
+ */
+size_t write_data_obj_content(rcComm_t *conn, const char *content,
+                              size_t len, rodsPath_t *rods_path,
+                              size_t buffer_size, int flags,
+                              baton_error_t *error);
+
+/**
+ * Write to a data object from a local file, resuming any previous
+ * attempt recorded in the file's journal (see open_put_journal).
+ * Each chunk is journalled once written to the data object. The
+ * journal is removed once the data object has been verified against
+ * the local file.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  local_path  A local file path.
+ * @param[in]  rods_path   An iRODS data object path.
+ * @param[in]  buffer_size The number of bytes to copy at one time.
+ * @param[in]  flags       WRITE_LOCK to use an advisory lock server-side.
+                           Optional.
+ * @param[out] error       An error report struct.
+ *
+ * @return The size of the data object in bytes.
+ */
+size_t write_data_obj_resumable(rcComm_t *conn, const char *local_path,
+                                rodsPath_t *rods_path, size_t buffer_size,
+                                int flags, baton_error_t *error);
+
+/**
+ * Write to a data object from a local file using several streams at
+ * once, each over its own connection to the same server. The data
+ * object is created once and each stream writes a disjoint range of it.
+ * The checksum is then calculated on the server side and verified
+ * against the local file.
+ *
+ * The number of streams is limited so that each writes at least
+ * PARALLEL_WRITE_MIN_RANGE bytes. If that leaves one stream, the local
+ * file is not a regular file, or the iRODS version is earlier than
+ * 4.2.9, the data object is written as by write_data_obj.
+ *
+ * @param[in]  conn        An open iRODS connection.
+ * @param[in]  local_path  A local file path.
+ * @param[in]  rods_path   An iRODS data object path.
+ * @param[in]  buffer_size The number of bytes to copy at one time by
+ *                         each stream.
+ * @param[in]  num_streams The maximum number of streams.
+ * @param[in]  flags       WRITE_LOCK to use an advisory lock server-side.
+                           Optional.
+ * @param[out] error       An error report struct.
+ *
+ * @return The number of bytes copied in total.
+ */
+size_t write_data_obj_parallel(rcComm_t *conn, const char *local_path,
+                               rodsPath_t *rods_path, size_t buffer_size,
+                               size_t num_streams, int flags,
+                               baton_error_t *error);
+
 int remove_data_object(rcComm_t *conn, rodsPath_t *rods_path, int flags,
                       baton_error_t *error);
 
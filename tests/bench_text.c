@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2026 Genome Research Ltd. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file bench_text.c
+ * @author Keith James <kdj@sanger.ac.uk>
+ *
+ * Measure the throughput of the text kernels (UTF-8 validation, ASCII
+ * detection and Latin-1 transcoding) with each kernel the CPU supports.
+ * Run with "make bench".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/utilities.h"
+
+// The size of each test buffer
+#define BENCH_LEN (64 * 1024 * 1024)
+
+// The number of times each measurement is repeated; the fastest is
+// reported
+#define BENCH_REPEATS 5
+
+typedef size_t (*bench_fn)(const char *input, char *output, size_t len);
+
+static const char *KERNEL_NAMES[] = { "scalar", "sse4.2", "avx2" };
+
+static volatile size_t sink;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill(char *buffer, size_t len, const char *pattern) {
+    size_t plen = strlen(pattern);
+    for (size_t i = 0; i < len; i++) buffer[i] = pattern[i % plen];
+
+    // End on a whole pattern, so that the buffer is valid UTF-8
+    while (len % plen != 0) buffer[--len] = ' ';
+}
+
+static size_t bench_utf8_valid(const char *input, char *output,
+                               size_t len) {
+    (void) output;
+    return utf8_valid(input, len);
+}
+
+static size_t bench_ascii_prefix_len(const char *input, char *output,
+                                     size_t len) {
+    (void) output;
+    return ascii_prefix_len(input, len);
+}
+
+static size_t bench_to_utf8(const char *input, char *output, size_t len) {
+    return to_utf8(input, output, len * 2 + 1);
+}
+
+static void run(const char *name, bench_fn fn, const char *input,
+                char *output) {
+    double scalar_secs = 0;
+
+    for (int k = TEXT_KERNEL_SCALAR; k <= TEXT_KERNEL_AVX2; k++) {
+        if (select_text_kernel((text_kernel) k) != (text_kernel) k) continue;
+
+        double best = 0;
+        for (int r = 0; r < BENCH_REPEATS; r++) {
+            double start = now();
+            sink = fn(input, output, BENCH_LEN);
+            double secs = now() - start;
+            if (r == 0 || secs < best) best = secs;
+        }
+        if (k == TEXT_KERNEL_SCALAR) scalar_secs = best;
+
+        printf("%-24s %-8s %8.2f GiB/s %6.2fx\n", name, KERNEL_NAMES[k],
+               BENCH_LEN / best / (1024.0 * 1024 * 1024), scalar_secs / best);
+    }
+}
+
+int main() {
+    char *ascii  = malloc(BENCH_LEN + 1);
+    char *utf8   = malloc(BENCH_LEN + 1);
+    char *latin1 = malloc(BENCH_LEN + 1);
+    char *output = malloc(BENCH_LEN * 2 + 1);
+    if (!ascii || !utf8 || !latin1 || !output) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+
+    fill(ascii, BENCH_LEN, "The quick brown fox jumps over the lazy dog. ");
+    fill(utf8, BENCH_LEN, "Caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9"
+         "e \xe2\x82\xac" "5 \xf0\x9f\x98\x80 na\xc3\xafve r\xc3\xa9sum"
+         "\xc3\xa9 ");
+    fill(latin1, BENCH_LEN, "Sample ACGT metadata, caf\xe9 cr\xe8me, "
+         "study 1234, na\xefve r\xe9sum\xe9. ");
+    ascii[BENCH_LEN] = utf8[BENCH_LEN] = latin1[BENCH_LEN] = '\0';
+
+    printf("%d MiB buffers, best of %d runs; the best kernel on this CPU "
+           "is %s\n\n", BENCH_LEN / (1024 * 1024), BENCH_REPEATS,
+           KERNEL_NAMES[best_text_kernel()]);
+
+    run("utf8_valid ASCII",       bench_utf8_valid,       ascii,  output);
+    run("utf8_valid UTF-8",       bench_utf8_valid,       utf8,   output);
+    run("ascii_prefix_len ASCII", bench_ascii_prefix_len, ascii,  output);
+    run("to_utf8 ASCII",          bench_to_utf8,          ascii,  output);
+    run("to_utf8 Latin-1",        bench_to_utf8,          latin1, output);
+
+    free(ascii);
+    free(utf8);
+    free(latin1);
+    free(output);
+
+    return 0;
+}
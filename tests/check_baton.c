@@ -19,7 +19,10 @@
  */
 
 #include <assert.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <stdint.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <jansson.h>
@@ -60,6 +63,14 @@ static void set_current_rods_root(char *in, char *out) {
     snprintf(out, MAX_PATH_LEN, "%s/%s.%d", rodsEnv.rodsCwd, in, getpid());
 }
 
+static int contains_json(json_t *array, json_t *value) {
+    for (size_t i = 0; i < json_array_size(array); i++) {
+        if (json_equal(json_array_get(array, i), value)) return 1;
+    }
+
+    return 0;
+}
+
 static void setup() {
     set_log_threshold(ERROR);
 
@@ -164,6 +175,36 @@ static void confirm_checksum(FILE *in, const char *expected_md5) {
     return;
 }
 
+// Run a stream of operations and return what they printed to stdout,
+// which must be freed by the caller
+static char *capture_operation(FILE *input, operation_args_t *args,
+                               int *status) {
+    FILE *out = tmpfile();
+    ck_assert_ptr_ne(out, NULL);
+
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    ck_assert_int_ne(saved_stdout, -1);
+    ck_assert_int_ne(dup2(fileno(out), STDOUT_FILENO), -1);
+
+    rewind(input);
+    *status = do_operation(input, baton_json_dispatch_op, args);
+
+    fflush(stdout);
+    ck_assert_int_ne(dup2(saved_stdout, STDOUT_FILENO), -1);
+    close(saved_stdout);
+
+    long len = ftell(out);
+    ck_assert_int_ge(len, 0);
+
+    char *output = calloc(len + 1, sizeof (char));
+    rewind(out);
+    ck_assert_int_eq(fread(output, 1, len, out), len);
+    fclose(out);
+
+    return output;
+}
+
 START_TEST(test_str_starts_with) {
     size_t len = MAX_STR_LEN;
     ck_assert_msg(str_starts_with("",   "",  len),    "'' starts with ''");
@@ -273,6 +314,416 @@ START_TEST(test_to_utf8) {
 
         ck_assert(maybe_utf8(out, sizeof out));
     }
+
+    // ASCII is copied, the rest transcoded, and the output truncated at
+    // a whole character
+    char latin1[] = "caf\xe9 cr\xe8me";
+    char utf8[32];
+    ck_assert_int_eq(to_utf8(latin1, utf8, sizeof utf8), 12);
+    ck_assert_str_eq(utf8, "caf\xc3\xa9 cr\xc3\xa8me");
+
+    char truncated[5];
+    ck_assert_int_eq(to_utf8(latin1, truncated, sizeof truncated), 3);
+    ck_assert_str_eq(truncated, "caf");
+}
+END_TEST
+
+// Can we find ASCII prefixes and validate UTF-8 bounded by length?
+START_TEST(test_utf8_valid) {
+    char buffer[64];
+    memset(buffer, 'a', sizeof buffer);
+
+    // A non-ASCII byte at each position, either side of word boundaries
+    for (size_t i = 0; i < sizeof buffer; i++) {
+        buffer[i] = (char) 0xc3;
+        ck_assert_int_eq(ascii_prefix_len(buffer, sizeof buffer), i);
+        ck_assert_int_eq(ascii_prefix_len(buffer, i), i);
+        ck_assert(!utf8_valid(buffer, sizeof buffer));
+        ck_assert(utf8_valid(buffer, i));
+        buffer[i] = 'a';
+    }
+    ck_assert_int_eq(ascii_prefix_len(buffer, sizeof buffer), sizeof buffer);
+
+    ck_assert(utf8_valid("", 0));
+    ck_assert(utf8_valid("a\0b", 3));
+    ck_assert(utf8_valid("abcdefgh\xc3\xa9", 10));
+    ck_assert(utf8_valid("\xf0\x9f\x98\x80", 4));
+
+    // Incomplete, overlong and surrogate sequences
+    ck_assert(!utf8_valid("abcdefgh\xc3", 9));
+    ck_assert(!utf8_valid("\xc0\xaf", 2));
+    ck_assert(!utf8_valid("\xed\xa0\x80", 3));
+    ck_assert(!utf8_valid("\xf4\x90\x80\x80", 4));
+}
+END_TEST
+
+// Can we validate UTF-8 in chunks which split characters?
+START_TEST(test_utf8_chunk_valid) {
+    // "a", U+00E9, U+20AC and U+1F600 in 1, 2, 3 and 4 bytes
+    const char *str = "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    size_t len = strlen(str);
+    size_t complete;
+
+    ck_assert(utf8_chunk_valid(str, len, &complete));
+    ck_assert_int_eq(complete, len);
+
+    // Every split leaves only complete characters before it
+    size_t boundaries[5] = { 0, 1, 3, 6, 10 };
+    for (size_t i = 0; i <= len; i++) {
+        ck_assert(utf8_chunk_valid(str, i, &complete));
+
+        size_t expected = 0;
+        for (int j = 0; j < 5; j++) {
+            if (boundaries[j] <= i) expected = boundaries[j];
+        }
+        ck_assert_int_eq(complete, expected);
+    }
+
+    // Invalid lead bytes, tail bytes and an overlong encoding
+    ck_assert(!utf8_chunk_valid("a\xff", 2, &complete));
+    ck_assert_int_eq(complete, 1);
+    ck_assert(!utf8_chunk_valid("\xc3\x28", 2, &complete));
+    ck_assert(!utf8_chunk_valid("\xe0\x80\x80", 3, &complete));
+
+    // NUL is valid
+    ck_assert(utf8_chunk_valid("a\0b", 3, &complete));
+    ck_assert_int_eq(complete, 3);
+}
+END_TEST
+
+// Do the vector text kernels agree with the scalar one?
+START_TEST(test_text_kernels) {
+    // Valid and invalid sequences, placed at every offset of a string
+    // long enough for the vector kernels, so that they cross the block
+    // boundaries
+    const char *sequences[] = { "\xc3\xa9", "\xe2\x82\xac",
+                                "\xf0\x9f\x98\x80", "\xff", "\xc0\xaf",
+                                "\xed\xa0\x80", "\xf4\x90\x80\x80",
+                                "\xe2\x82", "\x80", "\xc3" };
+    size_t num_sequences = sizeof sequences / sizeof sequences[0];
+    char buffer[200];
+
+    text_kernel best = best_text_kernel();
+
+    for (size_t s = 0; s < num_sequences; s++) {
+        size_t seq_len = strlen(sequences[s]);
+
+        for (size_t i = 0; i + seq_len <= sizeof buffer; i++) {
+            // Text with one non-ASCII character every 16 bytes
+            for (size_t j = 0; j < sizeof buffer; j += 16) {
+                memcpy(buffer + j, "abcdefghijklm\xc3\xa9 ", 16);
+            }
+            memcpy(buffer + i, sequences[s], seq_len);
+
+            select_text_kernel(TEXT_KERNEL_SCALAR);
+            size_t expected_complete;
+            int expected = utf8_chunk_valid(buffer, sizeof buffer,
+                                            &expected_complete);
+            size_t expected_ascii = ascii_prefix_len(buffer, sizeof buffer);
+
+            for (int k = TEXT_KERNEL_SSE42; k <= (int) best; k++) {
+                select_text_kernel((text_kernel) k);
+
+                size_t complete;
+                ck_assert_int_eq(utf8_chunk_valid(buffer, sizeof buffer,
+                                                  &complete), expected);
+                ck_assert_int_eq(complete, expected_complete);
+                ck_assert_int_eq(ascii_prefix_len(buffer, sizeof buffer),
+                                 expected_ascii);
+            }
+        }
+    }
+
+    // Latin-1 with non-ASCII characters at varying density
+    char latin1[257];
+    char expected_utf8[513];
+    char utf8[513];
+    for (size_t i = 0; i < 256; i++) {
+        latin1[i] = (char) (i % 7 == 0 ? 'a' : 0x80 + (i * 37) % 128);
+    }
+    latin1[256] = '\0';
+
+    select_text_kernel(TEXT_KERNEL_SCALAR);
+    size_t expected_len = to_utf8(latin1, expected_utf8, sizeof expected_utf8);
+    ck_assert_int_eq(expected_len, 256 + 256 - 37);
+
+    for (int k = TEXT_KERNEL_SSE42; k <= (int) best; k++) {
+        select_text_kernel((text_kernel) k);
+        ck_assert_int_eq(to_utf8(latin1, utf8, sizeof utf8), expected_len);
+        ck_assert_str_eq(utf8, expected_utf8);
+
+        // Truncated at a whole character, however little room there is
+        for (size_t max_len = 1; max_len < 100; max_len++) {
+            char truncated[100];
+            select_text_kernel(TEXT_KERNEL_SCALAR);
+            size_t expected_truncated = to_utf8(latin1, truncated, max_len);
+            select_text_kernel((text_kernel) k);
+            ck_assert_int_eq(to_utf8(latin1, utf8, max_len),
+                             expected_truncated);
+            ck_assert(memcmp(utf8, truncated, expected_truncated + 1) == 0);
+        }
+    }
+
+    select_text_kernel(best);
+}
+END_TEST
+
+// Can we escape strings for JSON as jansson does?
+START_TEST(test_print_json_escaped) {
+    const char *str = "a\"b\\c\nd\te\001f\0g\xc3\xa9";
+    size_t len = 15;
+
+    char *out = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&out, &size);
+    ck_assert_int_eq(print_json_escaped(str, len, stream), 0);
+    fclose(stream);
+
+    json_t *expected = json_stringn(str, len);
+    char *dumped = json_dumps(expected, JSON_ENCODE_ANY);
+
+    // Compare without the enclosing quotes
+    ck_assert_int_eq(size, strlen(dumped) - 2);
+    ck_assert(strncmp(out, dumped + 1, size) == 0);
+
+    json_decref(expected);
+    free(dumped);
+    free(out);
+}
+END_TEST
+
+// Can we encode and decode base64?
+START_TEST(test_base64) {
+    // RFC 4648 test vectors
+    const char *plain[7]   = { "", "f", "fo", "foo", "foob", "fooba",
+                               "foobar" };
+    const char *encoded[7] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==",
+                               "Zm9vYmE=", "Zm9vYmFy" };
+
+    for (int i = 0; i < 7; i++) {
+        size_t len = strlen(plain[i]);
+        char enc[BASE64_ENCODED_LEN(len)];
+        ck_assert_int_eq(base64_encode(plain[i], len, enc),
+                         strlen(encoded[i]));
+        ck_assert_str_eq(enc, encoded[i]);
+
+        size_t enc_len = strlen(encoded[i]);
+        char dec[BASE64_DECODED_MAX_LEN(enc_len) + 1];
+        int valid;
+        size_t dec_len = base64_decode(encoded[i], enc_len, dec, &valid);
+        ck_assert(valid);
+        ck_assert_int_eq(dec_len, len);
+        ck_assert(memcmp(dec, plain[i], len) == 0);
+    }
+
+    // Line breaks are ignored
+    char dec[16];
+    int valid;
+    ck_assert_int_eq(base64_decode("Zm9v\r\nYmFy\n", 11, dec, &valid), 6);
+    ck_assert(valid);
+    ck_assert(memcmp(dec, "foobar", 6) == 0);
+
+    // Invalid characters, length and padding are rejected
+    base64_decode("Zm9v!mFy", 8, dec, &valid);
+    ck_assert(!valid);
+    base64_decode("Zm9vY", 5, dec, &valid);
+    ck_assert(!valid);
+    base64_decode("Zg==Zg==", 8, dec, &valid);
+    ck_assert(!valid);
+    base64_decode("Z===", 4, dec, &valid);
+    ck_assert(!valid);
+
+    // Binary data survives the round trip
+    char bin[256];
+    for (int i = 0; i < 256; i++) bin[i] = (char) i;
+    char bin_enc[BASE64_ENCODED_LEN(256)];
+    size_t bin_enc_len = base64_encode(bin, 256, bin_enc);
+    char bin_dec[BASE64_DECODED_MAX_LEN(bin_enc_len)];
+    ck_assert_int_eq(base64_decode(bin_enc, bin_enc_len, bin_dec, &valid), 256);
+    ck_assert(valid);
+    ck_assert(memcmp(bin, bin_dec, 256) == 0);
+}
+END_TEST
+
+// Can we write tar headers, with pax extended headers where needed?
+START_TEST(test_write_tar_header) {
+    char name[201];
+    memset(name, 'a', 200);
+    name[200] = '\0';
+    const char *checksum = "d41d8cd98f00b204e9800998ecf8427e";
+
+    char *out = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&out, &size);
+
+    baton_error_t error;
+    write_tar_header(stream, "short.txt", 10, 0, NULL, &error);
+    ck_assert_int_eq(error.code, 0);
+    fclose(stream);
+
+    // A short name without a checksum needs no pax header
+    ck_assert_int_eq(size, TAR_BLOCK_SIZE);
+    ck_assert_str_eq(out, "short.txt");
+    ck_assert(memcmp(out + 257, "ustar\0" "00", 8) == 0);
+    ck_assert_int_eq(out[156], '0');
+    ck_assert(strncmp(out + 124, "00000000012", 12) == 0);
+    free(out);
+
+    stream = open_memstream(&out, &size);
+    write_tar_header(stream, name, 10, 0, checksum, &error);
+    ck_assert_int_eq(error.code, 0);
+    fclose(stream);
+
+    // A pax header, its records and the ustar header
+    ck_assert_int_eq(size, 3 * TAR_BLOCK_SIZE);
+    ck_assert_int_eq(out[156], 'x');
+    ck_assert_ptr_ne(strstr(out + TAR_BLOCK_SIZE, "path="), NULL);
+    ck_assert_ptr_ne(strstr(out + TAR_BLOCK_SIZE, TAR_PAX_CHECKSUM_KEY), NULL);
+    ck_assert_int_eq(out[2 * TAR_BLOCK_SIZE + 156], '0');
+
+    // Each record begins with its own length
+    char *record = out + TAR_BLOCK_SIZE;
+    size_t record_len = strtoul(record, NULL, 10);
+    ck_assert_int_eq(record[record_len - 1], '\n');
+    ck_assert_int_eq(record_len, 210);
+    ck_assert(strncmp(record + record_len, "69 " TAR_PAX_CHECKSUM_KEY "=",
+                      36) == 0);
+    free(out);
+}
+END_TEST
+
+// Can we cache local file checksums and invalidate them on change?
+START_TEST(test_checksum_cache) {
+    char cache_template[] = "baton_test_checksum_cache.XXXXXX";
+    char *cache_dir = mkdtemp(cache_template);
+    ck_assert_ptr_ne(cache_dir, NULL);
+
+    char file_template[] = "baton_test_checksum_cache_file.XXXXXX";
+    int fd = mkstemp(file_template);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, "baton", 5), 5);
+    close(fd);
+
+    // Backdate the file so that its checksum is cacheable
+    struct timespec times[2] = { { .tv_sec = 1375107252, .tv_nsec = 1 },
+                                 { .tv_sec = 1375107252, .tv_nsec = 1 } };
+    ck_assert_int_eq(utimensat(AT_FDCWD, file_template, times, 0), 0);
+
+    struct stat st;
+    ck_assert_int_eq(stat(file_template, &st), 0);
+
+    baton_error_t error;
+    // Disabled cache
+    ck_assert_ptr_eq(get_cached_checksum(&st, CHECKSUM_ALGORITHM_MD5,
+                                         &error), NULL);
+    ck_assert_int_eq(error.code, 0);
+
+    ck_assert_ptr_ne(set_checksum_cache_dir(cache_dir), NULL);
+    ck_assert_ptr_eq(get_cached_checksum(&st, CHECKSUM_ALGORITHM_MD5,
+                                         &error), NULL);
+    ck_assert_int_eq(error.code, 0);
+
+    set_cached_checksum(&st, CHECKSUM_ALGORITHM_MD5,
+                        "4fa2d7fe4c4a8b7a6c8b5d3cd2e0b8e6", &error);
+    ck_assert_int_eq(error.code, 0);
+
+    char *checksum = get_cached_checksum(&st, CHECKSUM_ALGORITHM_MD5,
+                                         &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_str_eq(checksum, "4fa2d7fe4c4a8b7a6c8b5d3cd2e0b8e6");
+    free(checksum);
+
+    // Entries are per-algorithm
+    ck_assert_ptr_eq(get_cached_checksum(&st, "sha256", &error), NULL);
+
+    // Entries are invalidated when the file changes
+    times[1].tv_nsec = 2;
+    ck_assert_int_eq(utimensat(AT_FDCWD, file_template, times, 0), 0);
+    ck_assert_int_eq(stat(file_template, &st), 0);
+    ck_assert_ptr_eq(get_cached_checksum(&st, CHECKSUM_ALGORITHM_MD5,
+                                         &error), NULL);
+    ck_assert_int_eq(error.code, 0);
+
+    set_checksum_cache_dir(NULL);
+
+    char command[MAX_COMMAND_LEN];
+    snprintf(command, MAX_COMMAND_LEN, "rm -r %s", cache_dir);
+    ck_assert_int_eq(system(command), 0);
+    unlink(file_template);
+}
+END_TEST
+
+// Are the journals of puts kept apart from the local file?
+START_TEST(test_put_journal_dir) {
+    char state_template[] = "baton_test_put_journal.XXXXXX";
+    char *state_dir = mkdtemp(state_template);
+    ck_assert_ptr_ne(state_dir, NULL);
+
+    char state_home[MAX_PATH_LEN];
+    ck_assert_ptr_ne(getcwd(state_home, MAX_PATH_LEN), NULL);
+    strncat(state_home, "/", MAX_PATH_LEN - strlen(state_home) - 1);
+    strncat(state_home, state_dir, MAX_PATH_LEN - strlen(state_home) - 1);
+
+    char *saved_state_home = getenv("XDG_STATE_HOME");
+    if (saved_state_home) {
+        saved_state_home = copy_str(saved_state_home, MAX_PATH_LEN);
+    }
+    ck_assert_int_eq(setenv("XDG_STATE_HOME", state_home, 1), 0);
+
+    struct stat st;
+    ck_assert_int_eq(stat(state_home, &st), 0);
+
+    // By default, the journal is in a private directory in the user's
+    // state directory, which is created when needed
+    baton_error_t error;
+    transfer_journal_t *journal = open_put_journal(&st, "put 1 2 /a",
+                                                   &error);
+    ck_assert_int_eq(error.code, 0);
+
+    char journal_path[MAX_PATH_LEN];
+    snprintf(journal_path, MAX_PATH_LEN, "%s/baton/%llx-%llx%s", state_home,
+             (unsigned long long) st.st_dev,
+             (unsigned long long) st.st_ino, JOURNAL_SUFFIX);
+    ck_assert_str_eq(journal->path, journal_path);
+
+    journal_chunk(journal, 0, "baton", 5, &error);
+    ck_assert_int_eq(error.code, 0);
+    close_transfer_journal(journal, 0);
+
+    char baton_dir[MAX_PATH_LEN];
+    snprintf(baton_dir, MAX_PATH_LEN, "%s/baton", state_home);
+    struct stat dir_st;
+    ck_assert_int_eq(stat(baton_dir, &dir_st), 0);
+    ck_assert_int_eq(dir_st.st_mode & 0777, S_IRWXU);
+
+    // The same transfer resumes from its journal
+    journal = open_put_journal(&st, "put 1 2 /a", &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_int_eq(journal->num_chunks, 1);
+    close_transfer_journal(journal, 1);
+    ck_assert_int_ne(access(journal_path, F_OK), 0);
+
+    // A journal directory may be set
+    ck_assert_ptr_eq(set_journal_dir("no_such_directory"), NULL);
+    ck_assert_ptr_ne(set_journal_dir(state_home), NULL);
+    journal = open_put_journal(&st, "put 1 2 /a", &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_ptr_ne(strstr(journal->path, state_home), NULL);
+    ck_assert_ptr_eq(strstr(journal->path, "/baton/"), NULL);
+    close_transfer_journal(journal, 1);
+    set_journal_dir(NULL);
+
+    if (saved_state_home) {
+        setenv("XDG_STATE_HOME", saved_state_home, 1);
+        free(saved_state_home);
+    }
+    else {
+        unsetenv("XDG_STATE_HOME");
+    }
+
+    char command[MAX_COMMAND_LEN];
+    snprintf(command, MAX_COMMAND_LEN, "rm -r %s", state_dir);
+    ck_assert_int_eq(system(command), 0);
 }
 END_TEST
 
@@ -525,6 +976,48 @@ START_TEST(test_list_obj) {
 }
 END_TEST
 
+// Can we list several data objects in a collection by name?
+START_TEST(test_list_data_objs_by_name) {
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    json_t *names = json_pack("[s, s, s]", "f1.txt", "f2.txt", "INVALID");
+
+    baton_error_t error;
+    json_t *rows = list_data_objs_by_name(conn, rods_root, names, &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_int_eq(json_array_size(rows), 2);
+
+    for (size_t i = 0; i < json_array_size(rows); i++) {
+        json_t *row = json_array_get(rows, i);
+        ck_assert_str_eq(json_string_value(json_object_get
+                                           (row, JSON_COLLECTION_KEY)),
+                         rods_root);
+        ck_assert_ptr_ne(json_object_get(row, JSON_SIZE_KEY), NULL);
+        ck_assert_str_ne(json_string_value(json_object_get
+                                           (row, JSON_DATA_OBJECT_KEY)),
+                         "INVALID");
+    }
+
+    // Names which cannot be quoted in a query are refused
+    json_t *quoted = json_pack("[s]", "f1'.txt");
+    baton_error_t quoted_error;
+    json_t *none = list_data_objs_by_name(conn, rods_root, quoted,
+                                          &quoted_error);
+    ck_assert_int_eq(quoted_error.code, CAT_INVALID_ARGUMENT);
+    ck_assert_ptr_eq(none, NULL);
+
+    json_decref(names);
+    json_decref(quoted);
+    json_decref(rows);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
 // Can we list a collection?
 START_TEST(test_list_coll) {
     option_flags flags = 0;
@@ -1544,8 +2037,8 @@ START_TEST(test_remove_json_metadata_obj) {
 }
 END_TEST
 
-// Can we change permissions on a data object?
-START_TEST(test_modify_permissions_obj) {
+// Can we remove and add JSON AVUs on a data object in one operation?
+START_TEST(test_apply_json_metadata_obj) {
     option_flags flags = 0;
     rodsEnv env;
     rcComm_t *conn = rods_login(&env);
@@ -1560,43 +2053,58 @@ START_TEST(test_modify_permissions_obj) {
     ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
                                        flags, &resolve_error), EXIST_ST);
 
-    baton_error_t mod_error;
-    int rv = modify_permissions(conn, &rods_path, NO_RECURSE, "public",
-                                ACCESS_LEVEL_READ, &mod_error);
-    ck_assert_int_eq(rv, 0);
-    ck_assert_int_eq(mod_error.code, 0);
+    json_t *old_avus = json_pack("[{s:s, s:s, s:s}]",
+                                 JSON_ATTRIBUTE_KEY, "attr1",
+                                 JSON_VALUE_KEY,     "value1",
+                                 JSON_UNITS_KEY,     "units1");
+    json_t *new_avus = json_pack("[{s:s, s:s, s:s}, {s:s, s:s, s:s}]",
+                                 JSON_ATTRIBUTE_KEY, "attr1",
+                                 JSON_VALUE_KEY,     "value2",
+                                 JSON_UNITS_KEY,     "units1",
+                                 JSON_ATTRIBUTE_KEY, "attr1",
+                                 JSON_VALUE_KEY,     "value3",
+                                 JSON_UNITS_KEY,     "units1");
 
-    json_t *expected = json_pack("{s:s, s:s, s:s}",
-                                 JSON_OWNER_KEY, "public",
-                                 JSON_ZONE_KEY,  env.rodsZone,
-                                 JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+    // One bad AVU; none should be applied
+    json_t *bad_avus = json_pack("[{s:s, s:s}, {s:s}]",
+                                 JSON_ATTRIBUTE_KEY, "attr1",
+                                 JSON_VALUE_KEY,     "value4",
+                                 JSON_ATTRIBUTE_KEY, "attr1");
+    baton_error_t expected_error;
+    int fail_rv = apply_json_metadata(conn, &rods_path, old_avus, bad_avus,
+                                      &expected_error);
+    ck_assert_int_ne(fail_rv, 0);
+    ck_assert_int_ne(expected_error.code, 0);
 
     baton_error_t list_error;
-    json_t *acl = list_permissions(conn, &rods_path, &list_error);
+    json_t *results = list_metadata(conn, &rods_path, "attr1", &list_error);
     ck_assert_int_eq(list_error.code, 0);
+    ck_assert_int_eq(json_equal(results, old_avus), 1);
+    json_decref(results);
 
-    int num_elts = json_array_size(acl);
-    ck_assert_int_ne(num_elts, 0);
-
-    int found = 0;
-    for (int i = 0; i < num_elts; i++) {
-        json_t *elt = json_array_get(acl, i);
+    baton_error_t error;
+    int rv = apply_json_metadata(conn, &rods_path, old_avus, new_avus, &error);
+    ck_assert_int_eq(rv, 0);
+    ck_assert_int_eq(error.code, 0);
 
-        ck_assert(json_is_object(elt));
-        if (json_equal(expected, elt)) found = 1;
+    results = list_metadata(conn, &rods_path, "attr1", &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert_int_eq(json_array_size(results), 2);
+    for (size_t i = 0; i < json_array_size(new_avus); i++) {
+        ck_assert(contains_avu(results, json_array_get(new_avus, i)));
     }
 
-    ck_assert_int_eq(found, 1);
-
-    json_decref(expected);
-    json_decref(acl);
+    json_decref(old_avus);
+    json_decref(new_avus);
+    json_decref(bad_avus);
+    json_decref(results);
 
     if (conn) rcDisconnect(conn);
 }
 END_TEST
 
-// Can we change JSON permissions on a data object?
-START_TEST(test_modify_json_permissions_obj) {
+// Can we supersede the AVUs on a data object with a baton-do operation?
+START_TEST(test_metasuper_op) {
     option_flags flags = 0;
     rodsEnv env;
     rcComm_t *conn = rods_login(&env);
@@ -1606,93 +2114,842 @@ START_TEST(test_modify_json_permissions_obj) {
     char obj_path[MAX_PATH_LEN];
     snprintf(obj_path, MAX_PATH_LEN, "%s/f1.txt", rods_root);
 
+    json_t *avus = json_pack("[{s:s, s:s, s:s}, {s:s, s:s}]",
+                             JSON_ATTRIBUTE_KEY, "attr1",
+                             JSON_VALUE_KEY,     "value1",
+                             JSON_UNITS_KEY,     "units1",
+                             JSON_ATTRIBUTE_KEY, "attr2",
+                             JSON_VALUE_KEY,     "value2");
+    json_t *envelope = json_pack("{s:s, s:{s:s, s:s, s:O}}",
+                                 JSON_OP_KEY,          JSON_METASUPER_OP,
+                                 JSON_TARGET_KEY,
+                                 JSON_COLLECTION_KEY,  rods_root,
+                                 JSON_DATA_OBJECT_KEY, "f1.txt",
+                                 JSON_AVUS_KEY,        avus);
+
+    operation_args_t args = { .flags = flags };
+
+    baton_error_t error;
+    json_t *result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                            &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_ptr_ne(result, NULL);
+
     rodsPath_t rods_path;
     baton_error_t resolve_error;
     ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
                                        flags, &resolve_error), EXIST_ST);
 
-    json_t *bad_perm1 = json_pack("{s:s}", JSON_OWNER_KEY, "public");
-    baton_error_t expected_error1;
-    int fail_rv1 = modify_json_permissions(conn, &rods_path, NO_RECURSE,
-                                           bad_perm1, &expected_error1);
-    ck_assert_int_ne(fail_rv1, 0);
-    ck_assert_int_ne(expected_error1.code, 0);
+    baton_error_t list_error;
+    json_t *current = list_metadata(conn, &rods_path, NULL, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert_int_eq(json_array_size(current), 2);
+    for (size_t i = 0; i < json_array_size(avus); i++) {
+        ck_assert(contains_avu(current, json_array_get(avus, i)));
+    }
 
-    json_t *bad_perm2 = json_pack("{s:s}", JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
-    baton_error_t expected_error2;
-    int fail_rv2 = modify_json_permissions(conn, &rods_path, NO_RECURSE,
-                                           bad_perm2, &expected_error2);
+    json_decref(avus);
+    json_decref(envelope);
+    json_decref(result);
+    json_decref(current);
 
-    ck_assert_int_ne(expected_error2.code, 0);
-    ck_assert_int_ne(fail_rv2, 0);
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
 
-    // Explicit zone
-    json_t *perm_with_zone = json_pack("{s:s, s:s, s:s}",
-                                       JSON_OWNER_KEY, "public",
-                                       JSON_ZONE_KEY,  env.rodsZone,
-                                       JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+// Do operations trusting their targets to exist behave as those which
+// resolve them?
+START_TEST(test_trust_input) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
 
-    baton_error_t error_with_zone;
-    int rv_with_zone =
-        modify_json_permissions(conn, &rods_path, NO_RECURSE,
-                                perm_with_zone, &error_with_zone);
-    ck_assert_int_eq(rv_with_zone, 0);
-    ck_assert_int_eq(error_with_zone.code, 0);
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/f1.txt", rods_root);
 
-    baton_error_t list_error_with_zone;
-    json_t *acl_with_zone =
-        list_permissions(conn, &rods_path, &list_error_with_zone);
-    ck_assert_int_eq(list_error_with_zone.code, 0);
+    json_t *avus = json_pack("[{s:s, s:s}]",
+                             JSON_ATTRIBUTE_KEY, "trusted",
+                             JSON_VALUE_KEY,     "1");
+    json_t *envelope = json_pack("{s:s, s:{s:s, s:b}, s:{s:s, s:s, s:O}}",
+                                 JSON_OP_KEY,          JSON_METAMOD_OP,
+                                 JSON_OP_ARGS_KEY,
+                                 JSON_OP_OPERATION,    JSON_ARG_META_ADD,
+                                 JSON_OP_TRUST,        1,
+                                 JSON_TARGET_KEY,
+                                 JSON_COLLECTION_KEY,  rods_root,
+                                 JSON_DATA_OBJECT_KEY, "f1.txt",
+                                 JSON_AVUS_KEY,        avus);
+
+    operation_args_t args = { .flags = flags };
 
-    int num_elts = json_array_size(acl_with_zone);
-    ck_assert_int_ne(num_elts, 0);
+    baton_error_t error;
+    json_t *result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                            &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_ptr_ne(result, NULL);
 
-    int found = 0;
-    for (int i = 0; i < num_elts; i++) {
-        json_t *elt = json_array_get(acl_with_zone, i);
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
 
-        // Return value should equal the input
-        ck_assert(json_is_object(elt));
-        if (json_equal(perm_with_zone, elt)) found = 1;
-    }
+    baton_error_t list_error;
+    json_t *current = list_metadata(conn, &rods_path, NULL, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert(contains_avu(current, json_array_get(avus, 0)));
 
-    ck_assert_int_eq(found, 1);
+    // A missing target is reported with the same error code, whether or
+    // not it is trusted
+    const char *ops[] = { JSON_METAMOD_OP, JSON_CHECKSUM_OP };
+    json_t *target = json_object_get(envelope, JSON_TARGET_KEY);
+    json_object_set_new(target, JSON_DATA_OBJECT_KEY,
+                        json_string("INVALID"));
 
-    json_t *perm_without_zone = json_pack("{s:s, s:s}",
-                                          JSON_OWNER_KEY, "public",
-                                          JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+    for (size_t i = 0; i < 2; i++) {
+        json_object_set_new(envelope, JSON_OP_KEY, json_string(ops[i]));
 
-    // Implicit zone should not raise an error
-    baton_error_t error_without_zone;
-    int rv_without_zone =
-        modify_json_permissions(conn, &rods_path, NO_RECURSE,
-                                perm_without_zone, &error_without_zone);
-    ck_assert_int_eq(rv_without_zone, 0);
-    ck_assert_int_eq(error_without_zone.code, 0);
+        json_t *op_args = json_object_get(envelope, JSON_OP_ARGS_KEY);
+        json_object_set_new(op_args, JSON_OP_TRUST, json_true());
 
-    baton_error_t list_error_without_zone;
-    json_t *acl_without_zone =
-        list_permissions(conn, &rods_path, &list_error_without_zone);
-    ck_assert_int_eq(list_error_without_zone.code, 0);
-    // Zone should be populated in returned ACL
-    ck_assert_int_eq(json_equal(acl_without_zone, acl_with_zone), 1);
+        baton_error_t trusted_error;
+        baton_json_dispatch_op(&env, conn, envelope, &args, &trusted_error);
 
-    json_decref(bad_perm1);
-    json_decref(bad_perm2);
-    json_decref(perm_with_zone);
-    json_decref(perm_without_zone);
-    json_decref(acl_with_zone);
-    json_decref(acl_without_zone);
+        json_object_set_new(op_args, JSON_OP_TRUST, json_false());
+
+        baton_error_t resolved_error;
+        baton_json_dispatch_op(&env, conn, envelope, &args, &resolved_error);
+
+        ck_assert_int_ne(resolved_error.code, 0);
+        ck_assert_int_eq(trusted_error.code, resolved_error.code);
+    }
+
+    json_decref(avus);
+    json_decref(envelope);
+    json_decref(result);
+    json_decref(current);
 
     if (conn) rcDisconnect(conn);
 }
 END_TEST
 
-// Can we convert JSON representation to a useful path string?
-START_TEST(test_json_to_path) {
-    const char *coll_path = "/a/b/c";
-    json_t *coll1 = json_pack("{s:s}", JSON_COLLECTION_KEY, coll_path);
-    baton_error_t error_coll1;
+// Can we run several operations on one target in sequence?
+START_TEST(test_sequence_op) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    json_t *avus = json_pack("[{s:s, s:s}]",
+                             JSON_ATTRIBUTE_KEY, "attr1",
+                             JSON_VALUE_KEY,     "value1");
+    json_t *steps = json_pack("[{s:s, s:{s:s}}, {s:s, s:{s:b}}]",
+                              JSON_OP_KEY,      JSON_METAMOD_OP,
+                              JSON_OP_ARGS_KEY,
+                              JSON_OP_OPERATION, JSON_ARG_META_ADD,
+                              JSON_OP_KEY,      JSON_LIST_OP,
+                              JSON_OP_ARGS_KEY,
+                              JSON_OP_AVU,      1);
+    json_t *envelope = json_pack("{s:s, s:{s:O}, s:{s:s, s:s, s:O}}",
+                                 JSON_OP_KEY,          JSON_SEQUENCE_OP,
+                                 JSON_OP_ARGS_KEY,
+                                 JSON_OP_STEPS,        steps,
+                                 JSON_TARGET_KEY,
+                                 JSON_COLLECTION_KEY,  rods_root,
+                                 JSON_DATA_OBJECT_KEY, "f1.txt",
+                                 JSON_AVUS_KEY,        avus);
+
+    operation_args_t args = { .flags = flags };
+
+    baton_error_t error;
+    json_t *result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                            &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_ptr_ne(result, NULL);
+
+    // The result of the listing step includes the AVU added by the
+    // first step
+    json_t *listed = json_object_get(result, JSON_AVUS_KEY);
+    ck_assert(json_is_array(listed));
+    ck_assert(contains_avu(listed, json_array_get(avus, 0)));
+
+    // A sequence stops at the first failed step
+    json_t *bad_steps = json_pack("[{s:s, s:{s:s}}, {s:s, s:{s:s}}]",
+                                  JSON_OP_KEY,      JSON_METAMOD_OP,
+                                  JSON_OP_ARGS_KEY,
+                                  JSON_OP_OPERATION, JSON_ARG_META_REM,
+                                  JSON_OP_KEY,      JSON_METAMOD_OP,
+                                  JSON_OP_ARGS_KEY,
+                                  JSON_OP_OPERATION, "invalid");
+    json_object_set(get_operation_args(envelope, &error), JSON_OP_STEPS,
+                    bad_steps);
+
+    baton_error_t bad_error;
+    json_t *bad_result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                                &bad_error);
+    ck_assert_int_ne(bad_error.code, 0);
+    ck_assert_ptr_eq(bad_result, NULL);
+    ck_assert_ptr_ne(strstr(bad_error.message, "step 1 'metamod'"), NULL);
+
+    // The path of a data object put by the first step is not resolved
+    // again by the later steps
+    char data_dir[MAX_PATH_LEN];
+    snprintf(data_dir, MAX_PATH_LEN, "%s/%s", TEST_ROOT, TEST_DATA_PATH);
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/test_sequence_put.txt", rods_root);
+
+    json_t *put_steps = json_pack("[{s:s}, {s:s}, {s:s, s:{s:s}}]",
+                                  JSON_OP_KEY,      JSON_PUT_OP,
+                                  JSON_OP_KEY,      JSON_CHECKSUM_OP,
+                                  JSON_OP_KEY,      JSON_METAMOD_OP,
+                                  JSON_OP_ARGS_KEY,
+                                  JSON_OP_OPERATION, JSON_ARG_META_ADD);
+    json_t *put_envelope =
+        json_pack("{s:s, s:{s:O}, s:{s:s, s:s, s:s, s:s, s:O}}",
+                  JSON_OP_KEY,          JSON_SEQUENCE_OP,
+                  JSON_OP_ARGS_KEY,
+                  JSON_OP_STEPS,        put_steps,
+                  JSON_TARGET_KEY,
+                  JSON_COLLECTION_KEY,  rods_root,
+                  JSON_DATA_OBJECT_KEY, "test_sequence_put.txt",
+                  JSON_DIRECTORY_KEY,   data_dir,
+                  JSON_FILE_KEY,        "lorem_10k.txt",
+                  JSON_AVUS_KEY,        avus);
+
+    rodsPath_t resolved;
+    memset(&resolved, 0, sizeof (rodsPath_t));
+    operation_args_t put_args = { .flags         = flags,
+                                  .buffer_size   = 1024,
+                                  .resolved_path = &resolved };
+
+    baton_error_t put_error;
+    json_t *put_result = baton_json_dispatch_op(&env, conn, put_envelope,
+                                                &put_args, &put_error);
+    ck_assert_int_eq(put_error.code, 0);
+    ck_assert_ptr_ne(json_object_get(put_result, JSON_CHECKSUM_KEY), NULL);
+
+    // The put left the path resolved without a stat; resolving it
+    // again, in either later step, would have recorded one
+    ck_assert_str_eq(resolved.inPath, obj_path);
+    ck_assert_int_eq(resolved.objState, EXIST_ST);
+    ck_assert_int_eq(resolved.objType, DATA_OBJ_T);
+    ck_assert_ptr_eq(resolved.rodsObjStat, NULL);
+
+    rodsPath_t put_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &put_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    baton_error_t list_error;
+    json_t *put_avus = list_metadata(conn, &put_path, NULL, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert(contains_avu(put_avus, json_array_get(avus, 0)));
+
+    json_decref(put_avus);
+    if (put_path.rodsObjStat) free(put_path.rodsObjStat);
+
+    json_decref(avus);
+    json_decref(steps);
+    json_decref(bad_steps);
+    json_decref(put_steps);
+    json_decref(envelope);
+    json_decref(put_envelope);
+    json_decref(result);
+    json_decref(put_result);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we run one operation on many targets from one envelope?
+START_TEST(test_batch_envelope) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    json_t *avus = json_pack("[{s:s, s:s}]",
+                             JSON_ATTRIBUTE_KEY, "batch",
+                             JSON_VALUE_KEY,     "1");
+    json_t *envelope =
+        json_pack("{s:s, s:{s:s}, s:[{s:s, s:s, s:O}, {s:s, s:s, s:O}]}",
+                  JSON_OP_KEY,          JSON_METAMOD_OP,
+                  JSON_OP_ARGS_KEY,
+                  JSON_OP_OPERATION,    JSON_ARG_META_ADD,
+                  JSON_TARGETS_KEY,
+                  JSON_COLLECTION_KEY,  rods_root,
+                  JSON_DATA_OBJECT_KEY, "f1.txt",
+                  JSON_AVUS_KEY,        avus,
+                  JSON_COLLECTION_KEY,  rods_root,
+                  JSON_DATA_OBJECT_KEY, "f2.txt",
+                  JSON_AVUS_KEY,        avus);
+
+    operation_args_t args = { .flags = flags };
+
+    baton_error_t error;
+    json_t *result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                            &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_ptr_eq(result, NULL);
+    ck_assert_int_eq(args.output_done, 1);
+
+    const char *names[] = { "f1.txt", "f2.txt" };
+    for (size_t i = 0; i < 2; i++) {
+        char obj_path[MAX_PATH_LEN];
+        snprintf(obj_path, MAX_PATH_LEN, "%s/%s", rods_root, names[i]);
+
+        rodsPath_t rods_path;
+        baton_error_t resolve_error;
+        ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                           flags, &resolve_error), EXIST_ST);
+
+        baton_error_t list_error;
+        json_t *current = list_metadata(conn, &rods_path, NULL, &list_error);
+        ck_assert_int_eq(list_error.code, 0);
+        ck_assert(contains_avu(current, json_array_get(avus, 0)));
+
+        json_decref(current);
+        if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+    }
+
+    // A missing target fails without stopping the others; a fresh AVU
+    // shows that the remaining target was modified on this pass
+    json_t *fresh_avus = json_pack("[{s:s, s:s}]",
+                                   JSON_ATTRIBUTE_KEY, "batch",
+                                   JSON_VALUE_KEY,     "2");
+    json_t *targets = json_object_get(envelope, JSON_TARGETS_KEY);
+    json_object_set_new(json_array_get(targets, 0), JSON_DATA_OBJECT_KEY,
+                        json_string("no_such_object.txt"));
+    json_object_set(json_array_get(targets, 0), JSON_AVUS_KEY, fresh_avus);
+    json_object_set(json_array_get(targets, 1), JSON_AVUS_KEY, fresh_avus);
+
+    baton_error_t batch_error;
+    json_t *batch_result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                                  &batch_error);
+    ck_assert_int_ne(batch_error.code, 0);
+    ck_assert_ptr_eq(batch_result, NULL);
+
+    char f2_path[MAX_PATH_LEN];
+    snprintf(f2_path, MAX_PATH_LEN, "%s/%s", rods_root, "f2.txt");
+
+    rodsPath_t f2_rods_path;
+    baton_error_t f2_resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &f2_rods_path, f2_path,
+                                       flags, &f2_resolve_error), EXIST_ST);
+
+    baton_error_t f2_list_error;
+    json_t *f2_current = list_metadata(conn, &f2_rods_path, NULL,
+                                       &f2_list_error);
+    ck_assert_int_eq(f2_list_error.code, 0);
+    ck_assert(contains_avu(f2_current, json_array_get(fresh_avus, 0)));
+
+    json_decref(f2_current);
+    if (f2_rods_path.rodsObjStat) free(f2_rods_path.rodsObjStat);
+
+    // Either a target or many targets may be given, but not both
+    json_object_set_new(envelope, JSON_TARGET_KEY,
+                        json_deep_copy(json_array_get(targets, 1)));
+
+    baton_error_t both_error;
+    baton_json_dispatch_op(&env, conn, envelope, &args, &both_error);
+    ck_assert_int_eq(both_error.code, CAT_INVALID_ARGUMENT);
+
+    json_decref(fresh_avus);
+    json_decref(avus);
+    json_decref(envelope);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Are arguments rejected by operations to which they do not apply?
+START_TEST(test_op_arg_scope) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    json_t *avus = json_pack("[{s:s, s:s}]",
+                             JSON_ATTRIBUTE_KEY, "scope",
+                             JSON_VALUE_KEY,     "1");
+    json_t *envelope = json_pack("{s:s, s:{s:s, s:i}, s:{s:s, s:s, s:O}}",
+                                 JSON_OP_KEY,          JSON_METAMOD_OP,
+                                 JSON_OP_ARGS_KEY,
+                                 JSON_OP_OPERATION,    JSON_ARG_META_ADD,
+                                 JSON_OP_RESUME_FROM,  10,
+                                 JSON_TARGET_KEY,
+                                 JSON_COLLECTION_KEY,  rods_root,
+                                 JSON_DATA_OBJECT_KEY, "f1.txt",
+                                 JSON_AVUS_KEY,        avus);
+
+    operation_args_t args = { .flags = flags };
+
+    // Only chmod may resume
+    baton_error_t resume_error;
+    json_t *result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                            &resume_error);
+    ck_assert_int_eq(resume_error.code, USER_INPUT_OPTION_ERR);
+    ck_assert_ptr_eq(result, NULL);
+
+    // Only get may read a byte range
+    json_t *op_args = json_object_get(envelope, JSON_OP_ARGS_KEY);
+    json_object_del(op_args, JSON_OP_RESUME_FROM);
+    json_object_set_new(op_args, JSON_OP_LENGTH, json_integer(10));
+
+    baton_error_t range_error;
+    result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                    &range_error);
+    ck_assert_int_eq(range_error.code, USER_INPUT_OPTION_ERR);
+    ck_assert_ptr_eq(result, NULL);
+
+    json_decref(avus);
+    json_decref(envelope);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we add the same AVUs to many data objects at once?
+START_TEST(test_bulk_modify_metadata) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    json_t *avus = json_pack("[{s:s, s:s}]",
+                             JSON_ATTRIBUTE_KEY, "release",
+                             JSON_VALUE_KEY,     "1");
+    json_t *targets = json_pack("[{s:s, s:s}, {s:s, s:s}, {s:s, s:s}]",
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "f1.txt",
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "f2.txt",
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "f3.txt");
+
+    FILE *out = tmpfile();
+    baton_error_t error;
+    json_t *result = bulk_modify_metadata(&env, conn, targets, avus,
+                                          META_ADD, flags, 0, out, 2, &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_int_eq(json_integer_value(json_object_get(result,
+                                                        JSON_COUNT_KEY)), 3);
+
+    for (size_t i = 0; i < json_array_size(targets); i++) {
+        baton_error_t path_error;
+        char *obj_path = json_to_path(json_array_get(targets, i), &path_error);
+        ck_assert_int_eq(path_error.code, 0);
+
+        rodsPath_t rods_path;
+        baton_error_t resolve_error;
+        ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                           flags, &resolve_error), EXIST_ST);
+
+        baton_error_t list_error;
+        json_t *current = list_metadata(conn, &rods_path, "release",
+                                        &list_error);
+        ck_assert_int_eq(list_error.code, 0);
+        ck_assert_int_eq(json_equal(current, avus), 1);
+
+        json_decref(current);
+        free(obj_path);
+    }
+
+    // A missing data object is reported, without stopping the others,
+    // with the same error whether it is resolved or trusted to exist
+    json_t *missing = json_pack("[{s:s, s:s}, {s:s, s:s}]",
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "INVALID",
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "f1.txt");
+    for (int trust = 0; trust < 2; trust++) {
+        FILE *fail_out = tmpfile();
+        baton_error_t expected_error;
+        json_t *fail_result = bulk_modify_metadata(&env, conn, missing, avus,
+                                                   META_REM, flags, trust,
+                                                   fail_out, 1,
+                                                   &expected_error);
+        ck_assert_ptr_eq(fail_result, NULL);
+        ck_assert_int_ne(expected_error.code, 0);
+
+        // The single worker reports the targets in order
+        rewind(fail_out);
+        json_t *record = json_loadf(fail_out, JSON_DISABLE_EOF_CHECK, NULL);
+        json_t *record_error = json_object_get(record, JSON_ERROR_KEY);
+        ck_assert_int_eq(json_integer_value(json_object_get(record_error,
+                                                    JSON_ERROR_CODE_KEY)),
+                         USER_FILE_DOES_NOT_EXIST);
+
+        json_decref(record);
+        fclose(fail_out);
+    }
+
+    fclose(out);
+    json_decref(avus);
+    json_decref(targets);
+    json_decref(missing);
+    json_decref(result);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we change permissions on a data object?
+START_TEST(test_modify_permissions_obj) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/f1.txt", rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    baton_error_t mod_error;
+    int rv = modify_permissions(conn, &rods_path, NO_RECURSE, "public",
+                                ACCESS_LEVEL_READ, &mod_error);
+    ck_assert_int_eq(rv, 0);
+    ck_assert_int_eq(mod_error.code, 0);
+
+    json_t *expected = json_pack("{s:s, s:s, s:s}",
+                                 JSON_OWNER_KEY, "public",
+                                 JSON_ZONE_KEY,  env.rodsZone,
+                                 JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+
+    baton_error_t list_error;
+    json_t *acl = list_permissions(conn, &rods_path, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+
+    int num_elts = json_array_size(acl);
+    ck_assert_int_ne(num_elts, 0);
+
+    int found = 0;
+    for (int i = 0; i < num_elts; i++) {
+        json_t *elt = json_array_get(acl, i);
+
+        ck_assert(json_is_object(elt));
+        if (json_equal(expected, elt)) found = 1;
+    }
+
+    ck_assert_int_eq(found, 1);
+
+    json_decref(expected);
+    json_decref(acl);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we change JSON permissions on a data object?
+START_TEST(test_modify_json_permissions_obj) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/f1.txt", rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    json_t *bad_perm1 = json_pack("{s:s}", JSON_OWNER_KEY, "public");
+    baton_error_t expected_error1;
+    int fail_rv1 = modify_json_permissions(conn, &rods_path, NO_RECURSE,
+                                           bad_perm1, &expected_error1);
+    ck_assert_int_ne(fail_rv1, 0);
+    ck_assert_int_ne(expected_error1.code, 0);
+
+    json_t *bad_perm2 = json_pack("{s:s}", JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+    baton_error_t expected_error2;
+    int fail_rv2 = modify_json_permissions(conn, &rods_path, NO_RECURSE,
+                                           bad_perm2, &expected_error2);
+
+    ck_assert_int_ne(expected_error2.code, 0);
+    ck_assert_int_ne(fail_rv2, 0);
+
+    // Explicit zone
+    json_t *perm_with_zone = json_pack("{s:s, s:s, s:s}",
+                                       JSON_OWNER_KEY, "public",
+                                       JSON_ZONE_KEY,  env.rodsZone,
+                                       JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+
+    baton_error_t error_with_zone;
+    int rv_with_zone =
+        modify_json_permissions(conn, &rods_path, NO_RECURSE,
+                                perm_with_zone, &error_with_zone);
+    ck_assert_int_eq(rv_with_zone, 0);
+    ck_assert_int_eq(error_with_zone.code, 0);
+
+    baton_error_t list_error_with_zone;
+    json_t *acl_with_zone =
+        list_permissions(conn, &rods_path, &list_error_with_zone);
+    ck_assert_int_eq(list_error_with_zone.code, 0);
+
+    int num_elts = json_array_size(acl_with_zone);
+    ck_assert_int_ne(num_elts, 0);
+
+    int found = 0;
+    for (int i = 0; i < num_elts; i++) {
+        json_t *elt = json_array_get(acl_with_zone, i);
+
+        // Return value should equal the input
+        ck_assert(json_is_object(elt));
+        if (json_equal(perm_with_zone, elt)) found = 1;
+    }
+
+    ck_assert_int_eq(found, 1);
+
+    json_t *perm_without_zone = json_pack("{s:s, s:s}",
+                                          JSON_OWNER_KEY, "public",
+                                          JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+
+    // Implicit zone should not raise an error
+    baton_error_t error_without_zone;
+    int rv_without_zone =
+        modify_json_permissions(conn, &rods_path, NO_RECURSE,
+                                perm_without_zone, &error_without_zone);
+    ck_assert_int_eq(rv_without_zone, 0);
+    ck_assert_int_eq(error_without_zone.code, 0);
+
+    baton_error_t list_error_without_zone;
+    json_t *acl_without_zone =
+        list_permissions(conn, &rods_path, &list_error_without_zone);
+    ck_assert_int_eq(list_error_without_zone.code, 0);
+    // Zone should be populated in returned ACL
+    ck_assert_int_eq(json_equal(acl_without_zone, acl_with_zone), 1);
+
+    json_decref(bad_perm1);
+    json_decref(bad_perm2);
+    json_decref(perm_with_zone);
+    json_decref(perm_without_zone);
+    json_decref(acl_with_zone);
+    json_decref(acl_without_zone);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we apply an array of JSON permissions to a data object at once?
+START_TEST(test_apply_json_permissions_obj) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/f1.txt", rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    json_t *perm = json_pack("{s:s, s:s, s:s}",
+                             JSON_OWNER_KEY, "public",
+                             JSON_ZONE_KEY,  env.rodsZone,
+                             JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+    json_t *own = json_pack("{s:s, s:s, s:s}",
+                            JSON_OWNER_KEY, env.rodsUserName,
+                            JSON_ZONE_KEY,  env.rodsZone,
+                            JSON_LEVEL_KEY, ACCESS_LEVEL_OWN);
+
+    // One bad permission; none should be applied
+    json_t *bad_perms = json_pack("[O, {s:s, s:s}]", perm,
+                                  JSON_OWNER_KEY, "public",
+                                  JSON_LEVEL_KEY, "INVALID");
+    baton_error_t expected_error;
+    int fail_rv = apply_json_permissions(conn, &rods_path, NO_RECURSE,
+                                         bad_perms, &expected_error);
+    ck_assert_int_ne(fail_rv, 0);
+    ck_assert_int_ne(expected_error.code, 0);
+
+    baton_error_t list_error;
+    json_t *acl = list_permissions(conn, &rods_path, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert(!contains_json(acl, perm));
+    json_decref(acl);
+
+    json_t *perms = json_pack("[O, O]", perm, own);
+    baton_error_t error;
+    int rv = apply_json_permissions(conn, &rods_path, NO_RECURSE, perms,
+                                    &error);
+    ck_assert_int_eq(rv, 0);
+    ck_assert_int_eq(error.code, 0);
+
+    acl = list_permissions(conn, &rods_path, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert(contains_json(acl, perm));
+    ck_assert(contains_json(acl, own));
+
+    json_decref(perm);
+    json_decref(own);
+    json_decref(bad_perms);
+    json_decref(perms);
+    json_decref(acl);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we apply the same permissions to many data objects at once?
+START_TEST(test_bulk_modify_permissions) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    json_t *perm = json_pack("{s:s, s:s, s:s}",
+                             JSON_OWNER_KEY, "public",
+                             JSON_ZONE_KEY,  env.rodsZone,
+                             JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+    json_t *perms = json_pack("[O]", perm);
+    json_t *targets = json_pack("[{s:s, s:s}, {s:s, s:s}]",
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "f1.txt",
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "f2.txt");
+
+    FILE *out = tmpfile();
+    baton_error_t error;
+    json_t *result = bulk_modify_permissions(&env, conn, targets, perms,
+                                             NO_RECURSE, flags, 0, out, 2,
+                                             &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_int_eq(json_integer_value(json_object_get(result,
+                                                        JSON_COUNT_KEY)), 2);
+
+    for (size_t i = 0; i < json_array_size(targets); i++) {
+        baton_error_t path_error;
+        char *obj_path = json_to_path(json_array_get(targets, i), &path_error);
+        ck_assert_int_eq(path_error.code, 0);
+
+        rodsPath_t rods_path;
+        baton_error_t resolve_error;
+        ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                           flags, &resolve_error), EXIST_ST);
+
+        baton_error_t list_error;
+        json_t *acl = list_permissions(conn, &rods_path, &list_error);
+        ck_assert_int_eq(list_error.code, 0);
+        ck_assert(contains_json(acl, perm));
+
+        json_decref(acl);
+        free(obj_path);
+    }
+
+    fclose(out);
+    json_decref(perm);
+    json_decref(perms);
+    json_decref(targets);
+    json_decref(result);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we modify permissions recursively from the client and resume?
+START_TEST(test_chmod_collection) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+    char coll_path[MAX_PATH_LEN];
+    snprintf(coll_path, MAX_PATH_LEN, "%s/a", rods_root);
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/a/x/m/f10.txt", rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, coll_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    json_t *perm = json_pack("{s:s, s:s, s:s}",
+                             JSON_OWNER_KEY, "public",
+                             JSON_ZONE_KEY,  env.rodsZone,
+                             JSON_LEVEL_KEY, ACCESS_LEVEL_READ);
+    json_t *perms = json_pack("[O]", perm);
+
+    FILE *out = tmpfile();
+    baton_error_t error;
+    json_t *result = chmod_collection(conn, &rods_path, perms, out, 0, 2,
+                                      &error);
+    ck_assert_int_eq(error.code, 0);
+
+    // a, x, y, z, x/m, x/n and x/o; f4-f12 and four .gitignore files
+    json_int_t total = 20;
+    ck_assert_int_eq(json_integer_value(json_object_get(result,
+                                                        JSON_COUNT_KEY)),
+                     total);
+
+    // The last progress record shows all the paths done
+    rewind(out);
+    json_t *last = NULL;
+    json_t *record;
+    while ((record = json_loadf(out, JSON_DISABLE_EOF_CHECK, NULL))) {
+        if (last) json_decref(last);
+        last = record;
+    }
+    json_t *progress = json_object_get(last, JSON_PROGRESS_KEY);
+    ck_assert_int_eq(json_integer_value(json_object_get(progress,
+                                                        JSON_COMPLETED_KEY)),
+                     total);
+
+    rodsPath_t obj_rods_path;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &obj_rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+    baton_error_t list_error;
+    json_t *acl = list_permissions(conn, &obj_rods_path, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert(contains_json(acl, perm));
+
+    // Resuming after the last path does nothing
+    baton_error_t resume_error;
+    json_t *resume_result = chmod_collection(conn, &rods_path, perms, out,
+                                             total, 2, &resume_error);
+    ck_assert_int_eq(resume_error.code, 0);
+    ck_assert_int_eq(json_integer_value(json_object_get(resume_result,
+                                                        JSON_COUNT_KEY)), 0);
+
+    fclose(out);
+    json_decref(perm);
+    json_decref(perms);
+    json_decref(result);
+    json_decref(resume_result);
+    json_decref(last);
+    json_decref(acl);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we convert JSON representation to a useful path string?
+START_TEST(test_json_to_path) {
+    const char *coll_path = "/a/b/c";
+    json_t *coll1 = json_pack("{s:s}", JSON_COLLECTION_KEY, coll_path);
+    baton_error_t error_coll1;
     ck_assert_str_eq(json_to_path(coll1, &error_coll1), coll_path);
     ck_assert_int_eq(error_coll1.code, 0);
     json_decref(coll1);
@@ -1797,6 +3054,63 @@ START_TEST(test_contains_avu) {
 }
 END_TEST
 
+// Can we find the AVUs not among some reference AVUs?
+START_TEST(test_avu_set_difference) {
+    json_t *avu1 = json_pack("{s:s, s:s}",
+                             JSON_ATTRIBUTE_KEY, "foo",
+                             JSON_VALUE_KEY,     "bar");
+    json_t *avu2 = json_pack("{s:s, s:s, s:s}",
+                             JSON_ATTRIBUTE_KEY, "baz",
+                             JSON_VALUE_KEY,     "qux",
+                             JSON_UNITS_KEY,     "");
+    json_t *avu3 = json_pack("{s:s, s:s, s:s}",
+                             JSON_ATTRIBUTE_KEY, "baz",
+                             JSON_VALUE_KEY,     "qux",
+                             JSON_UNITS_KEY,     "zab");
+    // Differs from avu1 only in where the attribute ends
+    json_t *avu4 = json_pack("{s:s, s:s}",
+                             JSON_ATTRIBUTE_KEY, "foob",
+                             JSON_VALUE_KEY,     "ar");
+    // The same as avu2, as empty units are the same as none
+    json_t *avu5 = json_pack("{s:s, s:s}",
+                             JSON_ATTRIBUTE_KEY, "baz",
+                             JSON_VALUE_KEY,     "qux");
+
+    json_t *avus      = json_pack("[O, O, O, O, O]", avu1, avu2, avu3, avu4,
+                                  avu3);
+    json_t *reference = json_pack("[O, O]", avu1, avu5);
+    json_t *expected  = json_pack("[O, O]", avu3, avu4);
+
+    baton_error_t error;
+    json_t *difference = avu_set_difference(avus, reference, &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_int_eq(json_equal(difference, expected), 1);
+    json_decref(difference);
+
+    difference = avu_set_difference(reference, avus, &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_int_eq(json_array_size(difference), 0);
+    json_decref(difference);
+
+    // Bad AVU with no value
+    json_t *bad_avus = json_pack("[{s:s}]", JSON_ATTRIBUTE_KEY, "foo");
+    baton_error_t expected_error;
+    ck_assert_ptr_eq(avu_set_difference(bad_avus, reference,
+                                        &expected_error), NULL);
+    ck_assert_int_ne(expected_error.code, 0);
+
+    json_decref(avu1);
+    json_decref(avu2);
+    json_decref(avu3);
+    json_decref(avu4);
+    json_decref(avu5);
+    json_decref(avus);
+    json_decref(reference);
+    json_decref(expected);
+    json_decref(bad_avus);
+}
+END_TEST
+
 // Can we test for JSON representation of a collection?
 START_TEST(test_represents_coll) {
     json_t *col = json_pack("{s:s}", JSON_COLLECTION_KEY, "foo");
@@ -1970,6 +3284,80 @@ START_TEST(test_ingest_data_obj) {
 }
 END_TEST
 
+// Can we stream a data object into JSON?
+START_TEST(test_get_data_obj_json_stream) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/lorem_10k.txt", rods_root);
+
+    rodsPath_t rods_obj_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_obj_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    baton_error_t ingest_error;
+    json_t *obj = ingest_data_obj(conn, &rods_obj_path, flags, 1024,
+                                  &ingest_error);
+    ck_assert_int_eq(ingest_error.code, 0);
+    char *expected = json_dumps(json_object_get(obj, JSON_DATA_KEY),
+                                JSON_ENCODE_ANY);
+
+    // Test buffer sizes both smaller and larger than the data
+    size_t buffer_sizes[4] = { 1, 3, 1024, 16384 };
+    for (int i = 0; i < 4; i++) {
+        char *out = NULL;
+        size_t size = 0;
+        FILE *stream = open_memstream(&out, &size);
+
+        fputc('"', stream);
+        baton_error_t stream_error;
+        get_data_obj_json_stream(conn, &rods_obj_path, stream, 0,
+                                 buffer_sizes[i], &stream_error);
+        ck_assert_int_eq(stream_error.code, 0);
+        fputc('"', stream);
+        fclose(stream);
+
+        ck_assert_str_eq(out, expected);
+        free(out);
+    }
+
+    // The base64 encoding decodes to the same content
+    baton_error_t base64_error;
+    json_t *base64_obj = ingest_data_obj(conn, &rods_obj_path,
+                                         flags | BASE64_ENCODING, 1000,
+                                         &base64_error);
+    ck_assert_int_eq(base64_error.code, 0);
+    ck_assert_str_eq(json_string_value(json_object_get(base64_obj,
+                                                       JSON_ENCODING_KEY)),
+                     JSON_ENCODING_BASE64);
+
+    json_t *plain = json_object_get(obj, JSON_DATA_KEY);
+    json_t *base64 = json_object_get(base64_obj, JSON_DATA_KEY);
+    size_t base64_len = json_string_length(base64);
+    char *decoded = calloc(BASE64_DECODED_MAX_LEN(base64_len) + 1,
+                           sizeof (char));
+    int valid;
+    size_t decoded_len = base64_decode(json_string_value(base64), base64_len,
+                                       decoded, &valid);
+    ck_assert(valid);
+    ck_assert_int_eq(decoded_len, json_string_length(plain));
+    ck_assert(memcmp(decoded, json_string_value(plain), decoded_len) == 0);
+
+    free(decoded);
+    json_decref(base64_obj);
+    free(expected);
+    json_decref(obj);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
 START_TEST(test_get_data_obj_file) {
     option_flags flags = 0;
     rodsEnv env;
@@ -2007,6 +3395,481 @@ START_TEST(test_get_data_obj_file) {
 }
 END_TEST
 
+// Can we get a byte range of a data object?
+START_TEST(test_get_data_obj_range) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char file_path[MAX_PATH_LEN];
+    snprintf(file_path, MAX_PATH_LEN, "%s/%s/lorem_10k.txt",
+             TEST_ROOT, TEST_DATA_PATH);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/lorem_10k.txt", rods_root);
+
+    rodsPath_t rods_obj_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_obj_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    char expected[101];
+    memset(expected, 0, sizeof expected);
+    FILE *in = fopen(file_path, "r");
+    ck_assert_int_eq(fseek(in, 5000, SEEK_SET), 0);
+    ck_assert_int_eq(fread(expected, 1, 100, in), 100);
+    fclose(in);
+
+    // Test buffer sizes both smaller and larger than the range
+    size_t buffer_sizes[3] = { 7, 100, 1024 };
+
+    for (int i = 0; i < 3; i++) {
+        char *content = NULL;
+        size_t size   = 0;
+        FILE *out = open_memstream(&content, &size);
+
+        baton_error_t range_error;
+        get_data_obj_range_stream(conn, &rods_obj_path, out, 5000, 100,
+                                  buffer_sizes[i], &range_error);
+        ck_assert_int_eq(range_error.code, 0);
+        fclose(out);
+
+        ck_assert_int_eq(size, 100);
+        ck_assert_str_eq(content, expected);
+        free(content);
+    }
+
+    // A range extending beyond the end is truncated
+    char *tail = NULL;
+    size_t tail_size = 0;
+    FILE *tail_out = open_memstream(&tail, &tail_size);
+
+    baton_error_t tail_error;
+    get_data_obj_range_stream(conn, &rods_obj_path, tail_out, 10200, 1000,
+                              1024, &tail_error);
+    ck_assert_int_eq(tail_error.code, 0);
+    fclose(tail_out);
+    ck_assert_int_eq(tail_size, 40);
+    free(tail);
+
+    baton_error_t ingest_error;
+    json_t *result = ingest_data_obj_range(conn, &rods_obj_path, flags,
+                                           5000, 100, 1024, &ingest_error);
+    ck_assert_int_eq(ingest_error.code, 0);
+    ck_assert_str_eq(json_string_value(json_object_get(result,
+                                                       JSON_DATA_KEY)),
+                     expected);
+    json_decref(result);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we write several data objects to one stream as frames?
+START_TEST(test_get_data_obj_framed_stream) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char file_path[MAX_PATH_LEN];
+    snprintf(file_path, MAX_PATH_LEN, "%s/%s/lorem_10k.txt",
+             TEST_ROOT, TEST_DATA_PATH);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/lorem_10k.txt", rods_root);
+
+    rodsPath_t rods_obj_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_obj_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    char expected[10240];
+    FILE *in = fopen(file_path, "r");
+    ck_assert_int_eq(fread(expected, 1, sizeof expected, in), 10240);
+    fclose(in);
+
+    // A whole data object followed by a range extending beyond its end
+    char *content = NULL;
+    size_t size   = 0;
+    FILE *out = open_memstream(&content, &size);
+
+    baton_error_t frame_error;
+    get_data_obj_framed_stream(conn, &rods_obj_path, out, 0, SIZE_MAX, 1000,
+                               &frame_error);
+    ck_assert_int_eq(frame_error.code, 0);
+    get_data_obj_framed_stream(conn, &rods_obj_path, out, 10200, 1000, 1000,
+                               &frame_error);
+    ck_assert_int_eq(frame_error.code, 0);
+    fclose(out);
+
+    size_t expected_offsets[2] = { 0, 10200 };
+    size_t expected_lengths[2] = { 10240, 40 };
+
+    char *frame = content;
+    for (int i = 0; i < 2; i++) {
+        char *eol = memchr(frame, '\n', size - (frame - content));
+        ck_assert_ptr_ne(eol, NULL);
+
+        json_error_t load_error;
+        json_t *header = json_loadb(frame, eol - frame, 0, &load_error);
+        ck_assert_ptr_ne(header, NULL);
+
+        json_t *info = json_object_get(header, JSON_FRAME_KEY);
+        ck_assert_str_eq(json_string_value(json_object_get(info,
+                                                           JSON_PATH_KEY)),
+                         obj_path);
+        ck_assert_int_eq(json_integer_value(json_object_get(info,
+                                                            JSON_OFFSET_KEY)),
+                         expected_offsets[i]);
+        ck_assert_int_eq(json_integer_value(json_object_get(info,
+                                                            JSON_LENGTH_KEY)),
+                         expected_lengths[i]);
+        // Only the whole data object has a checksum
+        ck_assert_int_eq(json_object_get(info, JSON_CHECKSUM_KEY) != NULL,
+                         i == 0);
+        json_decref(header);
+
+        frame = eol + 1;
+        ck_assert(memcmp(frame, expected + expected_offsets[i],
+                         expected_lengths[i]) == 0);
+        frame += expected_lengths[i];
+    }
+    ck_assert_int_eq(frame - content, size);
+    free(content);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we export a collection as a tar archive?
+START_TEST(test_export_collection) {
+    option_flags flags = RECURSIVE;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char file_path[MAX_PATH_LEN];
+    snprintf(file_path, MAX_PATH_LEN, "%s/%s/lorem_10k.txt",
+             TEST_ROOT, TEST_DATA_PATH);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, rods_root,
+                                       flags, &resolve_error), EXIST_ST);
+
+    char expected[10240];
+    FILE *in = fopen(file_path, "r");
+    ck_assert_int_eq(fread(expected, 1, sizeof expected, in), 10240);
+    fclose(in);
+
+    char *archive = NULL;
+    size_t size   = 0;
+    FILE *out = open_memstream(&archive, &size);
+
+    baton_error_t export_error;
+    json_t *summary = export_collection(conn, &rods_path, out, flags, 1000,
+                                        1, &export_error);
+    ck_assert_int_eq(export_error.code, 0);
+    fclose(out);
+
+    // Reading ahead on several connections gives the same archive
+    char *ahead_archive = NULL;
+    size_t ahead_size   = 0;
+    FILE *ahead_out = open_memstream(&ahead_archive, &ahead_size);
+
+    baton_error_t ahead_error;
+    json_t *ahead_summary = export_collection(conn, &rods_path, ahead_out,
+                                              flags, 1000, 3, &ahead_error);
+    ck_assert_int_eq(ahead_error.code, 0);
+    fclose(ahead_out);
+
+    ck_assert_int_eq(ahead_size, size);
+    ck_assert(memcmp(ahead_archive, archive, size) == 0);
+    ck_assert(json_equal(ahead_summary, summary));
+
+    json_decref(ahead_summary);
+    free(ahead_archive);
+
+    ck_assert_int_eq(size % TAR_BLOCK_SIZE, 0);
+    size_t count = json_integer_value(json_object_get(summary,
+                                                      JSON_COUNT_KEY));
+    ck_assert_int_gt(count, 1);
+
+    // Walk the members, which are named relative to the parent of the
+    // collection
+    const char *coll_name = strrchr(rods_root, '/') + 1;
+    char member_name[MAX_PATH_LEN];
+    snprintf(member_name, MAX_PATH_LEN, "%s/lorem_10k.txt", coll_name);
+
+    size_t num_members = 0;
+    int found = 0;
+    size_t pos = 0;
+    while (pos + TAR_BLOCK_SIZE <= size && archive[pos] != '\0') {
+        char *header = archive + pos;
+        size_t member_size = strtoul(header + 124, NULL, 8);
+        pos += TAR_BLOCK_SIZE;
+
+        if (header[156] == '0') {
+            num_members++;
+            if (strcmp(header, member_name) == 0) {
+                ck_assert_int_eq(member_size, 10240);
+                ck_assert(memcmp(archive + pos, expected, 10240) == 0);
+                found = 1;
+            }
+        }
+
+        pos += (member_size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE *
+            TAR_BLOCK_SIZE;
+    }
+
+    ck_assert(found);
+    ck_assert_int_eq(num_members, count);
+
+    // The end-of-archive marker
+    ck_assert_int_eq(size - pos, 2 * TAR_BLOCK_SIZE);
+
+    json_decref(summary);
+    free(archive);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+START_TEST(test_bulk_put_files) {
+    option_flags flags = RECURSIVE | CALCULATE_CHECKSUM;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+    char *md5 = "4efe0c1befd6f6ac4621cbdb13241246";
+
+    char file_path[MAX_PATH_LEN];
+    snprintf(file_path, MAX_PATH_LEN, "%s/%s/lorem_10k.txt",
+             TEST_ROOT, TEST_DATA_PATH);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char coll_path[MAX_PATH_LEN];
+    snprintf(coll_path, MAX_PATH_LEN, "%s/test_bulk_put_files", rods_root);
+
+    char content[10240];
+    FILE *in = fopen(file_path, "r");
+    ck_assert_int_eq(fread(content, 1, sizeof content, in), 10240);
+    fclose(in);
+
+    // A local directory with a sub-directory
+    char dir_template[] = "baton_test_bulk_put_files.XXXXXX";
+    char *dir = mkdtemp(dir_template);
+    ck_assert_ptr_ne(dir, NULL);
+
+    char sub_path[MAX_PATH_LEN];
+    snprintf(sub_path, MAX_PATH_LEN, "%s/sub", dir);
+    ck_assert_int_eq(mkdir(sub_path, 0700), 0);
+
+    const char *names[3] = { "a.txt", "sub/b.txt", "sub/c.txt" };
+    size_t sizes[3]      = { 10240, 10240, 0 };
+    for (int i = 0; i < 3; i++) {
+        char local_path[MAX_PATH_LEN];
+        snprintf(local_path, MAX_PATH_LEN, "%s/%s", dir, names[i]);
+        FILE *f = fopen(local_path, "w");
+        ck_assert_int_eq(fwrite(content, 1, sizes[i], f), sizes[i]);
+        fclose(f);
+    }
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    resolve_rods_path(conn, &env, &rods_path, coll_path, flags,
+                      &resolve_error);
+    ck_assert_int_eq(resolve_error.code, 0);
+
+    char *output = NULL;
+    size_t size  = 0;
+    FILE *out = open_memstream(&output, &size);
+
+    baton_error_t put_error;
+    json_t *summary = bulk_put_files(conn, &rods_path, dir, NULL, out, flags,
+                                     &put_error);
+    ck_assert_int_eq(put_error.code, 0);
+    fclose(out);
+
+    ck_assert_int_eq(json_integer_value(json_object_get(summary,
+                                                        JSON_COUNT_KEY)), 3);
+    ck_assert_int_eq(json_integer_value(json_object_get(summary,
+                                                        JSON_SIZE_KEY)), 20480);
+
+    // One line for each file, without errors
+    size_t num_lines = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (output[i] == '\n') num_lines++;
+    }
+    ck_assert_int_eq(num_lines, 3);
+    ck_assert_ptr_eq(strstr(output, JSON_ERROR_KEY), NULL);
+
+    for (int i = 0; i < 3; i++) {
+        char obj_path[MAX_PATH_LEN];
+        snprintf(obj_path, MAX_PATH_LEN, "%s/%s", coll_path, names[i]);
+
+        rodsPath_t obj_rods_path;
+        baton_error_t obj_error;
+        resolve_rods_path(conn, &env, &obj_rods_path, obj_path, flags,
+                          &obj_error);
+        ck_assert_int_eq(obj_error.code, 0);
+        ck_assert_int_eq(obj_rods_path.objState, EXIST_ST);
+        ck_assert_int_eq(obj_rods_path.rodsObjStat->objSize, sizes[i]);
+
+        if (sizes[i] > 0) {
+            baton_error_t list_error;
+            json_t *obj = list_path(conn, &obj_rods_path, PRINT_CHECKSUM,
+                                    &list_error);
+            ck_assert_int_eq(list_error.code, 0);
+            ck_assert_str_eq(json_string_value(json_object_get
+                                               (obj, JSON_CHECKSUM_KEY)),
+                             md5);
+            json_decref(obj);
+        }
+
+        char local_path[MAX_PATH_LEN];
+        snprintf(local_path, MAX_PATH_LEN, "%s/%s", dir, names[i]);
+        unlink(local_path);
+        if (obj_rods_path.rodsObjStat) free(obj_rods_path.rodsObjStat);
+    }
+
+    rmdir(sub_path);
+    rmdir(dir);
+
+    json_decref(summary);
+    free(output);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+START_TEST(test_sync_directory) {
+    option_flags flags = RECURSIVE | CALCULATE_CHECKSUM;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char coll_path[MAX_PATH_LEN];
+    snprintf(coll_path, MAX_PATH_LEN, "%s/test_sync_directory", rods_root);
+
+    // A local directory with a sub-directory
+    char dir_template[] = "baton_test_sync_directory.XXXXXX";
+    char *dir = mkdtemp(dir_template);
+    ck_assert_ptr_ne(dir, NULL);
+
+    char sub_path[MAX_PATH_LEN];
+    snprintf(sub_path, MAX_PATH_LEN, "%s/sub", dir);
+    ck_assert_int_eq(mkdir(sub_path, 0700), 0);
+
+    const char *names[2] = { "a.txt", "sub/b.txt" };
+    for (int i = 0; i < 2; i++) {
+        char local_path[MAX_PATH_LEN];
+        snprintf(local_path, MAX_PATH_LEN, "%s/%s", dir, names[i]);
+        FILE *f = fopen(local_path, "w");
+        fprintf(f, "%s\n", names[i]);
+        fclose(f);
+    }
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    resolve_rods_path(conn, &env, &rods_path, coll_path, flags,
+                      &resolve_error);
+    ck_assert_int_eq(resolve_error.code, 0);
+
+    // Everything is put the first time, using two workers
+    baton_error_t sync_error1;
+    json_t *summary1 = sync_directory(conn, &rods_path, dir, stderr, flags,
+                                      2, 1024, &sync_error1);
+    ck_assert_int_eq(sync_error1.code, 0);
+    ck_assert_int_eq(json_integer_value(json_object_get(summary1,
+                                                        JSON_SYNC_PUT)), 2);
+    ck_assert_int_eq(json_integer_value(json_object_get(summary1,
+                                                        JSON_SYNC_SKIP)), 0);
+
+    // And skipped the second time
+    baton_error_t sync_error2;
+    json_t *summary2 = sync_directory(conn, &rods_path, dir, stderr, flags,
+                                      2, 1024, &sync_error2);
+    ck_assert_int_eq(sync_error2.code, 0);
+    ck_assert_int_eq(json_integer_value(json_object_get(summary2,
+                                                        JSON_SYNC_PUT)), 0);
+    ck_assert_int_eq(json_integer_value(json_object_get(summary2,
+                                                        JSON_SYNC_SKIP)), 2);
+
+    // A changed file is put and a data object without a local file is
+    // removed
+    char a_path[MAX_PATH_LEN];
+    snprintf(a_path, MAX_PATH_LEN, "%s/%s", dir, names[0]);
+    FILE *f = fopen(a_path, "a");
+    fprintf(f, "changed\n");
+    fclose(f);
+
+    char b_path[MAX_PATH_LEN];
+    snprintf(b_path, MAX_PATH_LEN, "%s/%s", dir, names[1]);
+    unlink(b_path);
+
+    char *output = NULL;
+    size_t size  = 0;
+    FILE *out = open_memstream(&output, &size);
+
+    baton_error_t sync_error3;
+    json_t *summary3 = sync_directory(conn, &rods_path, dir, out,
+                                      flags | SYNC_DELETE, 2, 1024,
+                                      &sync_error3);
+    ck_assert_int_eq(sync_error3.code, 0);
+    fclose(out);
+
+    ck_assert_int_eq(json_integer_value(json_object_get(summary3,
+                                                        JSON_SYNC_PUT)), 1);
+    ck_assert_int_eq(json_integer_value(json_object_get(summary3,
+                                                        JSON_SYNC_REMOVE)),
+                     1);
+
+    // One line for each action, without errors
+    size_t num_lines = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (output[i] == '\n') num_lines++;
+    }
+    ck_assert_int_eq(num_lines, 2);
+    ck_assert_ptr_eq(strstr(output, JSON_ERROR_KEY), NULL);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/%s", coll_path, names[1]);
+
+    rodsPath_t obj_rods_path;
+    baton_error_t obj_error;
+    resolve_rods_path(conn, &env, &obj_rods_path, obj_path, flags,
+                      &obj_error);
+    ck_assert_int_eq(obj_error.code, 0);
+    ck_assert_int_eq(obj_rods_path.objState, NOT_EXIST_ST);
+
+    unlink(a_path);
+    rmdir(sub_path);
+    rmdir(dir);
+
+    json_decref(summary1);
+    json_decref(summary2);
+    json_decref(summary3);
+    free(output);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+    if (obj_rods_path.rodsObjStat) free(obj_rods_path.rodsObjStat);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
 START_TEST(test_write_data_obj) {
     option_flags flags = 0;
     rodsEnv env;
@@ -2081,6 +3944,158 @@ START_TEST(test_write_data_obj) {
 }
 END_TEST
 
+// Is inline data put only when asked for?
+START_TEST(test_put_inline_data) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char data_dir[MAX_PATH_LEN];
+    snprintf(data_dir, MAX_PATH_LEN, "%s/%s", TEST_ROOT, TEST_DATA_PATH);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/test_put_inline.txt", rods_root);
+
+    const char *content = "inline contents";
+    json_t *envelope = json_pack("{s:s, s:{s:b}, s:{s:s, s:s, s:s}}",
+                                 JSON_OP_KEY,          JSON_PUT_OP,
+                                 JSON_OP_ARGS_KEY,
+                                 JSON_OP_INLINE,       1,
+                                 JSON_TARGET_KEY,
+                                 JSON_COLLECTION_KEY,  rods_root,
+                                 JSON_DATA_OBJECT_KEY, "test_put_inline.txt",
+                                 JSON_DATA_KEY,        content);
+
+    operation_args_t args = { .flags = flags, .buffer_size = 1024 };
+
+    baton_error_t error;
+    json_t *result = baton_json_dispatch_op(&env, conn, envelope, &args,
+                                            &error);
+    ck_assert_int_eq(error.code, 0);
+    ck_assert_ptr_eq(json_object_get(result, JSON_DATA_KEY), NULL);
+    json_decref(result);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    baton_error_t ingest_error;
+    json_t *obj = ingest_data_obj(conn, &rods_path, flags, 1024,
+                                  &ingest_error);
+    ck_assert_int_eq(ingest_error.code, 0);
+    ck_assert_str_eq(json_string_value(json_object_get(obj, JSON_DATA_KEY)),
+                     content);
+    json_decref(obj);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    // Inline data may not be given with a local file
+    json_t *target = json_object_get(envelope, JSON_TARGET_KEY);
+    json_object_set_new(target, JSON_DIRECTORY_KEY, json_string(data_dir));
+    json_object_set_new(target, JSON_FILE_KEY, json_string("lorem_10k.txt"));
+
+    baton_error_t both_error;
+    result = baton_json_dispatch_op(&env, conn, envelope, &args, &both_error);
+    ck_assert_int_eq(both_error.code, CAT_INVALID_ARGUMENT);
+    ck_assert_ptr_eq(result, NULL);
+
+    // Without being asked for, the data of a get result is ignored and
+    // its local file is put
+    json_object_del(json_object_get(envelope, JSON_OP_ARGS_KEY),
+                    JSON_OP_INLINE);
+
+    baton_error_t file_error;
+    result = baton_json_dispatch_op(&env, conn, envelope, &args, &file_error);
+    ck_assert_int_eq(file_error.code, 0);
+    json_decref(result);
+
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    baton_error_t list_error;
+    json_t *listed = list_path(conn, &rods_path, PRINT_SIZE, &list_error);
+    ck_assert_int_eq(list_error.code, 0);
+    ck_assert_int_eq(json_integer_value(json_object_get(listed,
+                                                        JSON_SIZE_KEY)),
+                     10240);
+
+    json_decref(listed);
+    json_decref(envelope);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Write data objects using several streams
+START_TEST(test_write_data_obj_parallel) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+    size_t buffer_size = 1024 * 1024;
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/test_write_data_obj_parallel.bin",
+             rods_root);
+
+    // Large enough for two streams, with a remainder for the last
+    size_t size = 2 * PARALLEL_WRITE_MIN_RANGE + 12345;
+    char template[] = "baton_test_write_data_obj_parallel.XXXXXX";
+    int fd = mkstemp(template);
+    FILE *src = fdopen(fd, "w");
+    for (size_t i = 0; i < size; i++) {
+        fputc((i * 31 + i / 4096) & 0xff, src);
+    }
+    fclose(src);
+
+    char md5[NAME_LEN];
+    baton_error_t md5_error;
+    checksum_local_file(template, CHECKSUM_ALGORITHM_MD5, md5, &md5_error);
+    ck_assert_int_eq(md5_error.code, 0);
+
+    // More streams than the size allows
+    size_t num_streams[2] = { 4, 1 };
+
+    for (int i = 0; i < 2; i++) {
+        rodsPath_t rods_obj_path;
+        baton_error_t resolve_error;
+        resolve_rods_path(conn, &env, &rods_obj_path, obj_path,
+                          flags, &resolve_error);
+        ck_assert_int_eq(resolve_error.code, 0);
+
+        baton_error_t write_error;
+        size_t num_written = write_data_obj_parallel(conn, template,
+                                                     &rods_obj_path,
+                                                     buffer_size,
+                                                     num_streams[i], flags,
+                                                     &write_error);
+        ck_assert_int_eq(write_error.code, 0);
+        ck_assert_int_eq(num_written, size);
+
+        rodsPath_t result_obj_path;
+        baton_error_t result_error;
+        resolve_rods_path(conn, &env, &result_obj_path, obj_path,
+                          flags, &result_error);
+        ck_assert_int_eq(result_error.code, 0);
+        ck_assert_int_eq(result_obj_path.rodsObjStat->objSize, size);
+
+        baton_error_t verify_error;
+        verify_data_obj_checksum(conn, obj_path, template, md5, 1,
+                                 &verify_error);
+        ck_assert_int_eq(verify_error.code, 0);
+    }
+
+    unlink(template);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
 START_TEST(test_put_data_obj) {
     option_flags flags = 0;
     rodsEnv env;
@@ -2170,6 +4185,180 @@ START_TEST(test_put_data_obj) {
 }
 END_TEST
 
+// Can we tell whether a local file is in sync with a data object?
+START_TEST(test_local_file_in_sync) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char file_path[MAX_PATH_LEN];
+    snprintf(file_path, MAX_PATH_LEN, "%s/%s/lorem_10k.txt",
+             TEST_ROOT, TEST_DATA_PATH);
+
+    char other_file_path[MAX_PATH_LEN];
+    snprintf(other_file_path, MAX_PATH_LEN, "%s/%s/f1.txt",
+             TEST_ROOT, TEST_DATA_PATH);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/test_local_file_in_sync.txt",
+             rods_root);
+
+    rodsPath_t rods_obj_path;
+    baton_error_t resolve_error;
+    resolve_rods_path(conn, &env, &rods_obj_path, obj_path,
+                      flags, &resolve_error);
+    ck_assert_int_eq(resolve_error.code, 0);
+
+    // Absent data object
+    baton_error_t absent_error;
+    ck_assert(!local_file_in_sync(conn, &rods_obj_path, file_path,
+                                  &absent_error));
+    ck_assert_int_eq(absent_error.code, 0);
+
+    baton_error_t put_error;
+    put_data_obj(conn, file_path, &rods_obj_path, TEST_RESOURCE, NULL,
+                 flags | CALCULATE_CHECKSUM, &put_error);
+    ck_assert_int_eq(put_error.code, 0);
+
+    rodsPath_t result_obj_path;
+    baton_error_t result_error;
+    resolve_rods_path(conn, &env, &result_obj_path, obj_path,
+                      flags, &result_error);
+    ck_assert_int_eq(result_error.code, 0);
+
+    baton_error_t sync_error;
+    ck_assert(local_file_in_sync(conn, &result_obj_path, file_path,
+                                 &sync_error));
+    ck_assert_int_eq(sync_error.code, 0);
+
+    baton_error_t other_error;
+    ck_assert(!local_file_in_sync(conn, &result_obj_path, other_file_path,
+                                  &other_error));
+    ck_assert_int_eq(other_error.code, 0);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we resume interrupted transfers?
+START_TEST(test_resumable_transfer) {
+    option_flags flags = 0;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+    char *md5 = "4efe0c1befd6f6ac4621cbdb13241246";
+    size_t buffer_size = 1024;
+
+    char file_path[MAX_PATH_LEN];
+    snprintf(file_path, MAX_PATH_LEN, "%s/%s/lorem_10k.txt",
+             TEST_ROOT, TEST_DATA_PATH);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/test_resumable_transfer.txt",
+             rods_root);
+
+    // The journal of a put is named by the inode of the local file, so
+    // use a copy
+    char journal_template[] = "baton_test_resumable_journal.XXXXXX";
+    char *journal_dir = mkdtemp(journal_template);
+    ck_assert_ptr_ne(journal_dir, NULL);
+    ck_assert_ptr_ne(set_journal_dir(journal_dir), NULL);
+
+    char src_template[] = "baton_test_resumable_transfer.XXXXXX";
+    int src_fd = mkstemp(src_template);
+    FILE *src = fdopen(src_fd, "w");
+    FILE *in = fopen(file_path, "r");
+    char content[10240];
+    ck_assert_int_eq(fread(content, 1, sizeof content, in), 10240);
+    ck_assert_int_eq(fwrite(content, 1, sizeof content, src), 10240);
+    fclose(in);
+    fclose(src);
+
+    rodsPath_t rods_obj_path;
+    baton_error_t resolve_error;
+    resolve_rods_path(conn, &env, &rods_obj_path, obj_path,
+                      flags, &resolve_error);
+    ck_assert_int_eq(resolve_error.code, 0);
+
+    baton_error_t write_error;
+    size_t num_written = write_data_obj_resumable(conn, src_template,
+                                                  &rods_obj_path,
+                                                  buffer_size, flags,
+                                                  &write_error);
+    ck_assert_int_eq(write_error.code, 0);
+    ck_assert_int_eq(num_written, 10240);
+
+    // The journal of the put was kept in the journal directory, not
+    // beside the local file, and removed once complete
+    struct stat src_st;
+    ck_assert_int_eq(stat(src_template, &src_st), 0);
+
+    char journal_path[MAX_PATH_LEN];
+    snprintf(journal_path, MAX_PATH_LEN, "%s/%llx-%llx%s", journal_dir,
+             (unsigned long long) src_st.st_dev,
+             (unsigned long long) src_st.st_ino, JOURNAL_SUFFIX);
+    ck_assert_int_ne(access(journal_path, F_OK), 0);
+    ck_assert_int_eq(rmdir(journal_dir), 0);
+    set_journal_dir(NULL);
+
+    snprintf(journal_path, MAX_PATH_LEN, "%s%s", src_template,
+             JOURNAL_SUFFIX);
+    ck_assert_int_ne(access(journal_path, F_OK), 0);
+
+    rodsPath_t result_obj_path;
+    baton_error_t result_error;
+    resolve_rods_path(conn, &env, &result_obj_path, obj_path,
+                      flags, &result_error);
+    ck_assert_int_eq(result_error.code, 0);
+
+    // Simulate an interrupted get, having the first chunk and some
+    // trailing bytes not recorded in the journal
+    char dst_template[] = "baton_test_resumable_transfer.XXXXXX";
+    int dst_fd = mkstemp(dst_template);
+    FILE *dst = fdopen(dst_fd, "w");
+    ck_assert_int_eq(fwrite(content, 1, 1024, dst), 1024);
+    ck_assert_int_eq(fwrite("garbage", 1, 7, dst), 7);
+    fclose(dst);
+
+    char identity[MAX_PATH_LEN];
+    snprintf(identity, MAX_PATH_LEN, "get %lld %s %s",
+             (long long) result_obj_path.rodsObjStat->objSize,
+             result_obj_path.rodsObjStat->modifyTime,
+             result_obj_path.outPath);
+
+    baton_error_t journal_error;
+    transfer_journal_t *journal =
+        open_transfer_journal(dst_template, identity, &journal_error);
+    ck_assert_int_eq(journal_error.code, 0);
+    journal_chunk(journal, 0, content, 1024, &journal_error);
+    ck_assert_int_eq(journal_error.code, 0);
+    close_transfer_journal(journal, 0);
+
+    baton_error_t get_error;
+    get_data_obj_file_resumable(conn, &result_obj_path, dst_template,
+                                buffer_size, &get_error);
+    ck_assert_int_eq(get_error.code, 0);
+
+    snprintf(journal_path, MAX_PATH_LEN, "%s%s", dst_template,
+             JOURNAL_SUFFIX);
+    ck_assert_int_ne(access(journal_path, F_OK), 0);
+
+    FILE *tmp = fopen(dst_template, "r");
+    confirm_checksum(tmp, md5);
+    fclose(tmp);
+
+    unlink(src_template);
+    unlink(dst_template);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
 // Can we checksum a data object?
 START_TEST(test_checksum_data_obj) {
     option_flags flags = 0;
@@ -2318,6 +4507,192 @@ START_TEST(test_remove_data_obj) {
 }
 END_TEST
 
+// Do we refuse to register physical paths which cannot be registered?
+START_TEST(test_register_data_obj) {
+    option_flags flags = CALCULATE_CHECKSUM;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/registered.txt", rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), NOT_EXIST_ST);
+
+    baton_error_t relative_error;
+    register_data_obj(conn, "relative/path.txt", &rods_path, NULL, flags,
+                      &relative_error);
+    ck_assert_int_eq(relative_error.code, USER_INPUT_PATH_ERR);
+
+    baton_error_t option_error;
+    register_data_obj(conn, "/no/such/path.txt", &rods_path, NULL,
+                      flags | VERIFY_CHECKSUM, &option_error);
+    ck_assert_int_eq(option_error.code, USER_INPUT_OPTION_ERR);
+
+    baton_error_t missing_error;
+    register_data_obj(conn, "/no/such/path.txt", &rods_path, NULL, flags,
+                      &missing_error);
+    ck_assert_int_ne(missing_error.code, 0);
+
+    rodsPath_t reg_path;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &reg_path, obj_path,
+                                       flags, &resolve_error), NOT_EXIST_ST);
+
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+    if (reg_path.rodsObjStat) free(reg_path.rodsObjStat);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we replicate a data object and a collection?
+START_TEST(test_replicate_collection) {
+    if (!TEST_RESOURCE) {
+        logmsg(WARN, "!!! Skipping test_replicate_collection because "
+               "no test resource is defined; TEST_RESOURCE=%s !!!",
+               TEST_RESOURCE);
+        return;
+    }
+
+    option_flags flags = RECURSIVE | VERIFY_CHECKSUM;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/f1.txt", rods_root);
+
+    baton_error_t obj_error;
+    ck_assert_int_eq(replicate_data_obj(conn, obj_path, TEST_RESOURCE,
+                                        flags, &obj_error), 0);
+    ck_assert_int_eq(obj_error.code, 0);
+
+    char coll_path[MAX_PATH_LEN];
+    snprintf(coll_path, MAX_PATH_LEN, "%s/a", rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, coll_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    char *output = NULL;
+    size_t size  = 0;
+    FILE *out = open_memstream(&output, &size);
+
+    baton_error_t coll_error;
+    json_t *summary = replicate_collection(conn, &rods_path, TEST_RESOURCE,
+                                           out, flags, 2, &coll_error);
+    ck_assert_int_eq(coll_error.code, 0);
+    fclose(out);
+
+    size_t count = json_integer_value(json_object_get(summary,
+                                                      JSON_COUNT_KEY));
+    ck_assert_int_gt(count, 1);
+
+    // One line for each data object, without errors
+    size_t num_lines = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (output[i] == '\n') num_lines++;
+    }
+    ck_assert_int_eq(num_lines, count);
+    ck_assert_ptr_eq(strstr(output, JSON_ERROR_KEY), NULL);
+
+    json_decref(summary);
+    free(output);
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
+// Can we copy a data object and a collection?
+START_TEST(test_copy_rods_path) {
+    option_flags flags = VERIFY_CHECKSUM;
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    char obj_path[MAX_PATH_LEN];
+    snprintf(obj_path, MAX_PATH_LEN, "%s/f1.txt", rods_root);
+    char obj_copy_path[MAX_PATH_LEN];
+    snprintf(obj_copy_path, MAX_PATH_LEN, "%s/f1_copy.txt", rods_root);
+
+    rodsPath_t rods_path;
+    baton_error_t resolve_error;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_path, obj_path,
+                                       flags, &resolve_error), EXIST_ST);
+
+    baton_error_t copy_error;
+    ck_assert_int_eq(copy_rods_path(conn, &rods_path, obj_copy_path, NULL,
+                                    flags, &copy_error), 0);
+    ck_assert_int_eq(copy_error.code, 0);
+
+    rodsPath_t copy_path;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &copy_path, obj_copy_path,
+                                       flags, &resolve_error), EXIST_ST);
+    ck_assert_int_eq(copy_path.objType, DATA_OBJ_T);
+
+    // A collection is only copied recursively
+    char coll_path[MAX_PATH_LEN];
+    snprintf(coll_path, MAX_PATH_LEN, "%s/a", rods_root);
+    char coll_copy_path[MAX_PATH_LEN];
+    snprintf(coll_copy_path, MAX_PATH_LEN, "%s/a_copy", rods_root);
+
+    rodsPath_t rods_coll_path;
+    ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_coll_path,
+                                       coll_path, flags, &resolve_error),
+                     EXIST_ST);
+
+    baton_error_t no_recurse_error;
+    copy_rods_path(conn, &rods_coll_path, coll_copy_path, NULL, flags,
+                   &no_recurse_error);
+    ck_assert_int_eq(no_recurse_error.code, USER_INPUT_OPTION_ERR);
+
+    // Not into itself
+    char inner_path[MAX_PATH_LEN];
+    snprintf(inner_path, MAX_PATH_LEN, "%s/x/copy", coll_path);
+    baton_error_t inner_error;
+    copy_rods_path(conn, &rods_coll_path, inner_path, NULL,
+                   flags | RECURSIVE, &inner_error);
+    ck_assert_int_ne(inner_error.code, 0);
+
+    baton_error_t coll_error;
+    copy_rods_path(conn, &rods_coll_path, coll_copy_path, NULL,
+                   flags | RECURSIVE, &coll_error);
+    ck_assert_int_eq(coll_error.code, 0);
+
+    // Nested data objects and sub-collections are copied
+    const char *copies[3] = { "x/m/f12.txt", "z", "f4.txt" };
+    int types[3]          = { DATA_OBJ_T, COLL_OBJ_T, DATA_OBJ_T };
+    for (int i = 0; i < 3; i++) {
+        char path[MAX_PATH_LEN];
+        snprintf(path, MAX_PATH_LEN, "%s/%s", coll_copy_path, copies[i]);
+
+        rodsPath_t rods_copy_path;
+        ck_assert_int_eq(resolve_rods_path(conn, &env, &rods_copy_path,
+                                           path, flags, &resolve_error),
+                         EXIST_ST);
+        ck_assert_int_eq(rods_copy_path.objType, types[i]);
+        if (rods_copy_path.rodsObjStat) free(rods_copy_path.rodsObjStat);
+    }
+
+    if (rods_path.rodsObjStat) free(rods_path.rodsObjStat);
+    if (copy_path.rodsObjStat) free(copy_path.rodsObjStat);
+    if (rods_coll_path.rodsObjStat) free(rods_coll_path.rodsObjStat);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
 // Can we create a collection?
 START_TEST(test_create_coll) {
     option_flags flags = RECURSIVE;
@@ -2393,6 +4768,70 @@ START_TEST(test_remove_coll) {
 }
 END_TEST
 
+// Are consecutive data object listings answered together in the
+// same way as when they are run individually?
+START_TEST(test_do_operation_lookahead) {
+    rodsEnv env;
+    rcComm_t *conn = rods_login(&env);
+
+    char rods_root[MAX_PATH_LEN];
+    set_current_rods_root(TEST_COLL, rods_root);
+
+    FILE *json_tmp = tmpfile();
+    const char *names[] = { "f1.txt", "f2.txt", "f3.txt" };
+    for (size_t i = 0; i < 3; i++) {
+        json_t *envelope = json_pack("{s:s, s:{s:b, s:b}, s:{s:s, s:s}}",
+                                     JSON_OP_KEY,            JSON_LIST_OP,
+                                     JSON_OP_ARGS_KEY,
+                                     JSON_OP_SIZE,           1,
+                                     JSON_OP_PRINT_CHECKSUM, 1,
+                                     JSON_TARGET_KEY,
+                                     JSON_COLLECTION_KEY,    rods_root,
+                                     JSON_DATA_OBJECT_KEY,   names[i]);
+        json_dumpf(envelope, json_tmp, 0);
+        json_decref(envelope);
+    }
+
+    operation_args_t args = { .flags            = 0,
+                              .buffer_size      = 1024,
+                              .max_connect_time = 10,
+                              .lookahead        = 0 };
+    operation_args_t ahead_args = args;
+    ahead_args.lookahead = 2;
+
+    int status, ahead_status;
+    char *expected = capture_operation(json_tmp, &args, &status);
+    char *output   = capture_operation(json_tmp, &ahead_args, &ahead_status);
+    ck_assert_int_eq(status, 0);
+    ck_assert_int_eq(ahead_status, 0);
+    ck_assert_int_gt(strlen(expected), 0);
+    ck_assert_str_eq(output, expected);
+    free(expected);
+    free(output);
+
+    // A missing data object is run individually and reported as before
+    json_t *missing = json_pack("{s:s, s:{s:s, s:s}}",
+                                JSON_OP_KEY,          JSON_LIST_OP,
+                                JSON_TARGET_KEY,
+                                JSON_COLLECTION_KEY,  rods_root,
+                                JSON_DATA_OBJECT_KEY, "INVALID");
+    json_dumpf(missing, json_tmp, 0);
+
+    expected = capture_operation(json_tmp, &args, &status);
+    output   = capture_operation(json_tmp, &ahead_args, &ahead_status);
+    ck_assert_int_ne(status, 0);
+    ck_assert_int_ne(ahead_status, 0);
+    ck_assert_str_eq(output, expected);
+    free(expected);
+    free(output);
+
+    fclose(json_tmp);
+    json_decref(missing);
+
+    if (conn) rcDisconnect(conn);
+}
+END_TEST
+
 // Can we do a sequence of baton operations described by a JSON
 // stream?
 START_TEST(test_do_operation) {
@@ -2913,6 +5352,14 @@ Suite *baton_suite(void) {
     tcase_add_test(utilities, test_parse_timestamp);
     tcase_add_test(utilities, test_parse_size);
     tcase_add_test(utilities, test_to_utf8);
+    tcase_add_test(utilities, test_utf8_chunk_valid);
+    tcase_add_test(utilities, test_text_kernels);
+    tcase_add_test(utilities, test_utf8_valid);
+    tcase_add_test(utilities, test_print_json_escaped);
+    tcase_add_test(utilities, test_base64);
+    tcase_add_test(utilities, test_write_tar_header);
+    tcase_add_test(utilities, test_checksum_cache);
+    tcase_add_test(utilities, test_put_journal_dir);
 
     TCase *basic = tcase_create("basic");
     tcase_add_unchecked_fixture(basic, setup, teardown);
@@ -2931,6 +5378,7 @@ Suite *baton_suite(void) {
 
     tcase_add_test(path, test_list_missing_path);
     tcase_add_test(path, test_list_obj);
+    tcase_add_test(path, test_list_data_objs_by_name);
     tcase_add_test(path, test_list_coll);
     tcase_add_test(path, test_list_coll_contents);
     tcase_add_test(path, test_list_permissions_missing_path);
@@ -2938,6 +5386,9 @@ Suite *baton_suite(void) {
     tcase_add_test(path, test_list_permissions_coll);
     tcase_add_test(path, test_modify_permissions_obj);
     tcase_add_test(path, test_modify_json_permissions_obj);
+    tcase_add_test(path, test_apply_json_permissions_obj);
+    tcase_add_test(path, test_bulk_modify_permissions);
+    tcase_add_test(path, test_chmod_collection);
     tcase_add_test(path, test_list_replicates_obj);
     tcase_add_test(path, test_list_timestamps_obj);
     tcase_add_test(path, test_list_timestamps_coll);
@@ -2949,11 +5400,19 @@ Suite *baton_suite(void) {
     tcase_add_test(metadata, test_list_metadata_obj);
     tcase_add_test(metadata, test_list_metadata_coll);
     tcase_add_test(metadata, test_contains_avu);
+    tcase_add_test(metadata, test_avu_set_difference);
     tcase_add_test(metadata, test_add_metadata_missing_path);
     tcase_add_test(metadata, test_add_metadata_obj);
     tcase_add_test(metadata, test_remove_metadata_obj);
     tcase_add_test(metadata, test_add_json_metadata_obj);
     tcase_add_test(metadata, test_remove_json_metadata_obj);
+    tcase_add_test(metadata, test_apply_json_metadata_obj);
+    tcase_add_test(metadata, test_metasuper_op);
+    tcase_add_test(metadata, test_sequence_op);
+    tcase_add_test(metadata, test_batch_envelope);
+    tcase_add_test(metadata, test_trust_input);
+    tcase_add_test(metadata, test_op_arg_scope);
+    tcase_add_test(metadata, test_bulk_modify_metadata);
     tcase_add_test(metadata, test_search_metadata_obj);
     tcase_add_test(metadata, test_search_metadata_coll);
     tcase_add_test(metadata, test_search_metadata_path_obj);
@@ -2966,13 +5425,26 @@ Suite *baton_suite(void) {
 
     tcase_add_test(read_write, test_get_data_obj_stream);
     tcase_add_test(read_write, test_get_data_obj_file);
+    tcase_add_test(read_write, test_get_data_obj_range);
     tcase_add_test(read_write, test_slurp_data_obj);
     tcase_add_test(read_write, test_ingest_data_obj);
+    tcase_add_test(read_write, test_get_data_obj_json_stream);
+    tcase_add_test(read_write, test_get_data_obj_framed_stream);
+    tcase_add_test(read_write, test_export_collection);
+    tcase_add_test(read_write, test_bulk_put_files);
+    tcase_add_test(read_write, test_sync_directory);
     tcase_add_test(read_write, test_write_data_obj);
+    tcase_add_test(read_write, test_write_data_obj_parallel);
     tcase_add_test(read_write, test_put_data_obj);
+    tcase_add_test(read_write, test_put_inline_data);
+    tcase_add_test(read_write, test_local_file_in_sync);
+    tcase_add_test(read_write, test_resumable_transfer);
     tcase_add_test(read_write, test_checksum_data_obj);
     tcase_add_test(read_write, test_checksum_ignore_stale);
     tcase_add_test(read_write, test_remove_data_obj);
+    tcase_add_test(read_write, test_copy_rods_path);
+    tcase_add_test(read_write, test_register_data_obj);
+    tcase_add_test(read_write, test_replicate_collection);
     tcase_add_test(read_write, test_create_coll);
     tcase_add_test(read_write, test_remove_coll);
 
@@ -2987,6 +5459,7 @@ Suite *baton_suite(void) {
     tcase_add_test(json, test_json_to_path);
     tcase_add_test(json, test_json_to_local_path);
     tcase_add_test(json, test_do_operation);
+    tcase_add_test(json, test_do_operation_lookahead);
 
     TCase *specific_query = tcase_create("specific_query");
     tcase_add_unchecked_fixture(specific_query, setup, teardown);